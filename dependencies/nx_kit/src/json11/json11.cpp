@@ -21,6 +21,7 @@
 
 #include "json11.hpp"
 #include <cassert>
+#include <cfloat>
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
@@ -172,7 +173,7 @@ protected:
         return m_value < static_cast<const Value<tag, T> *>(other)->m_value;
     }
 
-    const T m_value;
+    T m_value;
     void dump(string &out) const override { json11::dump(m_value, out); }
 };
 
@@ -209,6 +210,7 @@ public:
 
 class JsonArray final : public Value<Json::ARRAY, Json::array> {
     const Json::array &array_items() const override { return m_value; }
+    Json::array *mutable_array_items() override { return &m_value; }
     const Json & operator[](size_t i) const override;
 public:
     explicit JsonArray(const Json::array &value) : Value(value) {}
@@ -217,6 +219,7 @@ public:
 
 class JsonObject final : public Value<Json::OBJECT, Json::object> {
     const Json::object &object_items() const override { return m_value; }
+    Json::object *mutable_object_items() override { return &m_value; }
     const Json & operator[](const string &key) const override;
 public:
     explicit JsonObject(const Json::object &value) : Value(value) {}
@@ -292,6 +295,20 @@ const map<string, Json> & JsonValue::object_items()              const { return
 const Json &              JsonValue::operator[] (size_t)         const { return static_null(); }
 const Json &              JsonValue::operator[] (const string &) const { return static_null(); }
 
+Json::array *             JsonValue::mutable_array_items()             { return nullptr; }
+Json::object *            JsonValue::mutable_object_items()            { return nullptr; }
+
+vector<Json> * Json::mutable_array_items() {
+    if (type() != ARRAY) return nullptr;
+    if (m_ptr.use_count() > 1) m_ptr = make_shared<JsonArray>(m_ptr->array_items());
+    return m_ptr->mutable_array_items();
+}
+map<string, Json> * Json::mutable_object_items() {
+    if (type() != OBJECT) return nullptr;
+    if (m_ptr.use_count() > 1) m_ptr = make_shared<JsonObject>(m_ptr->object_items());
+    return m_ptr->mutable_object_items();
+}
+
 const Json & JsonObject::operator[] (const string &key) const {
     auto iter = m_value.find(key);
     return (iter == m_value.end()) ? static_null() : iter->second;
@@ -362,6 +379,36 @@ static inline bool in_range(long x, long lower, long upper) {
     return (x >= lower && x <= upper);
 }
 
+/* find_string_special_char(str, i)
+ *
+ * Return the position of the first '"', '\\' or control character at or after i, or str.size()
+ * if there is none. Tests 8 characters at a time, so that runs of ordinary characters are
+ * skipped quickly and can be appended to the output at once.
+ */
+static inline size_t find_string_special_char(const string &str, size_t i) {
+    static const uint64_t ones = 0x0101010101010101ULL;
+    static const uint64_t high_bits = 0x8080808080808080ULL;
+    const char * const data = str.data();
+    const size_t size = str.size();
+    for (; i + 8 <= size; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, data + i, sizeof(chunk));
+        const uint64_t quotes = chunk ^ (ones * '"');
+        const uint64_t backslashes = chunk ^ (ones * '\\');
+        const uint64_t found = (((chunk - ones * 0x20) & ~chunk)
+            | ((quotes - ones) & ~quotes)
+            | ((backslashes - ones) & ~backslashes)) & high_bits;
+        if (found != 0)
+            break;
+    }
+    for (; i < size; i++) {
+        const char ch = data[i];
+        if (ch == '"' || ch == '\\' || in_range(ch, 0, 0x1f))
+            return i;
+    }
+    return size;
+}
+
 namespace {
 /* JsonParser
  *
@@ -504,6 +551,15 @@ struct JsonParser final {
         string out;
         long last_escaped_codepoint = -1;
         while (true) {
+            // The usual case: a run of non-escaped characters, appended at once.
+            const size_t run_end = find_string_special_char(str, i);
+            if (run_end != i) {
+                encode_utf8(last_escaped_codepoint, out);
+                last_escaped_codepoint = -1;
+                out.append(str, i, run_end - i);
+                i = run_end;
+            }
+
             if (i == str.size())
                 return fail("unexpected end of input in string", "");
 
@@ -517,14 +573,6 @@ struct JsonParser final {
             if (in_range(ch, 0, 0x1f))
                 return fail("unescaped " + esc(ch) + " in string", "");
 
-            // The usual case: non-escaped characters
-            if (ch != '\\') {
-                encode_utf8(last_escaped_codepoint, out);
-                last_escaped_codepoint = -1;
-                out += ch;
-                continue;
-            }
-
             // Handle escapes
             if (i == str.size())
                 return fail("unexpected end of input in string", "");
@@ -641,6 +689,72 @@ struct JsonParser final {
                 i++;
         }
 
+        return parse_double(start_pos);
+    }
+
+    /* parse_double(start_pos)
+     *
+     * Convert the number which was validated by parse_number(), from start_pos up to i. When the
+     * number has at most 15 significant digits and a decimal exponent within +-22, both the
+     * digits and the power of 10 are exact doubles, so a single multiplication or division gives
+     * the correctly rounded result, the same as strtod_dot(), without its stream and locale
+     * (Clinger's fast path). Other numbers are left to strtod_dot().
+     */
+    double parse_double(size_t start_pos) const {
+        #if FLT_EVAL_METHOD == 0 //< No excess precision that would round twice.
+            static const double powers_of_10[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            static const int max_digits = 15;
+            static const int max_exponent = 22;
+
+            const char *p = str.data() + start_pos;
+            const char * const end = str.data() + i;
+            const bool negative = (*p == '-');
+            if (negative)
+                p++;
+
+            uint64_t mantissa = 0;
+            int digit_count = 0; //< Not counting the leading zeros.
+            int exponent = 0;
+            bool is_fraction = false;
+            for (; p != end && (in_range(*p, '0', '9') || *p == '.'); p++) {
+                if (*p == '.') {
+                    is_fraction = true;
+                    continue;
+                }
+                if (mantissa != 0 || *p != '0')
+                    digit_count++;
+                if (digit_count > max_digits)
+                    return strtod_dot(str.c_str() + start_pos);
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                if (is_fraction)
+                    exponent--;
+            }
+
+            if (p != end) { //< Exponent part.
+                p++;
+                const bool negative_exponent = (*p == '-');
+                if (*p == '+' || *p == '-')
+                    p++;
+                int exponent_value = 0;
+                for (; p != end; p++) {
+                    if (exponent_value > 1000) //< Far out of the fast path; avoid overflow.
+                        return strtod_dot(str.c_str() + start_pos);
+                    exponent_value = exponent_value * 10 + (*p - '0');
+                }
+                exponent += negative_exponent ? -exponent_value : exponent_value;
+            }
+
+            if (exponent >= -max_exponent && exponent <= max_exponent) {
+                double value = static_cast<double>(mantissa);
+                if (exponent < 0)
+                    value /= powers_of_10[-exponent];
+                else
+                    value *= powers_of_10[exponent];
+                return negative ? -value : value;
+            }
+        #endif
         return strtod_dot(str.c_str() + start_pos);
     }
 
@@ -147,6 +147,14 @@ public:
     // Return the enclosed std::map if this is an object, or an empty map otherwise.
     const object &object_items() const;
 
+    // Return a pointer to the enclosed std::vector if this is an array, nullptr otherwise, for
+    // editing the array in place. Copy-on-write: if the array is shared with other Json values,
+    // this Json gets its own copy first (the items themselves stay shared), so the other values
+    // do not change. The pointer is valid until this Json is assigned or destroyed.
+    array *mutable_array_items();
+    // Same as mutable_array_items(), for the enclosed std::map if this is an object.
+    object *mutable_object_items();
+
     // Return a reference to arr[i] if this is an array, Json() otherwise.
     const Json & operator[](size_t i) const;
     // Return a reference to obj[key] if this is an object, Json() otherwise.
@@ -226,6 +234,8 @@ protected:
     virtual const Json &operator[](size_t i) const;
     virtual const Json::object &object_items() const;
     virtual const Json &operator[](const std::string &key) const;
+    virtual Json::array *mutable_array_items();
+    virtual Json::object *mutable_object_items();
     virtual ~JsonValue() {}
 };
 
@@ -0,0 +1,804 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "arena_json.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <vector>
+
+namespace nx {
+namespace kit {
+
+namespace detail {
+
+struct ArenaJsonNode
+{
+    Json::Type type;
+    uint32_t size; //< Length of a string, or the number of array items or object members.
+    union
+    {
+        double number;
+        bool boolean;
+        const char* chars;
+        const ArenaJsonNode* items;
+        const ArenaJsonMember* members;
+    };
+};
+
+struct ArenaJsonMember
+{
+    const char* key;
+    size_t keySize;
+    ArenaJsonNode value;
+};
+
+} // namespace detail
+
+using detail::ArenaJsonNode;
+using detail::ArenaJsonMember;
+
+namespace {
+
+static const ArenaJsonNode kNullNode = {Json::NUL, 0, {0}};
+
+static const int kMaxDepth = 200; //< The same as in Json::parse().
+
+//-------------------------------------------------------------------------------------------------
+// Arena.
+
+/** Bump-pointer allocator; the memory is freed all at once when the arena is destroyed. */
+class Arena
+{
+public:
+    explicit Arena(size_t firstBlockSize): m_nextBlockSize(firstBlockSize) {}
+
+    void* allocate(size_t size)
+    {
+        size = (size + kAlignment - 1) & ~(kAlignment - 1);
+        if (size > m_left)
+            addBlock(size);
+        char* const result = m_pos;
+        m_pos += size;
+        m_left -= size;
+        return result;
+    }
+
+    template<typename T>
+    T* allocateArray(size_t count)
+    {
+        static_assert(alignof(T) <= kAlignment, "Arena alignment is not enough for the type.");
+        return static_cast<T*>(allocate(count * sizeof(T)));
+    }
+
+    size_t allocatedBytes() const { return m_allocatedBytes; }
+
+private:
+    void addBlock(size_t minSize)
+    {
+        const size_t blockSize = std::max(m_nextBlockSize, minSize);
+        m_blocks.emplace_back(new char[blockSize]);
+        m_pos = m_blocks.back().get();
+        m_left = blockSize;
+        m_allocatedBytes += blockSize;
+        m_nextBlockSize = blockSize * 2;
+    }
+
+private:
+    static const size_t kAlignment = 8;
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char* m_pos = nullptr;
+    size_t m_left = 0;
+    size_t m_nextBlockSize;
+    size_t m_allocatedBytes = 0;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Parser.
+
+/** Format char c suitable for printing in an error message, the same way as Json::parse(). */
+static std::string esc(char c)
+{
+    char buf[12];
+    if (static_cast<uint8_t>(c) >= 0x20 && static_cast<uint8_t>(c) <= 0x7f)
+        snprintf(buf, sizeof buf, "'%c' (%d)", c, c);
+    else
+        snprintf(buf, sizeof buf, "(%d)", c);
+    return std::string(buf);
+}
+
+static bool inRange(long x, long lower, long upper)
+{
+    return x >= lower && x <= upper;
+}
+
+/** Locale-independent strtod() for a number already validated against the JSON grammar. */
+static double strtodDot(const char* str)
+{
+    const size_t length = strspn(str, "0123456789.eE+-");
+    std::istringstream stream(std::string(str, length));
+    stream.imbue(std::locale("C"));
+    double result = NAN;
+    stream >> result;
+    return result;
+}
+
+static bool keyLess(const ArenaJsonMember& a, const ArenaJsonMember& b)
+{
+    return JsonStringRef(a.key, a.keySize).compare(b.key, b.keySize) < 0;
+}
+
+/**
+ * Recursive descent parser following the one of Json::parse() step by step, so that the accepted
+ * grammar and the error messages are the same. Array items and object members are collected in
+ * scratch stacks shared by all nesting levels, and moved to the arena when the container ends.
+ */
+class Parser
+{
+public:
+    /** @param str Null-terminated copy of the text in the arena; strings refer to it. */
+    Parser(const char* str, size_t size, Arena* arena, std::string* err):
+        m_str(str), m_size(size), m_arena(arena), m_err(err)
+    {
+        m_items.reserve(64);
+        m_members.reserve(64);
+    }
+
+    const ArenaJsonNode* parseDocument()
+    {
+        ArenaJsonNode node;
+        parseJson(&node, /*depth*/ 0);
+
+        // Check for any trailing garbage.
+        consumeWhitespace();
+        if (m_failed)
+            return nullptr;
+        if (m_i != m_size)
+        {
+            fail("unexpected trailing " + esc(m_str[m_i]));
+            return nullptr;
+        }
+
+        ArenaJsonNode* const root = m_arena->allocateArray<ArenaJsonNode>(1);
+        *root = node;
+        return root;
+    }
+
+private:
+    bool fail(std::string message)
+    {
+        if (!m_failed)
+            *m_err = std::move(message);
+        m_failed = true;
+        return false;
+    }
+
+    void consumeWhitespace()
+    {
+        while (m_str[m_i] == ' ' || m_str[m_i] == '\r' || m_str[m_i] == '\n' || m_str[m_i] == '\t')
+            ++m_i;
+    }
+
+    /** @return The next non-whitespace char, or 0 with the error flagged at the end of input. */
+    char getNextToken()
+    {
+        consumeWhitespace();
+        if (m_i == m_size)
+        {
+            fail("unexpected end of input");
+            return 0;
+        }
+        return m_str[m_i++];
+    }
+
+    void encodeUtf8(long pt, std::string* out)
+    {
+        if (pt < 0)
+            return;
+
+        if (pt < 0x80)
+        {
+            *out += static_cast<char>(pt);
+        }
+        else if (pt < 0x800)
+        {
+            *out += static_cast<char>((pt >> 6) | 0xC0);
+            *out += static_cast<char>((pt & 0x3F) | 0x80);
+        }
+        else if (pt < 0x10000)
+        {
+            *out += static_cast<char>((pt >> 12) | 0xE0);
+            *out += static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
+            *out += static_cast<char>((pt & 0x3F) | 0x80);
+        }
+        else
+        {
+            *out += static_cast<char>((pt >> 18) | 0xF0);
+            *out += static_cast<char>(((pt >> 12) & 0x3F) | 0x80);
+            *out += static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
+            *out += static_cast<char>((pt & 0x3F) | 0x80);
+        }
+    }
+
+    /**
+     * Parse a string, starting after the opening quote. A string without escape sequences refers
+     * to the source text; otherwise, it is decoded into the arena.
+     */
+    bool parseString(JsonStringRef* outString)
+    {
+        const size_t start = m_i;
+        for (;;)
+        {
+            if (m_i == m_size)
+                return fail("unexpected end of input in string");
+
+            const char ch = m_str[m_i];
+            if (ch == '"')
+            {
+                *outString = JsonStringRef(m_str + start, m_i - start);
+                ++m_i;
+                return true;
+            }
+            if (inRange(ch, 0, 0x1f))
+            {
+                ++m_i;
+                return fail("unescaped " + esc(ch) + " in string");
+            }
+            if (ch == '\\')
+                break;
+            ++m_i;
+        }
+
+        m_decoded.assign(m_str + start, m_i - start);
+        if (!decodeEscapedString(&m_decoded))
+            return false;
+
+        char* const chars = m_arena->allocateArray<char>(m_decoded.size());
+        memcpy(chars, m_decoded.data(), m_decoded.size());
+        *outString = JsonStringRef(chars, m_decoded.size());
+        return true;
+    }
+
+    /** The part of Json::parse() string parsing which deals with escape sequences. */
+    bool decodeEscapedString(std::string* out)
+    {
+        long lastEscapedCodepoint = -1;
+        for (;;)
+        {
+            if (m_i == m_size)
+                return fail("unexpected end of input in string");
+
+            char ch = m_str[m_i++];
+
+            if (ch == '"')
+            {
+                encodeUtf8(lastEscapedCodepoint, out);
+                return true;
+            }
+
+            if (inRange(ch, 0, 0x1f))
+                return fail("unescaped " + esc(ch) + " in string");
+
+            // The usual case: non-escaped characters.
+            if (ch != '\\')
+            {
+                encodeUtf8(lastEscapedCodepoint, out);
+                lastEscapedCodepoint = -1;
+                *out += ch;
+                continue;
+            }
+
+            // Handle escapes.
+            if (m_i == m_size)
+                return fail("unexpected end of input in string");
+
+            ch = m_str[m_i++];
+
+            if (ch == 'u')
+            {
+                // Extract the 4-byte escape sequence.
+                const std::string escape(m_str + m_i, std::min<size_t>(4, m_size - m_i));
+                if (escape.length() < 4)
+                    return fail("bad \\u escape: " + escape);
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    if (!inRange(escape[j], 'a', 'f') && !inRange(escape[j], 'A', 'F')
+                        && !inRange(escape[j], '0', '9'))
+                    {
+                        return fail("bad \\u escape: " + escape);
+                    }
+                }
+
+                const long codepoint = strtol(escape.data(), nullptr, 16);
+
+                // Reassemble a surrogate pair into one astral-plane character.
+                if (inRange(lastEscapedCodepoint, 0xD800, 0xDBFF)
+                    && inRange(codepoint, 0xDC00, 0xDFFF))
+                {
+                    encodeUtf8((((lastEscapedCodepoint - 0xD800) << 10)
+                        | (codepoint - 0xDC00)) + 0x10000, out);
+                    lastEscapedCodepoint = -1;
+                }
+                else
+                {
+                    encodeUtf8(lastEscapedCodepoint, out);
+                    lastEscapedCodepoint = codepoint;
+                }
+
+                m_i += 4;
+                continue;
+            }
+
+            encodeUtf8(lastEscapedCodepoint, out);
+            lastEscapedCodepoint = -1;
+
+            switch (ch)
+            {
+                case 'b': *out += '\b'; break;
+                case 'f': *out += '\f'; break;
+                case 'n': *out += '\n'; break;
+                case 'r': *out += '\r'; break;
+                case 't': *out += '\t'; break;
+                case '"': case '\\': case '/': *out += ch; break;
+                default: return fail("invalid escape character " + esc(ch));
+            }
+        }
+    }
+
+    bool parseNumber(ArenaJsonNode* node)
+    {
+        const size_t startPos = m_i;
+
+        if (m_str[m_i] == '-')
+            ++m_i;
+
+        // Integer part.
+        if (m_str[m_i] == '0')
+        {
+            ++m_i;
+            if (inRange(m_str[m_i], '0', '9'))
+                return fail("leading 0s not permitted in numbers");
+        }
+        else if (inRange(m_str[m_i], '1', '9'))
+        {
+            ++m_i;
+            while (inRange(m_str[m_i], '0', '9'))
+                ++m_i;
+        }
+        else
+        {
+            return fail("invalid " + esc(m_str[m_i]) + " in number");
+        }
+
+        node->type = Json::NUMBER;
+        node->size = 0;
+
+        if (m_str[m_i] != '.' && m_str[m_i] != 'e' && m_str[m_i] != 'E'
+            && (m_i - startPos) <= static_cast<size_t>(std::numeric_limits<int>::digits10))
+        {
+            node->number = std::atoi(m_str + startPos);
+            return true;
+        }
+
+        // Decimal part.
+        if (m_str[m_i] == '.')
+        {
+            ++m_i;
+            if (!inRange(m_str[m_i], '0', '9'))
+                return fail("at least one digit required in fractional part");
+
+            while (inRange(m_str[m_i], '0', '9'))
+                ++m_i;
+        }
+
+        // Exponent part.
+        if (m_str[m_i] == 'e' || m_str[m_i] == 'E')
+        {
+            ++m_i;
+
+            if (m_str[m_i] == '+' || m_str[m_i] == '-')
+                ++m_i;
+
+            if (!inRange(m_str[m_i], '0', '9'))
+                return fail("at least one digit required in exponent");
+
+            while (inRange(m_str[m_i], '0', '9'))
+                ++m_i;
+        }
+
+        node->number = strtodDot(m_str + startPos);
+        return true;
+    }
+
+    /** Expect that `expected` starts at the char that was just read. */
+    bool expect(const char* expected)
+    {
+        --m_i;
+        const size_t length = strlen(expected);
+        if (m_size - m_i < length || memcmp(m_str + m_i, expected, length) != 0)
+        {
+            return fail(std::string("parse error: expected ") + expected + ", got "
+                + std::string(m_str + m_i, std::min(length, m_size - m_i)));
+        }
+        m_i += length;
+        return true;
+    }
+
+    bool parseJson(ArenaJsonNode* node, int depth)
+    {
+        *node = kNullNode;
+
+        if (depth > kMaxDepth)
+            return fail("exceeded maximum nesting depth");
+
+        char ch = getNextToken();
+        if (m_failed)
+            return false;
+
+        if (ch == '-' || (ch >= '0' && ch <= '9'))
+        {
+            --m_i;
+            return parseNumber(node);
+        }
+
+        if (ch == 't' || ch == 'f')
+        {
+            node->type = Json::BOOL;
+            node->boolean = ch == 't';
+            return expect(ch == 't' ? "true" : "false");
+        }
+
+        if (ch == 'n')
+            return expect("null");
+
+        if (ch == '"')
+        {
+            JsonStringRef string;
+            if (!parseString(&string))
+                return false;
+            node->type = Json::STRING;
+            node->size = static_cast<uint32_t>(string.size());
+            node->chars = string.data();
+            return true;
+        }
+
+        if (ch == '{')
+            return parseObject(node, depth);
+
+        if (ch == '[')
+            return parseArray(node, depth);
+
+        return fail("expected value, got " + esc(ch));
+    }
+
+    bool parseObject(ArenaJsonNode* node, int depth)
+    {
+        const size_t base = m_members.size();
+
+        char ch = getNextToken();
+        if (ch != '}')
+        {
+            for (;;)
+            {
+                if (ch != '"')
+                    return fail("expected '\"' in object, got " + esc(ch));
+
+                JsonStringRef key;
+                if (!parseString(&key))
+                    return false;
+
+                ch = getNextToken();
+                if (ch != ':')
+                    return fail("expected ':' in object, got " + esc(ch));
+
+                ArenaJsonMember member;
+                member.key = key.data();
+                member.keySize = key.size();
+                if (!parseJson(&member.value, depth + 1))
+                    return false;
+                m_members.push_back(member);
+
+                ch = getNextToken();
+                if (ch == '}')
+                    break;
+                if (ch != ',')
+                    return fail("expected ',' in object, got " + esc(ch));
+
+                ch = getNextToken();
+            }
+        }
+
+        const size_t count = sortAndDeduplicateMembers(base);
+        ArenaJsonMember* const members = m_arena->allocateArray<ArenaJsonMember>(count);
+        std::copy(m_members.begin() + base, m_members.begin() + base + count, members);
+        m_members.resize(base);
+
+        node->type = Json::OBJECT;
+        node->size = static_cast<uint32_t>(count);
+        node->members = members;
+        return true;
+    }
+
+    /**
+     * Sort the members collected for the current object by key; like in Json, the last of the
+     * members with the same key wins.
+     * @return Number of the remaining members.
+     */
+    size_t sortAndDeduplicateMembers(size_t base)
+    {
+        const auto begin = m_members.begin() + base;
+        const auto end = m_members.end();
+
+        // Objects are usually small: insertion sort is stable and needs no temporary buffer.
+        if (end - begin <= 32)
+        {
+            for (auto it = begin + 1; it < end; ++it)
+            {
+                const ArenaJsonMember member = *it;
+                auto position = it;
+                for (; position > begin && keyLess(member, *(position - 1)); --position)
+                    *position = *(position - 1);
+                *position = member;
+            }
+        }
+        else
+        {
+            std::stable_sort(begin, end, keyLess);
+        }
+
+        auto last = begin;
+        for (auto it = begin; it < end; ++it)
+        {
+            if (it + 1 < end && !keyLess(*it, *(it + 1)))
+                continue; //< The next member has the same key.
+            *last++ = *it;
+        }
+        return (size_t) (last - begin);
+    }
+
+    bool parseArray(ArenaJsonNode* node, int depth)
+    {
+        const size_t base = m_items.size();
+
+        char ch = getNextToken();
+        if (ch != ']')
+        {
+            for (;;)
+            {
+                --m_i;
+                ArenaJsonNode item;
+                if (!parseJson(&item, depth + 1))
+                    return false;
+                m_items.push_back(item);
+
+                ch = getNextToken();
+                if (ch == ']')
+                    break;
+                if (ch != ',')
+                    return fail("expected ',' in list, got " + esc(ch));
+
+                ch = getNextToken();
+            }
+        }
+        if (m_failed)
+            return false;
+
+        const size_t count = m_items.size() - base;
+        ArenaJsonNode* const items = m_arena->allocateArray<ArenaJsonNode>(count);
+        std::copy(m_items.begin() + base, m_items.end(), items);
+        m_items.resize(base);
+
+        node->type = Json::ARRAY;
+        node->size = static_cast<uint32_t>(count);
+        node->items = items;
+        return true;
+    }
+
+private:
+    const char* const m_str;
+    const size_t m_size;
+    Arena* const m_arena;
+    std::string* const m_err;
+    size_t m_i = 0;
+    bool m_failed = false;
+
+    std::vector<ArenaJsonNode> m_items;
+    std::vector<ArenaJsonMember> m_members;
+    std::string m_decoded;
+};
+
+} // namespace
+
+//-------------------------------------------------------------------------------------------------
+// JsonStringRef.
+
+int JsonStringRef::compare(const char* data, size_t size) const
+{
+    const int result = memcmp(m_data, data, std::min(m_size, size));
+    if (result != 0)
+        return result;
+    return (m_size < size) ? -1 : ((m_size > size) ? 1 : 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+// JsonView.
+
+JsonView::JsonView(): m_node(&kNullNode)
+{
+}
+
+Json::Type JsonView::type() const
+{
+    return m_node->type;
+}
+
+double JsonView::number_value() const
+{
+    return (m_node->type == Json::NUMBER) ? m_node->number : 0;
+}
+
+int JsonView::int_value() const
+{
+    return (m_node->type == Json::NUMBER) ? static_cast<int>(m_node->number) : 0;
+}
+
+bool JsonView::bool_value() const
+{
+    return (m_node->type == Json::BOOL) ? m_node->boolean : false;
+}
+
+JsonStringRef JsonView::string_value() const
+{
+    if (m_node->type != Json::STRING)
+        return JsonStringRef();
+    return JsonStringRef(m_node->chars, m_node->size);
+}
+
+size_t JsonView::size() const
+{
+    return (m_node->type == Json::ARRAY || m_node->type == Json::OBJECT) ? m_node->size : 0;
+}
+
+JsonView JsonView::operator[](size_t i) const
+{
+    if (m_node->type != Json::ARRAY || i >= m_node->size)
+        return JsonView();
+    return JsonView(&m_node->items[i]);
+}
+
+JsonView JsonView::operator[](const std::string& key) const
+{
+    if (m_node->type != Json::OBJECT)
+        return JsonView();
+
+    const ArenaJsonMember* const begin = m_node->members;
+    const ArenaJsonMember* const end = begin + m_node->size;
+    const ArenaJsonMember* const it = std::lower_bound(begin, end, key,
+        [](const ArenaJsonMember& member, const std::string& key)
+        {
+            return JsonStringRef(member.key, member.keySize).compare(key.data(), key.size()) < 0;
+        });
+    if (it == end || JsonStringRef(it->key, it->keySize) != key)
+        return JsonView();
+    return JsonView(&it->value);
+}
+
+JsonStringRef JsonView::key(size_t i) const
+{
+    if (m_node->type != Json::OBJECT || i >= m_node->size)
+        return JsonStringRef();
+    return JsonStringRef(m_node->members[i].key, m_node->members[i].keySize);
+}
+
+JsonView JsonView::value(size_t i) const
+{
+    if (m_node->type != Json::OBJECT || i >= m_node->size)
+        return JsonView();
+    return JsonView(&m_node->members[i].value);
+}
+
+Json JsonView::toJson() const
+{
+    switch (m_node->type)
+    {
+        case Json::NUMBER:
+            return Json(m_node->number);
+        case Json::BOOL:
+            return Json(m_node->boolean);
+        case Json::STRING:
+            return Json(string_value().toString());
+        case Json::ARRAY:
+        {
+            Json::array items;
+            items.reserve(m_node->size);
+            for (size_t i = 0; i < m_node->size; ++i)
+                items.push_back((*this)[i].toJson());
+            return Json(std::move(items));
+        }
+        case Json::OBJECT:
+        {
+            Json::object members;
+            for (size_t i = 0; i < m_node->size; ++i)
+                members.emplace_hint(members.end(), key(i).toString(), value(i).toJson());
+            return Json(std::move(members));
+        }
+        default:
+            return Json();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// ArenaJson.
+
+struct ArenaJson::Impl
+{
+    explicit Impl(size_t firstBlockSize): arena(firstBlockSize) {}
+
+    Arena arena;
+    const ArenaJsonNode* root = &kNullNode;
+};
+
+ArenaJson::ArenaJson(): d(new Impl(/*firstBlockSize*/ 0))
+{
+}
+
+ArenaJson::ArenaJson(size_t firstBlockSize): d(new Impl(firstBlockSize))
+{
+}
+
+ArenaJson::ArenaJson(ArenaJson&& other): d(std::move(other.d))
+{
+    other.d.reset(new Impl(/*firstBlockSize*/ 0));
+}
+
+ArenaJson& ArenaJson::operator=(ArenaJson&& other)
+{
+    std::swap(d, other.d);
+    return *this;
+}
+
+ArenaJson::~ArenaJson()
+{
+}
+
+ArenaJson ArenaJson::parse(const std::string& in, std::string& err)
+{
+    if (in.size() >= std::numeric_limits<uint32_t>::max())
+    {
+        err = "input is too large";
+        return ArenaJson();
+    }
+
+    // Typical documents fit into the first block: the copy of the text plus about as many bytes
+    // of nodes.
+    ArenaJson result(/*firstBlockSize*/ 2 * in.size() + 256);
+    Arena& arena = result.d->arena;
+
+    char* const text = arena.allocateArray<char>(in.size() + 1);
+    memcpy(text, in.c_str(), in.size() + 1);
+
+    Parser parser(text, in.size(), &arena, &err);
+    if (const ArenaJsonNode* const root = parser.parseDocument())
+        result.d->root = root;
+    return result;
+}
+
+JsonView ArenaJson::root() const
+{
+    return JsonView(d->root);
+}
+
+size_t ArenaJson::allocatedBytes() const
+{
+    return d->arena.allocatedBytes();
+}
+
+} // namespace kit
+} // namespace nx
@@ -0,0 +1,143 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+/**@file
+ * Read-only alternative to nx::kit::Json for parsing large or frequently received JSON texts with
+ * few allocations.
+ *
+ * Json::parse() allocates a reference-counted node per value and a std::map per object. ArenaJson
+ * instead places the whole DOM into a few big memory blocks owned by the document: arrays and
+ * objects are contiguous node arrays, object members are sorted by key for binary search, and
+ * strings without escape sequences refer to the copy of the source text kept in the same blocks.
+ *
+ * The parser accepts the same grammar as Json::parse() with JsonParse::STANDARD, and reports the
+ * same error messages. Values are accessed via JsonView handles which are valid as long as the
+ * ArenaJson they came from exists; use JsonView::toJson() to get a modifiable copy.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "json.h"
+
+#if !defined(NX_KIT_API)
+    #define NX_KIT_API /*empty*/
+#endif
+
+namespace nx {
+namespace kit {
+
+namespace detail {
+
+struct ArenaJsonNode;
+struct ArenaJsonMember;
+
+} // namespace detail
+
+/** Non-owning reference to a string inside an ArenaJson document; not null-terminated. */
+class NX_KIT_API JsonStringRef
+{
+public:
+    JsonStringRef() = default;
+    JsonStringRef(const char* data, size_t size): m_data(data), m_size(size) {}
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    std::string toString() const { return std::string(m_data, m_size); }
+
+    int compare(const char* data, size_t size) const;
+
+    bool operator==(const JsonStringRef& other) const { return compare(other.m_data, other.m_size) == 0; }
+    bool operator!=(const JsonStringRef& other) const { return !(*this == other); }
+    bool operator==(const std::string& s) const { return compare(s.data(), s.size()) == 0; }
+    bool operator!=(const std::string& s) const { return !(*this == s); }
+
+private:
+    const char* m_data = "";
+    size_t m_size = 0;
+};
+
+/**
+ * Read-only handle to a value inside an ArenaJson document. The accessors follow the ones of
+ * nx::kit::Json: accessing a value of a different type yields 0, false, an empty string, or a
+ * null JsonView.
+ */
+class NX_KIT_API JsonView
+{
+public:
+    /** Null value. */
+    JsonView();
+
+    Json::Type type() const;
+    bool is_null() const { return type() == Json::NUL; }
+    bool is_number() const { return type() == Json::NUMBER; }
+    bool is_bool() const { return type() == Json::BOOL; }
+    bool is_string() const { return type() == Json::STRING; }
+    bool is_array() const { return type() == Json::ARRAY; }
+    bool is_object() const { return type() == Json::OBJECT; }
+
+    double number_value() const;
+    int int_value() const;
+    bool bool_value() const;
+    JsonStringRef string_value() const;
+
+    /** @return Number of array items or object members; 0 for other types. */
+    size_t size() const;
+
+    /** @return Array item, or null if this is not an array or the index is out of range. */
+    JsonView operator[](size_t i) const;
+
+    /** @return Object member value (binary search by key), or null if there is no such member. */
+    JsonView operator[](const std::string& key) const;
+
+    /** @return Key of the i-th object member; the members are sorted by key. */
+    JsonStringRef key(size_t i) const;
+
+    /** @return Value of the i-th object member; the members are sorted by key. */
+    JsonView value(size_t i) const;
+
+    /** Deep copy into a regular Json value. */
+    Json toJson() const;
+
+private:
+    friend class ArenaJson;
+    explicit JsonView(const detail::ArenaJsonNode* node): m_node(node) {}
+
+private:
+    const detail::ArenaJsonNode* m_node;
+};
+
+/** Document produced by ArenaJson::parse(); owns all the memory its JsonView handles refer to. */
+class NX_KIT_API ArenaJson
+{
+public:
+    ArenaJson();
+    ArenaJson(ArenaJson&& other);
+    ArenaJson& operator=(ArenaJson&& other);
+    ~ArenaJson();
+
+    /**
+     * Parse. If parse fails, return a document with a null root and assign an error message to
+     * err, like Json::parse().
+     */
+    static ArenaJson parse(const std::string& in, std::string& err);
+
+    JsonView root() const;
+
+    /** @return Total size of the memory blocks allocated for the document. */
+    size_t allocatedBytes() const;
+
+private:
+    explicit ArenaJson(size_t firstBlockSize);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> d;
+};
+
+} // namespace kit
+} // namespace nx
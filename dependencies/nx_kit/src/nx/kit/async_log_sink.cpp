@@ -0,0 +1,389 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "async_log_sink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "debug.h"
+#include "utils.h"
+
+namespace nx {
+namespace kit {
+
+namespace {
+
+static const std::chrono::milliseconds kIdleWritePeriod(20);
+static const char kTruncatedSuffix[] = " <...>\n";
+
+/**
+ * Bounded multi-producer single-consumer queue of records (the algorithm by Dmitry Vyukov): each
+ * slot has a sequence number telling whether it is free for the producer which claimed the
+ * position, or holds a record for the consumer. Producers only claim positions via CAS, and never
+ * wait for each other.
+ *
+ * The records are swapped in and out rather than copied, so the strings keep circulating between
+ * the slots and the threads' buffers, and the allocations stop after the warm-up.
+ */
+class Queue
+{
+public:
+    explicit Queue(size_t capacity): m_slots(capacity), m_mask(capacity - 1)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return m_slots.size(); }
+
+    /** @return False if the queue is full; otherwise, record receives an empty string. */
+    bool push(std::string* record)
+    {
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot& slot = m_slots[position & m_mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+            if (difference == 0)
+            {
+                if (m_enqueuePosition.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.text.swap(*record);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** Called by the consumer only. @return False if the queue is empty. */
+    bool popInto(std::string* batch)
+    {
+        Slot& slot = m_slots[m_dequeuePosition & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+            return false;
+        batch->append(slot.text);
+        slot.text.clear(); //< Keeps the capacity for the producer which gets this string.
+        slot.sequence.store(m_dequeuePosition + capacity(), std::memory_order_release);
+        ++m_dequeuePosition;
+        return true;
+    }
+
+    /** Number of records ever claimed by the producers. */
+    size_t enqueuePosition() const { return m_enqueuePosition.load(std::memory_order_acquire); }
+
+    /** Called by the consumer only. */
+    size_t dequeuePosition() const { return m_dequeuePosition; }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        std::string text;
+    };
+
+    std::vector<Slot> m_slots;
+    const size_t m_mask;
+    std::atomic<size_t> m_enqueuePosition{0};
+    size_t m_dequeuePosition = 0;
+};
+
+class Sink
+{
+public:
+    Sink(size_t capacity, size_t maxRecordSize):
+        m_queue(capacity), m_maxRecordSize(maxRecordSize)
+    {
+    }
+
+    size_t capacity() const { return m_queue.capacity(); }
+    size_t maxRecordSize() const { return m_maxRecordSize; }
+
+    void start()
+    {
+        m_stopping = false;
+        m_isRunning = true;
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    void stop()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeUp.notify_one();
+        m_thread.join();
+    }
+
+    void push(std::string* record)
+    {
+        if (record->size() > m_maxRecordSize)
+        {
+            record->resize(m_maxRecordSize - (sizeof(kTruncatedSuffix) - 1));
+            record->append(kTruncatedSuffix);
+            record->shrink_to_fit();
+        }
+
+        if (!m_queue.push(record))
+        {
+            record->clear();
+            m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // A wake-up lost in the race with the writer going to sleep only delays the write by
+        // kIdleWritePeriod, so the producers do not lock the mutex.
+        if (m_isWriterSleeping.load(std::memory_order_acquire))
+            m_wakeUp.notify_one();
+    }
+
+    void flush()
+    {
+        const size_t targetPosition = m_queue.enqueuePosition();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_isFlushRequested = true;
+        m_wakeUp.notify_one();
+        m_flushed.wait(lock,
+            [&]() { return m_writtenPosition >= targetPosition || !m_isRunning; });
+    }
+
+    int64_t writtenRecords() const { return m_writtenRecords.load(std::memory_order_relaxed); }
+    int64_t droppedRecords() const { return m_droppedRecords.load(std::memory_order_relaxed); }
+
+private:
+    void run()
+    {
+        std::string batch;
+        for (;;)
+        {
+            int64_t recordCount = 0;
+            while (m_queue.popInto(&batch))
+                ++recordCount;
+
+            const int64_t droppedRecords = m_droppedRecords.load(std::memory_order_relaxed);
+            if (droppedRecords != m_reportedDroppedRecords)
+            {
+                batch += nx::kit::utils::format(
+                    "[async_log_sink] %lld record(s) dropped: the queue is full\n",
+                    (long long) (droppedRecords - m_reportedDroppedRecords));
+                m_reportedDroppedRecords = droppedRecords;
+            }
+
+            if (!batch.empty())
+            {
+                std::ostream* const stream = nx::kit::debug::stream();
+                stream->write(batch.data(), (std::streamsize) batch.size());
+                stream->flush();
+                batch.clear();
+                m_writtenRecords.fetch_add(recordCount, std::memory_order_relaxed);
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_writtenPosition = m_queue.dequeuePosition();
+            m_flushed.notify_all();
+            if (recordCount > 0)
+                continue;
+            if (m_stopping)
+            {
+                m_isRunning = false;
+                m_flushed.notify_all();
+                break;
+            }
+            if (m_isFlushRequested) //< The flushing thread waits for a record not published yet.
+            {
+                m_isFlushRequested = false;
+                lock.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+            m_isWriterSleeping.store(true, std::memory_order_release);
+            m_wakeUp.wait_for(lock, kIdleWritePeriod);
+            m_isWriterSleeping.store(false, std::memory_order_release);
+        }
+    }
+
+private:
+    Queue m_queue;
+    const size_t m_maxRecordSize;
+    std::thread m_thread;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::condition_variable m_flushed;
+    bool m_stopping = false;
+    bool m_isRunning = false;
+    bool m_isFlushRequested = false;
+    size_t m_writtenPosition = 0;
+
+    std::atomic<bool> m_isWriterSleeping{false};
+    std::atomic<int64_t> m_writtenRecords{0};
+    std::atomic<int64_t> m_droppedRecords{0};
+    int64_t m_reportedDroppedRecords = 0;
+};
+
+/** Guards start(), stop() and the list of sinks. */
+static std::mutex& controlMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+/** The running sink, if any. */
+static std::atomic<Sink*> currentSink{nullptr};
+
+/**
+ * All sinks ever created. A stopped sink is never deleted: a thread which has just seen it as the
+ * current one may still be pushing into its queue.
+ */
+static std::vector<Sink*>& sinks()
+{
+    static std::vector<Sink*>& sinks = *new std::vector<Sink*>();
+    return sinks;
+}
+
+/** Collects the record of the calling thread; std::endl (via sync()) submits it. */
+class RecordBuffer: public std::streambuf
+{
+protected:
+    virtual int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            m_record += traits_type::to_char_type(c);
+        return traits_type::not_eof(c);
+    }
+
+    virtual std::streamsize xsputn(const char* s, std::streamsize count) override
+    {
+        m_record.append(s, (size_t) count);
+        return count;
+    }
+
+    virtual int sync() override
+    {
+        if (m_record.empty())
+            return 0;
+
+        if (Sink* const sink = currentSink.load(std::memory_order_acquire))
+        {
+            sink->push(&m_record);
+        }
+        else //< The sink has been stopped while the record was being formatted.
+        {
+            nx::kit::debug::stream()->write(m_record.data(), (std::streamsize) m_record.size());
+            m_record.clear();
+        }
+        return 0;
+    }
+
+private:
+    std::string m_record;
+};
+
+struct ThreadStream
+{
+    RecordBuffer buffer;
+    std::ostream stream{&buffer};
+};
+
+static std::ostream* threadStream()
+{
+    static thread_local ThreadStream threadStream;
+    return &threadStream.stream;
+}
+
+static size_t roundUpToPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+} // namespace
+
+void AsyncLogSink::start(int capacity, int maxRecordSize)
+{
+    const std::lock_guard<std::mutex> lock(controlMutex());
+    if (currentSink.load())
+        return;
+
+    const size_t effectiveCapacity = roundUpToPowerOfTwo(capacity > 1 ? (size_t) capacity : 2);
+    const size_t effectiveMaxRecordSize = (size_t) std::max(maxRecordSize, 64);
+
+    Sink* sink = nullptr;
+    for (Sink* const stoppedSink: sinks())
+    {
+        if (stoppedSink->capacity() == effectiveCapacity
+            && stoppedSink->maxRecordSize() == effectiveMaxRecordSize)
+        {
+            sink = stoppedSink;
+        }
+    }
+    if (!sink)
+    {
+        sink = new Sink(effectiveCapacity, effectiveMaxRecordSize);
+        sinks().push_back(sink);
+    }
+
+    sink->start();
+    currentSink.store(sink, std::memory_order_release);
+    nx::kit::debug::setThreadStreamProvider(&threadStream);
+}
+
+void AsyncLogSink::stop()
+{
+    const std::lock_guard<std::mutex> lock(controlMutex());
+    Sink* const sink = currentSink.load();
+    if (!sink)
+        return;
+
+    nx::kit::debug::setThreadStreamProvider(nullptr);
+    currentSink.store(nullptr, std::memory_order_release);
+    sink->stop();
+}
+
+void AsyncLogSink::flush()
+{
+    if (Sink* const sink = currentSink.load(std::memory_order_acquire))
+        sink->flush();
+}
+
+bool AsyncLogSink::isStarted()
+{
+    return currentSink.load(std::memory_order_acquire) != nullptr;
+}
+
+AsyncLogSink::Stats AsyncLogSink::stats()
+{
+    const std::lock_guard<std::mutex> lock(controlMutex());
+    Stats result;
+    for (const Sink* const sink: sinks())
+    {
+        result.writtenRecords += sink->writtenRecords();
+        result.droppedRecords += sink->droppedRecords();
+    }
+    return result;
+}
+
+} // namespace kit
+} // namespace nx
@@ -0,0 +1,71 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+/**@file
+ * Asynchronous backend for NX_PRINT and NX_OUTPUT: the calling thread only formats the record and
+ * puts it into a queue, and a background thread writes the queued records to
+ * nx::kit::debug::stream() in batches.
+ */
+
+#include <cstdint>
+
+#if !defined(NX_KIT_API)
+    #define NX_KIT_API /*empty*/
+#endif
+
+namespace nx {
+namespace kit {
+
+/**
+ * Process-wide switch of NX_PRINT to asynchronous output.
+ *
+ * While started, each thread formats its NX_PRINT records in its own buffer; on std::endl the
+ * record is put into a bounded lock-free queue, so NX_PRINT does not block on the output, even
+ * when called under a mutex. The writer thread concatenates the queued records and writes each
+ * batch to nx::kit::debug::stream() with a single call.
+ *
+ * When the queue is full, the record is dropped and counted; the writer reports the number of
+ * dropped records in the output. Records longer than the maximum size are truncated.
+ *
+ * ATTENTION: The records which are still in the queue when the process crashes are lost, thus,
+ * call flush() at the points where the output must reach the file, e.g. on shutdown.
+ */
+class NX_KIT_API AsyncLogSink
+{
+public:
+    struct Stats
+    {
+        int64_t writtenRecords = 0;
+        int64_t droppedRecords = 0;
+    };
+
+    static constexpr int kDefaultCapacity = 1024;
+    static constexpr int kDefaultMaxRecordSize = 16 * 1024;
+
+    /**
+     * Starts the writer thread and redirects NX_PRINT to the queue; does nothing if already
+     * started.
+     * @param capacity Max number of records in the queue; rounded up to a power of two.
+     */
+    static void start(int capacity = kDefaultCapacity, int maxRecordSize = kDefaultMaxRecordSize);
+
+    /**
+     * Writes out the queued records and stops the writer thread; NX_PRINT writes directly to
+     * nx::kit::debug::stream() again. Does nothing if not started.
+     */
+    static void stop();
+
+    /** Blocks until the records queued before the call are written; does nothing if stopped. */
+    static void flush();
+
+    static bool isStarted();
+
+    /** Counters since the first start(). */
+    static Stats stats();
+
+    AsyncLogSink() = delete;
+};
+
+} // namespace kit
+} // namespace nx
@@ -2,6 +2,7 @@
 
 #include "debug.h"
 
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <fstream>
@@ -11,6 +12,7 @@
 #include <memory>
 #include <map>
 #include <mutex>
+#include <cmath>
 #include <cstring>
 
 namespace nx {
@@ -58,6 +60,39 @@ std::ostream*& stream()
     return stream;
 }
 
+static std::atomic<ThreadStreamProvider> threadStreamProvider{nullptr};
+
+void setThreadStreamProvider(ThreadStreamProvider provider)
+{
+    threadStreamProvider.store(provider, std::memory_order_release);
+}
+
+std::ostream& outputStream()
+{
+    if (const ThreadStreamProvider provider =
+        threadStreamProvider.load(std::memory_order_acquire))
+    {
+        return *provider();
+    }
+    return *stream();
+}
+
+namespace detail {
+
+std::atomic<int> logLevel{NX_LOG_LEVEL_TRACE};
+
+} // namespace detail
+
+void setLogLevel(int level)
+{
+    detail::logLevel.store(level, std::memory_order_relaxed);
+}
+
+int logLevel()
+{
+    return detail::logLevel.load(std::memory_order_relaxed);
+}
+
 namespace detail {
 
 std::string printPrefix(const char* file)
@@ -225,10 +260,11 @@ void saveBin(
 
 namespace detail {
 
+/** Steady clock: the measured intervals do not jump with the system time adjustments. */
 static int64_t getTimeUs()
 {
     return std::chrono::duration_cast<std::chrono::microseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+        std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 struct Timer::Impl
@@ -301,6 +337,186 @@ void Timer::finish()
 
 } // namespace detail
 
+//-------------------------------------------------------------------------------------------------
+// Latency histogram
+
+namespace {
+
+/** Values below 2 * kSubBucketCount have buckets of their own; above, 32 per power of two. */
+static constexpr int kSubBucketBits = 5;
+static constexpr int64_t kSubBucketCount = int64_t(1) << kSubBucketBits;
+static constexpr int kBucketCount = (64 - kSubBucketBits) * (int) kSubBucketCount;
+
+static std::atomic<int64_t> latencyHistogramDumpPeriodUs{10 * 60 * 1000 * 1000LL};
+
+static int highestBitIndex(uint64_t value)
+{
+    int index = 0;
+    while (value >>= 1)
+        ++index;
+    return index;
+}
+
+static int bucketIndex(int64_t value)
+{
+    if (value < 2 * kSubBucketCount)
+        return (int) value;
+    const int shift = highestBitIndex((uint64_t) value) - kSubBucketBits;
+    return (shift + 1) * (int) kSubBucketCount + (int) ((value >> shift) - kSubBucketCount);
+}
+
+/** @return The highest value which falls into the bucket. */
+static int64_t bucketHighestValue(int index)
+{
+    if (index < 2 * kSubBucketCount)
+        return index;
+    const int shift = index / (int) kSubBucketCount - 1;
+    const int64_t top = index % kSubBucketCount + kSubBucketCount;
+    return ((top + 1) << shift) - 1;
+}
+
+static std::string durationToString(int64_t us)
+{
+    if (us < 1000)
+        return format("%d us", (int) us);
+    return format("%.1f ms", us / 1000.0);
+}
+
+} // namespace
+
+struct LatencyHistogram::Impl
+{
+    const std::string name;
+    std::atomic<int64_t> buckets[kBucketCount];
+    std::atomic<int64_t> count{0};
+    std::atomic<int64_t> maxUs{0};
+    std::atomic<int64_t> lastDumpTimeUs{detail::getTimeUs()};
+
+    explicit Impl(const std::string& name): name(name)
+    {
+        for (auto& bucket: buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+};
+
+static std::mutex& latencyHistogramsMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::map<std::string, LatencyHistogram*>& latencyHistograms()
+{
+    // Never destroyed: the histograms can be used from static destructors of other units.
+    static auto& histograms = *new std::map<std::string, LatencyHistogram*>();
+    return histograms;
+}
+
+LatencyHistogram& LatencyHistogram::get(const std::string& name)
+{
+    const std::lock_guard<std::mutex> lock(latencyHistogramsMutex());
+    LatencyHistogram*& histogram = latencyHistograms()[name];
+    if (!histogram)
+        histogram = new LatencyHistogram(name);
+    return *histogram;
+}
+
+std::string LatencyHistogram::summaryOfAll()
+{
+    const std::lock_guard<std::mutex> lock(latencyHistogramsMutex());
+    std::string result;
+    for (const auto& entry: latencyHistograms())
+    {
+        if (!result.empty())
+            result += "\n";
+        result += entry.second->summary();
+    }
+    return result;
+}
+
+void LatencyHistogram::setDumpPeriodMs(int64_t periodMs)
+{
+    latencyHistogramDumpPeriodUs.store(periodMs * 1000, std::memory_order_relaxed);
+}
+
+LatencyHistogram::LatencyHistogram(const std::string& name): d(new Impl(name))
+{
+}
+
+LatencyHistogram::~LatencyHistogram()
+{
+    delete d;
+}
+
+void LatencyHistogram::record(int64_t durationUs)
+{
+    if (durationUs < 0)
+        durationUs = 0;
+
+    d->buckets[bucketIndex(durationUs)].fetch_add(1, std::memory_order_relaxed);
+    d->count.fetch_add(1, std::memory_order_relaxed);
+    int64_t maxUs = d->maxUs.load(std::memory_order_relaxed);
+    while (durationUs > maxUs
+        && !d->maxUs.compare_exchange_weak(maxUs, durationUs, std::memory_order_relaxed))
+    {
+    }
+
+    const int64_t dumpPeriodUs = latencyHistogramDumpPeriodUs.load(std::memory_order_relaxed);
+    if (dumpPeriodUs <= 0)
+        return;
+    const int64_t timeUs = detail::getTimeUs();
+    int64_t lastDumpTimeUs = d->lastDumpTimeUs.load(std::memory_order_relaxed);
+    if (timeUs - lastDumpTimeUs >= dumpPeriodUs
+        && d->lastDumpTimeUs.compare_exchange_strong(lastDumpTimeUs, timeUs))
+    {
+        NX_PRINT << "Latency " << summary();
+    }
+}
+
+const std::string& LatencyHistogram::name() const
+{
+    return d->name;
+}
+
+int64_t LatencyHistogram::count() const
+{
+    return d->count.load(std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::maxUs() const
+{
+    return d->maxUs.load(std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::percentileUs(double percentile) const
+{
+    // The buckets may be updated concurrently: count them instead of relying on d->count.
+    int64_t total = 0;
+    for (const auto& bucket: d->buckets)
+        total += bucket.load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0;
+
+    const int64_t rank = std::max((int64_t) 1, (int64_t) std::ceil(total * percentile / 100));
+    int64_t cumulativeCount = 0;
+    for (int i = 0; i < kBucketCount; ++i)
+    {
+        cumulativeCount += d->buckets[i].load(std::memory_order_relaxed);
+        if (cumulativeCount >= rank)
+            return std::min(bucketHighestValue(i), maxUs());
+    }
+    return maxUs();
+}
+
+std::string LatencyHistogram::summary() const
+{
+    return d->name + ": " + toString(count()) + " values"
+        + ", p50 " + durationToString(percentileUs(50))
+        + ", p90 " + durationToString(percentileUs(90))
+        + ", p99 " + durationToString(percentileUs(99))
+        + ", max " + durationToString(maxUs());
+}
+
 //-------------------------------------------------------------------------------------------------
 // Fps
 
@@ -9,11 +9,14 @@
  * This unit can be compiled in the context of any C++ project.
  */
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <stdint.h>
 #include <functional>
 #include <sstream>
 #include <memory>
+#include <string>
 
 #include <nx/kit/utils.h>
 
@@ -68,7 +71,7 @@ NX_KIT_API std::string srcFileBaseNameWithoutExt(const std::string& file);
 
 #if !defined(NX_DEBUG_STREAM)
     /** Redefine if needed; used for all output by other macros. */
-    #define NX_DEBUG_STREAM *::nx::kit::debug::stream()
+    #define NX_DEBUG_STREAM ::nx::kit::debug::outputStream()
 #endif
 
 #if !defined(NX_DEBUG_ENDL)
@@ -82,6 +85,17 @@ NX_KIT_API std::string srcFileBaseNameWithoutExt(const std::string& file);
  */
 NX_KIT_API std::ostream*& stream();
 
+typedef std::ostream* (*ThreadStreamProvider)();
+
+/**
+ * Allows to give each thread its own stream for NX_PRINT, like nx::kit::AsyncLogSink does; null
+ * (initially) means stream() for all threads.
+ */
+NX_KIT_API void setThreadStreamProvider(ThreadStreamProvider provider);
+
+/** @return Stream of the calling thread if the provider is set, or stream() otherwise. */
+NX_KIT_API std::ostream& outputStream();
+
 #if !defined(NX_PRINT)
     /**
      * Print the args to NX_DEBUG_STREAM, starting with NX_PRINT_PREFIX and ending with
@@ -95,14 +109,69 @@ NX_KIT_API std::ostream*& stream();
 #endif
 
 /**
- * Prints the args like NX_PRINT; does nothing if !NX_DEBUG_ENABLE_OUTPUT.
+ * Prints the args like NX_PRINT; does nothing if !NX_DEBUG_ENABLE_OUTPUT. Has the debug level: see
+ * NX_LOG_DEBUG.
  */
 #define NX_OUTPUT /* << args... */ \
-    for (/* Executed either once or never; `for` instead of `if` gives no warnings. */ \
-        int NX_KIT_DEBUG_DETAIL_CONCAT(nxOutput_, __line__) = 0; \
-        NX_KIT_DEBUG_DETAIL_CONCAT(nxOutput_, __line__) != 1 && (NX_DEBUG_ENABLE_OUTPUT); \
-        ++NX_KIT_DEBUG_DETAIL_CONCAT(nxOutput_, __line__) \
-    ) NX_PRINT
+    NX_KIT_DEBUG_DETAIL_IF_LOG_ENABLED(NX_LOG_LEVEL_DEBUG) NX_PRINT
+
+//-------------------------------------------------------------------------------------------------
+// Levelled output
+
+/** Levels for NX_LOG_...; numbers to be usable in `#if`. */
+#define NX_LOG_LEVEL_TRACE 0
+#define NX_LOG_LEVEL_DEBUG 1
+#define NX_LOG_LEVEL_INFO 2
+#define NX_LOG_LEVEL_WARN 3
+#define NX_LOG_LEVEL_ERROR 4
+#define NX_LOG_LEVEL_NONE 5
+
+#if !defined(NX_DEBUG_MIN_LOG_LEVEL)
+    /**
+     * Redefine (e.g. via a compiler option) to compile out the levelled output below this level,
+     * including NX_OUTPUT: such statements turn into dead code, and their args are not evaluated.
+     */
+    #define NX_DEBUG_MIN_LOG_LEVEL NX_LOG_LEVEL_TRACE
+#endif
+
+/**
+ * Sets the minimum level of the levelled output checked at runtime; initially NX_LOG_LEVEL_TRACE,
+ * so that only NX_DEBUG_MIN_LOG_LEVEL and NX_DEBUG_ENABLE_OUTPUT filter the output.
+ */
+NX_KIT_API void setLogLevel(int level);
+
+NX_KIT_API int logLevel();
+
+/**
+ * Whether the output of the given level is enabled: the level is not compiled out, passes the
+ * runtime level, and the debug and trace levels also require NX_DEBUG_ENABLE_OUTPUT. Can be used
+ * to skip preparing the data which is needed only for the output:
+ * ```
+ *     if (NX_LOG_ENABLED(NX_LOG_LEVEL_DEBUG))
+ *         NX_LOG_DEBUG << describe(packet);
+ * ```
+ * @param LEVEL One of NX_LOG_LEVEL_... macros, or the respective literal.
+ */
+#define NX_LOG_ENABLED(LEVEL) \
+    ((LEVEL) >= NX_DEBUG_MIN_LOG_LEVEL \
+        && NX_KIT_DEBUG_DETAIL_CONCAT(NX_KIT_DEBUG_DETAIL_LOG_LEVEL_OUTPUT_FLAG_, LEVEL) \
+        && ::nx::kit::debug::detail::isLogLevelEnabled(LEVEL))
+
+/**
+ * Print the args like NX_PRINT if the output of the respective level is enabled; see
+ * NX_LOG_ENABLED(). The args are not evaluated otherwise. Warnings and errors are marked in the
+ * output with "WARNING: " and "ERROR: " after NX_PRINT_PREFIX.
+ */
+#define NX_LOG_TRACE /* << args... */ \
+    NX_KIT_DEBUG_DETAIL_IF_LOG_ENABLED(NX_LOG_LEVEL_TRACE) NX_PRINT
+#define NX_LOG_DEBUG /* << args... */ \
+    NX_KIT_DEBUG_DETAIL_IF_LOG_ENABLED(NX_LOG_LEVEL_DEBUG) NX_PRINT
+#define NX_LOG_INFO /* << args... */ \
+    NX_KIT_DEBUG_DETAIL_IF_LOG_ENABLED(NX_LOG_LEVEL_INFO) NX_PRINT
+#define NX_LOG_WARN /* << args... */ \
+    NX_KIT_DEBUG_DETAIL_IF_LOG_ENABLED(NX_LOG_LEVEL_WARN) NX_PRINT << "WARNING: "
+#define NX_LOG_ERROR /* << args... */ \
+    NX_KIT_DEBUG_DETAIL_IF_LOG_ENABLED(NX_LOG_LEVEL_ERROR) NX_PRINT << "ERROR: "
 
 //-------------------------------------------------------------------------------------------------
 // Assertions
@@ -218,6 +287,62 @@ NX_KIT_API std::string hexDumpLine(const char* bytes, int size, int bytesPerLine
         nxTimer_##TAG.finish(); \
 } while (0)
 
+/**
+ * Measures the time from this point to the end of the scope, and records it into the latency
+ * histogram named NAME (see LatencyHistogram). Unlike NX_TIME_BEGIN, it is always on and prints
+ * nothing per measurement, only a periodic summary, thus, can be used in production code.
+ */
+#define NX_TIME_HISTOGRAM(NAME) \
+    static ::nx::kit::debug::LatencyHistogram& \
+        NX_KIT_DEBUG_DETAIL_CONCAT(nxLatencyHistogram_, __LINE__) = \
+            ::nx::kit::debug::LatencyHistogram::get(NAME); \
+    const ::nx::kit::debug::detail::ScopedLatency \
+        NX_KIT_DEBUG_DETAIL_CONCAT(nxScopedLatency_, __LINE__)( \
+            &NX_KIT_DEBUG_DETAIL_CONCAT(nxLatencyHistogram_, __LINE__))
+
+/**
+ * Lock-free histogram of durations in the spirit of HdrHistogram: the values are counted in
+ * log-linear buckets (32 per power of two), so any percentile is known with the relative error
+ * within ~3% using a fixed amount of memory.
+ *
+ * Histograms are registered by name, and each periodically prints its summary with NX_PRINT (see
+ * setDumpPeriodMs()), so the tail latency is visible without printing each measurement.
+ */
+class NX_KIT_API LatencyHistogram
+{
+public:
+    /** @return Histogram with the given name, created on the first call and never destroyed. */
+    static LatencyHistogram& get(const std::string& name);
+
+    /** @return Summaries of all histograms, sorted by name, one per line. */
+    static std::string summaryOfAll();
+
+    /**
+     * Sets how often record() prints the summary of the histogram; 0 means never. Initially 10
+     * minutes.
+     */
+    static void setDumpPeriodMs(int64_t periodMs);
+
+    void record(int64_t durationUs);
+
+    const std::string& name() const;
+    int64_t count() const;
+    int64_t maxUs() const;
+
+    /** @param percentile In the range [0, 100]. @return 0 if there are no values. */
+    int64_t percentileUs(double percentile) const;
+
+    /** @return Line like "name: 12 values, p50 1.2 ms, p90 1.5 ms, p99 7.0 ms, max 7.1 ms". */
+    std::string summary() const;
+
+private:
+    explicit LatencyHistogram(const std::string& name);
+    ~LatencyHistogram();
+
+    struct Impl;
+    Impl* const d;
+};
+
 //-------------------------------------------------------------------------------------------------
 // Fps
 
@@ -282,6 +407,31 @@ inline bool doAssert(
 #define NX_KIT_DEBUG_DETAIL_CONCAT(X, Y) NX_KIT_DEBUG_DETAIL_CONCAT2(X, Y)
 #define NX_KIT_DEBUG_DETAIL_CONCAT2(X, Y) X##Y
 
+#define NX_KIT_DEBUG_DETAIL_IF_LOG_ENABLED(LEVEL) \
+    for (/* Executed either once or never; `for` instead of `if` gives no warnings. */ \
+        int NX_KIT_DEBUG_DETAIL_CONCAT(nxOutput_, __line__) = 0; \
+        NX_KIT_DEBUG_DETAIL_CONCAT(nxOutput_, __line__) != 1 && NX_LOG_ENABLED(LEVEL); \
+        ++NX_KIT_DEBUG_DETAIL_CONCAT(nxOutput_, __line__) \
+    )
+
+/**
+ * Only the debug and trace levels depend on NX_DEBUG_ENABLE_OUTPUT, so that the other levels can
+ * be used where it is not defined. Selected by the level number, hence the levels are literals.
+ */
+#define NX_KIT_DEBUG_DETAIL_LOG_LEVEL_OUTPUT_FLAG_0 (NX_DEBUG_ENABLE_OUTPUT)
+#define NX_KIT_DEBUG_DETAIL_LOG_LEVEL_OUTPUT_FLAG_1 (NX_DEBUG_ENABLE_OUTPUT)
+#define NX_KIT_DEBUG_DETAIL_LOG_LEVEL_OUTPUT_FLAG_2 true
+#define NX_KIT_DEBUG_DETAIL_LOG_LEVEL_OUTPUT_FLAG_3 true
+#define NX_KIT_DEBUG_DETAIL_LOG_LEVEL_OUTPUT_FLAG_4 true
+#define NX_KIT_DEBUG_DETAIL_LOG_LEVEL_OUTPUT_FLAG_5 true
+
+NX_KIT_API extern std::atomic<int> logLevel;
+
+inline bool isLogLevelEnabled(int level)
+{
+    return level >= logLevel.load(std::memory_order_relaxed);
+}
+
 /** @param file Supply __FILE__. */
 NX_KIT_API std::string printPrefix(const char* file);
 
@@ -298,6 +448,28 @@ private:
     Impl* const d;
 };
 
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyHistogram* histogram):
+        m_histogram(histogram), m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedLatency()
+    {
+        m_histogram->record(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start).count());
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram* const m_histogram;
+    const std::chrono::steady_clock::time_point m_start;
+};
+
 class NX_KIT_API Fps
 {
 public:
@@ -2,18 +2,43 @@
 
 #include "ini_config.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <fstream>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
 
 #include "utils.h"
 
+#if defined(_WIN32)
+    #define stat _stat64
+#endif
+
 namespace nx {
 namespace kit {
 
@@ -95,8 +120,12 @@ struct AbstractParam
     const std::string description;
     const IniConfig::ParamType type;
 
-    // For string params, the values are owned here; never cleaned up to guarantee char*.
-    std::vector<std::string> historicValues;
+    /**
+     * For string params, the values are owned here; never cleaned up to guarantee char*. A deque
+     * because, unlike a vector, it does not move the elements (and their short-string buffers)
+     * when growing.
+     */
+    std::deque<std::string> historicValues;
 
     AbstractParam(const char* name, const char* description, IniConfig::ParamType type):
         name(name), description(description), type(type)
@@ -173,19 +202,64 @@ struct Param: AbstractParam
     }
 };
 
+/**
+ * Stores the value into the param field with an atomic store, because the field may be read
+ * concurrently by other threads while the watcher thread reloads it. Release ordering also
+ * publishes the chars of a string value before the pointer to them.
+ */
+template<typename Value>
+static void storeAtomically(Value* field, Value value)
+{
+    #if defined(__GNUC__) || defined(__clang__)
+        __atomic_store(field, &value, __ATOMIC_RELEASE);
+    #elif defined(_MSC_VER)
+        static_assert(sizeof(Value) == 1 || sizeof(Value) == 4 || sizeof(Value) == 8,
+            "Unsupported param value size");
+        if (sizeof(Value) == 1)
+        {
+            char bits;
+            memcpy(&bits, &value, sizeof(bits));
+            _InterlockedExchange8(reinterpret_cast<volatile char*>(field), bits);
+        }
+        else if (sizeof(Value) == 4)
+        {
+            long bits;
+            memcpy(&bits, &value, sizeof(bits));
+            _InterlockedExchange(reinterpret_cast<volatile long*>(field), bits);
+        }
+        else
+        {
+            __int64 bits;
+            memcpy(&bits, &value, sizeof(bits));
+            _InterlockedExchange64(reinterpret_cast<volatile __int64*>(field), bits);
+        }
+    #else
+        *field = value;
+    #endif
+}
+
+/**
+ * The new value is composed aside and then stored into the field with a single atomic store, so
+ * that the threads reading the field concurrently never see an intermediate (e.g. default) value.
+ */
 template<typename Value>
 bool Param<Value>::reload(const std::string* value, std::ostream* output)
 {
-    const auto oldValue = *pValue;
-    *pValue = defaultValue;
+    const Value oldValue = *pValue;
+    Value newValue = defaultValue;
     const char* error = "";
     if (value && !value->empty()) //< Existing but empty values are treated as default.
     {
-        if (!nx::kit::utils::fromString(*value, pValue))
+        if (!nx::kit::utils::fromString(*value, &newValue))
+        {
+            newValue = defaultValue;
             error = " [invalid value in file]";
+        }
     }
-    printValueLine(output, *pValue, error, *pValue == defaultValue);
-    return oldValue != *pValue;
+    if (newValue != oldValue)
+        storeAtomically(pValue, newValue);
+    printValueLine(output, newValue, error, newValue == defaultValue);
+    return oldValue != newValue;
 }
 
 template<>
@@ -216,8 +290,7 @@ bool Param<const char*>::reload(const std::string* value, std::ostream* output)
 {
     const std::string oldValue = *pValue ? *pValue : "";
 
-    *pValue = defaultValue;
-
+    const char* newPtr = defaultValue;
     std::string error;
     if (value) //< Exists in .ini file, and can be empty: copy all chars to *pValue.
     {
@@ -232,8 +305,16 @@ bool Param<const char*>::reload(const std::string* value, std::ostream* output)
 
         if (error.empty())
         {
-            historicValues.push_back(str);
-            *pValue = historicValues.back().c_str();
+            // Reuse the stored copy, if any, to avoid growing historicValues on each reload.
+            if (str == oldValue && *pValue != defaultValue)
+            {
+                newPtr = *pValue;
+            }
+            else
+            {
+                historicValues.push_back(str);
+                newPtr = historicValues.back().c_str();
+            }
         }
         else
         {
@@ -242,12 +323,201 @@ bool Param<const char*>::reload(const std::string* value, std::ostream* output)
         }
     }
 
-    const std::string newValue{*pValue ? *pValue : ""};
+    if (newPtr != *pValue)
+        storeAtomically(pValue, newPtr);
+
+    const std::string newValue{newPtr ? newPtr : ""};
     printValueLine(output, newValue, error.empty() ? "" : " [invalid value in file]",
         newValue == (defaultValue ? defaultValue : ""));
     return oldValue != newValue;
 }
 
+//-------------------------------------------------------------------------------------------------
+// IniFileWatcher
+
+/**
+ * Calls the handler from a dedicated thread when the file is rewritten, replaced, or deleted. On
+ * Linux, the thread sleeps on inotify events for the directory, so nothing is done while the file
+ * stays intact. Elsewhere, or if the directory cannot be watched (e.g. it does not exist yet), the
+ * modification time and the size of the file are checked periodically.
+ */
+class IniFileWatcher
+{
+public:
+    IniFileWatcher(std::string dir, std::string file, std::function<void()> handler):
+        m_dir(dir.empty() ? "." : std::move(dir)),
+        m_file(std::move(file)),
+        m_handler(std::move(handler))
+    {
+        // Set up before starting the thread, to catch the changes made right after the start.
+        #if defined(__linux__)
+            m_stopEventFd = eventfd(0, EFD_CLOEXEC);
+            m_inotifyFd = createInotifyFd();
+        #endif
+        m_lastState = fileState();
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    ~IniFileWatcher()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeUp.notify_one();
+        #if defined(__linux__)
+            if (m_stopEventFd >= 0)
+            {
+                const uint64_t one = 1;
+                const ssize_t written = write(m_stopEventFd, &one, sizeof(one));
+                (void) written; //< Cannot fail for a non-overflowing eventfd counter.
+            }
+        #endif
+        m_thread.join();
+        #if defined(__linux__)
+            if (m_inotifyFd >= 0)
+                close(m_inotifyFd);
+            if (m_stopEventFd >= 0)
+                close(m_stopEventFd);
+        #endif
+    }
+
+private:
+    struct FileState
+    {
+        bool exists = false;
+        int64_t modificationTime = 0;
+        int64_t size = 0;
+
+        bool operator!=(const FileState& other) const
+        {
+            return exists != other.exists || modificationTime != other.modificationTime
+                || size != other.size;
+        }
+    };
+
+    FileState fileState() const
+    {
+        FileState result;
+        struct stat fileStat;
+        if (stat((m_dir + "/" + m_file).c_str(), &fileStat) == 0)
+        {
+            result.exists = true;
+            result.modificationTime = (int64_t) fileStat.st_mtime;
+            result.size = (int64_t) fileStat.st_size;
+        }
+        return result;
+    }
+
+    void run()
+    {
+        #if defined(__linux__)
+            if (runInotifyLoop())
+                return;
+        #endif
+        runPollingLoop();
+    }
+
+    void runPollingLoop()
+    {
+        static constexpr std::chrono::milliseconds kPollingPeriod{1000};
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_wakeUp.wait_for(lock, kPollingPeriod, [this]() { return m_stopping; }))
+        {
+            const FileState state = fileState();
+            if (state != m_lastState)
+            {
+                m_lastState = state;
+                lock.unlock();
+                m_handler();
+                lock.lock();
+            }
+        }
+    }
+
+    #if defined(__linux__)
+        /** @return The inotify descriptor watching the directory, or -1 if it cannot be watched. */
+        int createInotifyFd() const
+        {
+            if (m_stopEventFd < 0)
+                return -1;
+            const int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (inotifyFd < 0)
+                return -1;
+
+            // IN_CREATE is not watched: the file would be caught before it is written.
+            if (inotify_add_watch(inotifyFd, m_dir.c_str(),
+                IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0)
+            {
+                close(inotifyFd);
+                return -1;
+            }
+            return inotifyFd;
+        }
+
+        /** @return False if inotify cannot be used (any more), and the caller should poll. */
+        bool runInotifyLoop()
+        {
+            const int inotifyFd = m_inotifyFd;
+            if (inotifyFd < 0)
+                return false;
+
+            bool isStopped = false;
+            bool isWatchRemoved = false; //< E.g. the directory has been deleted.
+            while (!isStopped && !isWatchRemoved)
+            {
+                pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {m_stopEventFd, POLLIN, 0}};
+                if (poll(fds, 2, /*timeout*/ -1) < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    break;
+                }
+                isStopped = fds[1].revents != 0;
+
+                // Coalesce all pending events, e.g. those of an editor saving the file.
+                bool isFileChanged = false;
+                alignas(inotify_event) char buffer[4096];
+                ssize_t size;
+                while ((size = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+                {
+                    for (const char* p = buffer; p < buffer + size; )
+                    {
+                        const auto event = (const inotify_event*) p;
+                        if (event->mask & IN_IGNORED)
+                            isWatchRemoved = true;
+                        else if (event->len > 0 && m_file == event->name)
+                            isFileChanged = true;
+                        p += sizeof(inotify_event) + event->len;
+                    }
+                }
+                if (isFileChanged && !isStopped)
+                    m_handler();
+            }
+
+            if (isWatchRemoved)
+                m_lastState = fileState(); //< Let the polling continue from the current state.
+            return !isWatchRemoved;
+        }
+    #endif
+
+private:
+    const std::string m_dir;
+    const std::string m_file;
+    const std::function<void()> m_handler;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    bool m_stopping = false;
+    FileState m_lastState;
+    #if defined(__linux__)
+        int m_stopEventFd = -1;
+        int m_inotifyFd = -1;
+    #endif
+    std::thread m_thread;
+};
+
 } // namespace
 
 //-------------------------------------------------------------------------------------------------
@@ -297,6 +567,9 @@ public:
 
     void reload();
 
+    void startWatching(std::function<void()> onReloaded);
+    void stopWatching();
+
     bool getParamTypeAndValue(
         const char* paramName, ParamType* outType, const void** outData) const;
 
@@ -325,6 +598,10 @@ private:
     std::vector<std::unique_ptr<AbstractParam>> m_params;
     std::unordered_map<std::string, int> m_paramNameToIndex;
     std::string m_cachedIniFilePath; //< Initialized on first call to iniFilePath().
+
+    /** Declared last to stop the watcher thread before the rest of the fields are destroyed. */
+    std::mutex m_watcherMutex;
+    std::unique_ptr<IniFileWatcher> m_watcher;
 };
 
 template<typename Value>
@@ -428,14 +705,15 @@ void IniConfig::Impl::reload()
     if (!isEnabled())
         return;
 
+    // Locking before touching the state: reload() may be called both by the user and the watcher.
+    const std::lock_guard<std::mutex> lock(m_reloadMutex);
+
     const bool iniFileExists = nx::kit::utils::fileExists(iniFilePath());
     if (iniFileExists)
         m_iniFileEverExisted = true;
     if (!m_firstTimeReload && !m_iniFileEverExisted)
         return;
 
-    const std::lock_guard<std::mutex> lock(m_reloadMutex);
-
     std::ostringstream out;
     bool outputIsNeeded = m_firstTimeReload;
 
@@ -471,6 +749,34 @@ void IniConfig::Impl::reload()
         m_firstTimeReload = false;
 }
 
+void IniConfig::Impl::startWatching(std::function<void()> onReloaded)
+{
+    if (!isEnabled())
+        return;
+
+    const std::lock_guard<std::mutex> lock(m_watcherMutex);
+    if (!m_watcher)
+    {
+        m_watcher.reset(new IniFileWatcher(iniFilesDir(), iniFile,
+            [this, onReloaded]()
+            {
+                reload();
+                if (onReloaded)
+                    onReloaded();
+            }));
+    }
+}
+
+void IniConfig::Impl::stopWatching()
+{
+    std::unique_ptr<IniFileWatcher> watcher;
+    {
+        const std::lock_guard<std::mutex> lock(m_watcherMutex);
+        watcher = std::move(m_watcher);
+    }
+    // The watcher is destroyed (and its thread is joined) here, outside of the lock.
+}
+
 bool IniConfig::Impl::getParamTypeAndValue(
     const char* paramName, ParamType* outType, const void** outData) const
 {
@@ -584,6 +890,16 @@ void IniConfig::reload()
     return d->reload();
 }
 
+void IniConfig::startWatching(std::function<void()> onReloaded)
+{
+    d->startWatching(std::move(onReloaded));
+}
+
+void IniConfig::stopWatching()
+{
+    d->stopWatching();
+}
+
 bool IniConfig::getParamTypeAndValue(
     const char* paramName, ParamType* outType, const void** outData) const
 {
@@ -66,7 +66,8 @@ namespace kit {
  * </code></pre>
  *
  * In the code, use ini().<param-name> to access the values. Call ini().reload() when needed, e.g.
- * when certain activity starts or at regular intervals.
+ * when certain activity starts or at regular intervals, or call ini().startWatching() to reload
+ * the values automatically when the .ini file changes.
  *
  * NOTE: The function that owns an IniConfig instance can be placed in the header file as 'inline',
  * but it is safe only when the header is local to a single dynamic library or executable.
@@ -123,11 +124,37 @@ public:
      * Reload values from .ini file, logging the values first time, or if changed.
      *
      * Can be called from any thread. Creates a fence, so the values in the fields are available to
-     * other threads immediately after reloading finishes. The fields themselves, though not
-     * declared atomic, are 32-bit values and thus will always be updated atomically.
+     * other threads immediately after reloading finishes. Each field receives its new value with a
+     * single atomic store (on GCC, Clang and MSVC), never passing through the default value.
+     *
+     * ATTENTION: The fields are plain members, and the code using them reads them with plain
+     * loads. While reload() may run concurrently, e.g. with startWatching(), such a read is a data
+     * race by the letter of the C++ memory model, though in practice each field is read whole on
+     * the supported compilers and platforms. Code which needs a guarantee should read the value
+     * once per use and must not rely on several fields changing together.
      */
     void reload();
 
+    /**
+     * Starts a thread which calls reload() each time the .ini file is rewritten, replaced, or
+     * deleted, so that the values can be changed without restarting the process. On Linux, the
+     * thread uses inotify on iniFilesDir() and does nothing while the file stays intact; on other
+     * platforms, or if iniFilesDir() does not exist, the file is checked once a second. Does
+     * nothing if already started, or if reading .ini files is disabled.
+     *
+     * NOTE: Only the code which reads the field on each use sees the new value; the values copied
+     * at startup are not affected unless re-applied by onReloaded.
+     *
+     * @param onReloaded If not null, is called from the watcher thread after each such reload.
+     */
+    void startWatching(std::function<void()> onReloaded = nullptr);
+
+    /**
+     * Stops the thread started by startWatching(), if any; also done by the destructor. Must be
+     * called before unloading the library which owns this instance.
+     */
+    void stopWatching();
+
     class Tweaks;
 
     enum class ParamType
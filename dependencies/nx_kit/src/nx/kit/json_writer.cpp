@@ -0,0 +1,363 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "json_writer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <locale>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define NX_KIT_JSON_WRITER_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace nx {
+namespace kit {
+
+namespace {
+
+/**
+ * Chars which may need escaping: '"', '\\', control chars, and 0xE2 which starts the UTF-8 of
+ * U+2028 and U+2029, escaped by Json::dump() for the sake of JavaScript.
+ */
+static bool mayNeedEscaping(char c)
+{
+    const uint8_t u = static_cast<uint8_t>(c);
+    return u <= 0x1f || c == '"' || c == '\\' || u == 0xe2;
+}
+
+static int lowestBitIndex(unsigned int mask)
+{
+    #if defined(__GNUC__)
+        return __builtin_ctz(mask);
+    #else
+        int index = 0;
+        while ((mask & 1) == 0)
+        {
+            mask >>= 1;
+            ++index;
+        }
+        return index;
+    #endif
+}
+
+/** @return Index of the first char which may need escaping, or `size` if there are none. */
+static size_t findCharToEscape(const char* data, size_t size, size_t from)
+{
+    size_t i = from;
+
+    #if defined(NX_KIT_JSON_WRITER_SSE2)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i utf8Lead = _mm_set1_epi8(static_cast<char>(0xe2));
+        const __m128i maxControl = _mm_set1_epi8(0x1f);
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(chunk, maxControl), chunk);
+            const __m128i matches = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, utf8Lead), isControl));
+            const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(matches));
+            if (mask != 0)
+                return i + lowestBitIndex(mask);
+        }
+    #else
+        // SWAR: test 8 chars at a time, then find the exact position char by char.
+        static const uint64_t kOnes = 0x0101010101010101ULL;
+        static const uint64_t kHighBits = 0x8080808080808080ULL;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t chunk;
+            memcpy(&chunk, data + i, sizeof(chunk));
+            const uint64_t quotes = chunk ^ (kOnes * '"');
+            const uint64_t backslashes = chunk ^ (kOnes * '\\');
+            const uint64_t utf8Leads = chunk ^ (kOnes * 0xe2);
+            const uint64_t found =
+                (((chunk - kOnes * 0x20) & ~chunk)
+                | ((quotes - kOnes) & ~quotes)
+                | ((backslashes - kOnes) & ~backslashes)
+                | ((utf8Leads - kOnes) & ~utf8Leads)) & kHighBits;
+            if (found != 0)
+                break;
+        }
+    #endif
+
+    for (; i < size; ++i)
+    {
+        if (mayNeedEscaping(data[i]))
+            return i;
+    }
+    return size;
+}
+
+static void appendNumber(double value, std::string* out)
+{
+    // The same formatting as in Json::dump(): integers stored as doubles look like integers.
+    if (!std::isfinite(value))
+    {
+        *out += "null";
+        return;
+    }
+
+    std::ostringstream stream;
+    stream.precision(17);
+    stream.imbue(std::locale("C")); //< Always use a decimal point instead of comma.
+    stream << value;
+    *out += stream.str();
+}
+
+static void appendNumber(int value, std::string* out)
+{
+    char buf[16];
+    char* p = buf + sizeof(buf);
+    // Negate via unsigned arithmetic to support INT_MIN.
+    unsigned int magnitude = value < 0 ? 0U - static_cast<unsigned int>(value)
+        : static_cast<unsigned int>(value);
+    do
+    {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+        *--p = '-';
+    out->append(p, static_cast<size_t>(buf + sizeof(buf) - p));
+}
+
+static bool isInt(double value)
+{
+    return value >= -2147483648.0 && value <= 2147483647.0
+        && value == static_cast<double>(static_cast<int>(value))
+        && !(value == 0 && std::signbit(value)); //< Json::dump() keeps "-0".
+}
+
+} // namespace
+
+JsonWriter::JsonWriter()
+{
+}
+
+JsonWriter::JsonWriter(std::ostream* stream, size_t flushThreshold):
+    m_stream(stream), m_flushThreshold(flushThreshold)
+{
+    m_buffer.reserve(flushThreshold);
+}
+
+JsonWriter::~JsonWriter()
+{
+    flush();
+}
+
+void JsonWriter::clear()
+{
+    m_buffer.clear();
+    m_hasItems.clear();
+    m_afterKey = false;
+}
+
+std::string JsonWriter::takeBuffer()
+{
+    std::string result;
+    result.swap(m_buffer);
+    m_hasItems.clear();
+    m_afterKey = false;
+    return result;
+}
+
+void JsonWriter::flush()
+{
+    if (!m_stream || m_buffer.empty())
+        return;
+    m_stream->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+void JsonWriter::beforeValue()
+{
+    if (m_afterKey)
+    {
+        m_afterKey = false;
+        return;
+    }
+    if (m_hasItems.empty())
+        return;
+    if (m_hasItems.back())
+        m_buffer += ", ";
+    else
+        m_hasItems.back() = true;
+}
+
+void JsonWriter::afterValue()
+{
+    if (m_stream && m_buffer.size() >= m_flushThreshold)
+        flush();
+}
+
+JsonWriter& JsonWriter::beginObject()
+{
+    beforeValue();
+    m_buffer += '{';
+    m_hasItems.push_back(false);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject()
+{
+    m_hasItems.pop_back();
+    m_buffer += '}';
+    afterValue();
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray()
+{
+    beforeValue();
+    m_buffer += '[';
+    m_hasItems.push_back(false);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray()
+{
+    m_hasItems.pop_back();
+    m_buffer += ']';
+    afterValue();
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* data, size_t size)
+{
+    beforeValue();
+    appendEscapedString(data, size, &m_buffer);
+    m_buffer += ": ";
+    m_afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::null()
+{
+    beforeValue();
+    m_buffer += "null";
+    afterValue();
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool b)
+{
+    beforeValue();
+    m_buffer += b ? "true" : "false";
+    afterValue();
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(int i)
+{
+    beforeValue();
+    appendNumber(i, &m_buffer);
+    afterValue();
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double d)
+{
+    beforeValue();
+    if (isInt(d))
+        appendNumber(static_cast<int>(d), &m_buffer);
+    else
+        appendNumber(d, &m_buffer);
+    afterValue();
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* data, size_t size)
+{
+    beforeValue();
+    appendEscapedString(data, size, &m_buffer);
+    afterValue();
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const Json& json)
+{
+    switch (json.type())
+    {
+        case Json::NUMBER:
+            return value(json.number_value());
+        case Json::BOOL:
+            return value(json.bool_value());
+        case Json::STRING:
+            return value(json.string_value());
+        case Json::ARRAY:
+            beginArray();
+            for (const Json& item: json.array_items())
+                value(item);
+            return endArray();
+        case Json::OBJECT:
+            beginObject();
+            for (const auto& member: json.object_items())
+                key(member.first).value(member.second);
+            return endObject();
+        default:
+            return null();
+    }
+}
+
+JsonWriter& JsonWriter::value(const std::map<std::string, std::string>& map)
+{
+    beginObject();
+    for (const auto& item: map)
+        key(item.first).value(item.second);
+    return endObject();
+}
+
+void JsonWriter::appendEscapedString(const char* data, size_t size, std::string* out)
+{
+    *out += '"';
+    size_t runStart = 0;
+    for (size_t i = findCharToEscape(data, size, 0); i < size;
+        i = findCharToEscape(data, size, i))
+    {
+        out->append(data + runStart, i - runStart);
+
+        const char ch = data[i];
+        const uint8_t u = static_cast<uint8_t>(ch);
+        ++i;
+        switch (ch)
+        {
+            case '\\': *out += "\\\\"; break;
+            case '"': *out += "\\\""; break;
+            case '\b': *out += "\\b"; break;
+            case '\f': *out += "\\f"; break;
+            case '\n': *out += "\\n"; break;
+            case '\r': *out += "\\r"; break;
+            case '\t': *out += "\\t"; break;
+            default:
+                if (u <= 0x1f)
+                {
+                    static const char kHexDigits[] = "0123456789abcdef";
+                    const char escape[] = {'\\', 'u', '0', '0', kHexDigits[u >> 4], kHexDigits[u & 0xf]};
+                    out->append(escape, sizeof(escape));
+                }
+                else if (i + 2 <= size && static_cast<uint8_t>(data[i]) == 0x80
+                    && (static_cast<uint8_t>(data[i + 1]) == 0xa8
+                        || static_cast<uint8_t>(data[i + 1]) == 0xa9))
+                {
+                    *out += (static_cast<uint8_t>(data[i + 1]) == 0xa8) ? "\\u2028" : "\\u2029";
+                    i += 2;
+                }
+                else
+                {
+                    *out += ch; //< 0xE2 not starting U+2028 or U+2029.
+                }
+        }
+        runStart = i;
+    }
+    out->append(data + runStart, size - runStart);
+    *out += '"';
+}
+
+} // namespace kit
+} // namespace nx
@@ -0,0 +1,136 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+/**@file
+ * Streaming JSON serialization, producing the same text as nx::kit::Json::dump() without building
+ * a Json tree and without growing a fresh std::string for every value.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "json.h"
+
+#if !defined(NX_KIT_API)
+    #define NX_KIT_API /*empty*/
+#endif
+
+namespace nx {
+namespace kit {
+
+/**
+ * Writes JSON text into its buffer, which can be reused for the next document via clear(), or
+ * into an std::ostream. The separators (", " between items, ": " after keys) are inserted
+ * automatically, so the output is byte-for-byte the same as Json::dump() of the equivalent value.
+ *
+ * The caller is responsible for the structure: each beginObject()/beginArray() must be matched by
+ * endObject()/endArray(), and each value inside an object must be preceded by key().
+ *
+ * Usage:
+ * ```
+ *     JsonWriter writer;
+ *     writer.reserve(4096);
+ *     writer.beginObject().key("type").value("Settings").key("items").value(itemsJson);
+ *     writer.endObject();
+ *     send(writer.buffer());
+ * ```
+ */
+class NX_KIT_API JsonWriter
+{
+public:
+    /** Writes into the internal buffer; see buffer(). */
+    JsonWriter();
+
+    /**
+     * Writes into the stream; the text is collected in the internal buffer and written to the
+     * stream when the buffer exceeds flushThreshold, on flush(), and on destruction.
+     */
+    explicit JsonWriter(std::ostream* stream, size_t flushThreshold = 4096);
+
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    void reserve(size_t capacity) { m_buffer.reserve(capacity); }
+
+    /** Forgets the written text and the nesting state, keeping the buffer capacity. */
+    void clear();
+
+    /** Text written so far and not yet flushed to the stream. */
+    const std::string& buffer() const { return m_buffer; }
+
+    /** Moves out the written text; the writer starts a new document with an empty buffer. */
+    std::string takeBuffer();
+
+    void flush();
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    JsonWriter& key(const char* data, size_t size);
+    JsonWriter& key(const std::string& s) { return key(s.data(), s.size()); }
+    JsonWriter& key(const char* s) { return key(s, strlen(s)); }
+
+    JsonWriter& null();
+    JsonWriter& value(bool b);
+    JsonWriter& value(int i);
+    JsonWriter& value(double d);
+    JsonWriter& value(const char* data, size_t size);
+    JsonWriter& value(const std::string& s) { return value(s.data(), s.size()); }
+    JsonWriter& value(const char* s) { return value(s, strlen(s)); }
+
+    /** Serializes the whole value, the same way as Json::dump(). */
+    JsonWriter& value(const Json& json);
+
+    /** Writes the map as a JSON object of strings. */
+    JsonWriter& value(const std::map<std::string, std::string>& map);
+
+    /**
+     * Writes a JSON object of strings from any map-like class with `int count()`, and
+     * `const char* key(int)` and `const char* value(int)`, like nx::sdk::IStringMap. Null keys
+     * are skipped; null values are written as empty strings.
+     */
+    template<class StringMap>
+    JsonWriter& stringMapObject(const StringMap& map)
+    {
+        beginObject();
+        const int count = map.count();
+        for (int i = 0; i < count; ++i)
+        {
+            const char* const itemKey = map.key(i);
+            if (!itemKey)
+                continue;
+            const char* const itemValue = map.value(i);
+            key(itemKey);
+            value(itemValue ? itemValue : "");
+        }
+        return endObject();
+    }
+
+    /** Appends the string enquoted and escaped the same way as Json::dump(). */
+    static void appendEscapedString(const char* data, size_t size, std::string* out);
+
+private:
+    void beforeValue();
+    void afterValue();
+
+private:
+    std::ostream* const m_stream = nullptr;
+    const size_t m_flushThreshold = 0;
+    std::string m_buffer;
+
+    /** Per open object or array: whether it already has items, so the next one needs ", ". */
+    std::vector<bool> m_hasItems;
+    bool m_afterKey = false;
+};
+
+} // namespace kit
+} // namespace nx
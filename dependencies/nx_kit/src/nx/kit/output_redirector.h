@@ -22,6 +22,8 @@ namespace kit {
  *
  * If such a file exists, the respective stream will be appended to the file contents.
  *
+ * The size of these files can be limited with OutputRotation.
+ *
  * Redirection is performed during static initialization, thus, to ensure that it occurs before any
  * other output, this library should be the first in the list of linked libraries of the
  * executable. Note that in Windows due to some MSVC C++ Runtime issues, if any output occurs
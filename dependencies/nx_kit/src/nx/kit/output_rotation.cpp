@@ -0,0 +1,212 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "output_rotation.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(NX_KIT_WITH_ZLIB)
+    #include <zlib.h>
+#endif
+
+#include "ini_config.h"
+#include "utils.h"
+
+#if defined(_WIN32)
+    #pragma warning(disable: 4996) //< MSVC: freopen() is unsafe.
+    #define fileno _fileno
+    #define stat _stat64
+    #define fstat _fstat64
+#endif
+
+namespace nx {
+namespace kit {
+
+static bool isStreamWritingTo(FILE* stream, const std::string& filename, int64_t* outFileSize)
+{
+    struct stat fileStat;
+    if (stat(filename.c_str(), &fileStat) != 0)
+        return false;
+    *outFileSize = (int64_t) fileStat.st_size;
+
+    #if defined(_WIN32)
+        // Windows has no inode numbers to compare: trust the caller.
+        (void) stream;
+        return true;
+    #else
+        struct stat streamStat;
+        return fstat(fileno(stream), &streamStat) == 0
+            && streamStat.st_dev == fileStat.st_dev && streamStat.st_ino == fileStat.st_ino;
+    #endif
+}
+
+static bool gzipFile(const std::string& sourceFilename, const std::string& targetFilename)
+{
+    #if defined(NX_KIT_WITH_ZLIB)
+        std::ifstream source(sourceFilename, std::ios::binary);
+        const gzFile target = gzopen(targetFilename.c_str(), "wb");
+        if (!source.good() || !target)
+        {
+            if (target)
+                gzclose(target);
+            return false;
+        }
+
+        std::vector<char> buffer(64 * 1024);
+        bool success = true;
+        while (success && source)
+        {
+            source.read(buffer.data(), (std::streamsize) buffer.size());
+            const int size = (int) source.gcount();
+            if (size > 0)
+                success = gzwrite(target, buffer.data(), (unsigned int) size) == size;
+        }
+        success = (gzclose(target) == Z_OK) && success;
+        if (!success)
+            remove(targetFilename.c_str());
+        return success;
+    #else
+        (void) sourceFilename;
+        (void) targetFilename;
+        return false;
+    #endif
+}
+
+bool OutputRotation::isCompressionSupported(Compression compression)
+{
+    switch (compression)
+    {
+        case Compression::none:
+            return true;
+        case Compression::gzip:
+            #if defined(NX_KIT_WITH_ZLIB)
+                return true;
+            #else
+                return false;
+            #endif
+    }
+    return false;
+}
+
+bool OutputRotation::rotateIfNeeded(
+    FILE* stream, const std::string& filename, const Options& options)
+{
+    int64_t fileSize = 0;
+    if (!isStreamWritingTo(stream, filename, &fileSize) || fileSize <= options.maxFileSize)
+        return false;
+
+    const bool compress = options.compression != Compression::none
+        && isCompressionSupported(options.compression);
+    const auto rotatedFilename =
+        [&](int index)
+        {
+            return filename + "." + utils::toString(index) + (compress ? ".gz" : "");
+        };
+
+    // Shift the older files, dropping the oldest one; missing files are skipped.
+    remove(rotatedFilename(options.keptFileCount).c_str());
+    for (int i = options.keptFileCount - 1; i >= 1; --i)
+        rename(rotatedFilename(i).c_str(), rotatedFilename(i + 1).c_str());
+
+    const std::string justRotatedFilename = filename + ".1";
+    remove(justRotatedFilename.c_str()); //< A leftover of a failed compression, if any.
+
+    fflush(stream);
+    #if defined(_WIN32)
+        // An open file cannot be renamed: detach the stream for the time of renaming.
+        if (!freopen("NUL", "w", stream))
+            return false;
+    #endif
+    // On other platforms, the stream keeps writing to the renamed file until reopened.
+    const bool renamed = rename(filename.c_str(), justRotatedFilename.c_str()) == 0;
+    if (!freopen(filename.c_str(), renamed ? "w" : "a", stream))
+        return false;
+    if (!renamed)
+        return false;
+
+    if (options.keptFileCount <= 0)
+        remove(justRotatedFilename.c_str());
+    else if (compress && gzipFile(justRotatedFilename, rotatedFilename(1)))
+        remove(justRotatedFilename.c_str());
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+namespace {
+
+class RotationThread
+{
+public:
+    RotationThread(const OutputRotation::Options& options): m_options(options)
+    {
+        const std::string logFilesDir = nx::kit::IniConfig::iniFilesDir();
+        const std::string processName = nx::kit::utils::getProcessName();
+        m_stdoutFilename = logFilesDir + processName + "_stdout.log";
+        m_stderrFilename = logFilesDir + processName + "_stderr.log";
+
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    ~RotationThread()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeUp.notify_one();
+        m_thread.join();
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stopping)
+        {
+            OutputRotation::rotateIfNeeded(stdout, m_stdoutFilename, m_options);
+            OutputRotation::rotateIfNeeded(stderr, m_stderrFilename, m_options);
+            m_wakeUp.wait_for(lock, std::chrono::milliseconds(m_options.checkPeriodMs),
+                [this]() { return m_stopping; });
+        }
+    }
+
+private:
+    const OutputRotation::Options m_options;
+    std::string m_stdoutFilename;
+    std::string m_stderrFilename;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    bool m_stopping = false;
+    std::thread m_thread;
+};
+
+static std::mutex rotationThreadMutex;
+static RotationThread* rotationThread = nullptr;
+
+} // namespace
+
+void OutputRotation::start(const Options& options)
+{
+    const std::lock_guard<std::mutex> lock(rotationThreadMutex);
+    if (!rotationThread)
+        rotationThread = new RotationThread(options);
+}
+
+void OutputRotation::stop()
+{
+    const std::lock_guard<std::mutex> lock(rotationThreadMutex);
+    delete rotationThread;
+    rotationThread = nullptr;
+}
+
+} // namespace kit
+} // namespace nx
@@ -0,0 +1,76 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#if !defined(NX_KIT_API)
+    #define NX_KIT_API
+#endif
+
+namespace nx {
+namespace kit {
+
+/**
+ * Size-based rotation of the files which stdout and stderr are redirected to by OutputRedirector,
+ * so that the log of a long-running process takes a bounded amount of disk space.
+ *
+ * When a file exceeds the maximum size, it is renamed to `<name>.1` (the older rotated files are
+ * shifted to `<name>.2` and so on, keeping a limited number of them), and the stream continues
+ * writing to a new file with the original name. Rotated files can be compressed with gzip if
+ * nx_kit is built with zlib (the nxKitWithZlib CMake option).
+ *
+ * This unit intentionally does not depend on OutputRedirector: the redirection may have been
+ * performed by another copy of nx_kit in the process (e.g. the one in the executable which loads
+ * a plugin), and using OutputRedirector here would redirect the output once again.
+ */
+class NX_KIT_API OutputRotation
+{
+public:
+    enum class Compression
+    {
+        none,
+        gzip,
+    };
+
+    struct Options
+    {
+        /** A file bigger than this is rotated. */
+        int64_t maxFileSize = 32 * 1024 * 1024;
+
+        /** How many rotated files to keep, besides the one being written. */
+        int keptFileCount = 3;
+
+        /** Falls back to no compression if not supported; see isCompressionSupported(). */
+        Compression compression = Compression::none;
+
+        /** How often the file sizes are checked, thus, how much a file can overgrow the limit. */
+        int checkPeriodMs = 10 * 1000;
+    };
+
+    /**
+     * Starts a thread which periodically rotates `<process-name>_stdout.log` and
+     * `<process-name>_stderr.log` in nx::kit::IniConfig::iniFilesDir(), if stdout and stderr,
+     * respectively, are redirected to them. Does nothing if already started.
+     */
+    static void start(const Options& options);
+
+    /** Stops the thread; must be called before unloading the library which has called start(). */
+    static void stop();
+
+    static bool isCompressionSupported(Compression compression);
+
+    /**
+     * If the stream is writing to the file, and the file is bigger than options.maxFileSize,
+     * rotates the file and reopens the stream to a new file with the same name.
+     * @return Whether the rotation has been performed.
+     */
+    static bool rotateIfNeeded(FILE* stream, const std::string& filename, const Options& options);
+
+    OutputRotation() = delete;
+};
+
+} // namespace kit
+} // namespace nx
@@ -2,13 +2,17 @@
 
 #include "test.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <ctime>
 #include <cstdio>
 #include <cstdarg>
 #include <cstring>
 #include <cstdlib>
+#include <map>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 #include <fstream>
 #include <memory>
@@ -172,6 +176,10 @@ struct ParsedCmdLineArgs
     bool showHelp = false;
     std::string explicitBaseTempDir;
     bool stopOnFirstFailure = false;
+    bool runBenchmarks = false;
+    std::string benchmarkJsonFile;
+    std::string benchmarkBaselineFile;
+    double benchmarkTolerancePercent = 10;
 };
 
 static const ParsedCmdLineArgs& parsedCmdLineArgs()
@@ -190,6 +198,17 @@ static const ParsedCmdLineArgs& parsedCmdLineArgs()
 
     const auto arg = [&args](int i) { return ((int) args.size() <= i) ? "" : args[i]; };
 
+    /** @return Whether the arg is `<option><value>`, where the option includes the '='. */
+    const auto optionValue =
+        [](const std::string& arg, const std::string& option, std::string* outValue)
+        {
+            if (arg.compare(0, option.size(), option) != 0) //< starts with
+                return false;
+            *outValue = arg.substr(option.size());
+            return true;
+        };
+    std::string value;
+
     if (args.size() == 2 && (arg(1) == "-h" || arg(1) == "--help"))
     {
         parsedArgs->showHelp = true;
@@ -218,6 +237,22 @@ static const ParsedCmdLineArgs& parsedCmdLineArgs()
         {
             parsedArgs->stopOnFirstFailure = true;
         }
+        else if (arg(i) == "--benchmark")
+        {
+            parsedArgs->runBenchmarks = true;
+        }
+        else if (optionValue(arg(i), "--benchmark-json=", &parsedArgs->benchmarkJsonFile)
+            || optionValue(arg(i), "--benchmark-baseline=", &parsedArgs->benchmarkBaselineFile))
+        {
+        }
+        else if (optionValue(arg(i), "--benchmark-tolerance=", &value))
+        {
+            if (!nx::kit::utils::fromString(value, &parsedArgs->benchmarkTolerancePercent)
+                || parsedArgs->benchmarkTolerancePercent < 0)
+            {
+                fatalError("Invalid command line args: bad --benchmark-tolerance; run with --help.");
+            }
+        }
         else
         {
             fatalError("Unknown command line arg %s; run with --help.",
@@ -228,6 +263,131 @@ static const ParsedCmdLineArgs& parsedCmdLineArgs()
     return *parsedArgs;
 }
 
+//-------------------------------------------------------------------------------------------------
+// Benchmark utils.
+
+namespace {
+
+struct BenchmarkResult
+{
+    std::string name;
+    double medianNs;
+    double madNs;
+    int64_t iterationCount; //< Per sample.
+    int sampleCount;
+};
+
+} // namespace
+
+static std::vector<BenchmarkResult>& benchmarkResults()
+{
+    static std::vector<BenchmarkResult> benchmarkResults;
+    return benchmarkResults;
+}
+
+static double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    const size_t size = values.size();
+    return (size % 2 != 0) ? values[size / 2] : (values[size / 2 - 1] + values[size / 2]) / 2;
+}
+
+static std::string durationStr(double ns)
+{
+    if (ns < 1000)
+        return nx::kit::utils::format("%.2f ns", ns);
+    if (ns < 1000 * 1000)
+        return nx::kit::utils::format("%.2f us", ns / 1000);
+    return nx::kit::utils::format("%.2f ms", ns / (1000 * 1000));
+}
+
+/** Each result is written on a separate line, to be read back by readBenchmarkBaseline(). */
+static void writeBenchmarkJson(const std::string& filename)
+{
+    std::ofstream file(filename);
+    file << "{\n    \"benchmarks\": [\n";
+    const auto& results = benchmarkResults();
+    for (int i = 0; i < (int) results.size(); ++i)
+    {
+        const auto& result = results[i];
+        file << "        {\"name\": " << nx::kit::utils::toString(result.name)
+            << ", \"medianNs\": " << nx::kit::utils::format("%.3f", result.medianNs)
+            << ", \"madNs\": " << nx::kit::utils::format("%.3f", result.madNs)
+            << ", \"iterations\": " << result.iterationCount
+            << ", \"samples\": " << result.sampleCount
+            << "}" << ((i + 1 < (int) results.size()) ? "," : "") << "\n";
+    }
+    file << "    ]\n}\n";
+
+    if (!file)
+        fatalError("Unable to write benchmark results to %s", filename.c_str());
+    printNote("Saved %d benchmark result(s) to %s", (int) results.size(), filename.c_str());
+}
+
+/** @return Median time per iteration by the benchmark name. */
+static std::map<std::string, double> readBenchmarkBaseline(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file)
+        fatalError("Unable to read benchmark baseline from %s", filename.c_str());
+
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        static const std::string kNamePrefix = "{\"name\": \"";
+        static const std::string kMedianPrefix = "\"medianNs\": ";
+
+        const size_t nameStart = line.find(kNamePrefix);
+        const size_t medianStart = line.find(kMedianPrefix);
+        if (nameStart == std::string::npos || medianStart == std::string::npos)
+            continue;
+
+        // Find the closing quote of the name, skipping the escaped chars.
+        const size_t literalStart = nameStart + kNamePrefix.size() - 1; //< Opening quote.
+        size_t literalEnd = literalStart + 1;
+        while (literalEnd < line.size() && line[literalEnd] != '"')
+            literalEnd += (line[literalEnd] == '\\') ? 2 : 1;
+
+        const std::string name = nx::kit::utils::decodeEscapedString(
+            line.substr(literalStart, literalEnd + 1 - literalStart));
+        baseline[name] = strtod(line.c_str() + medianStart + kMedianPrefix.size(), nullptr);
+    }
+    return baseline;
+}
+
+static const std::map<std::string, double>& benchmarkBaseline()
+{
+    static std::unique_ptr<std::map<std::string, double>> baseline;
+    if (!baseline)
+    {
+        const std::string& filename = parsedCmdLineArgs().benchmarkBaselineFile;
+        baseline.reset(new std::map<std::string, double>(filename.empty()
+            ? std::map<std::string, double>()
+            : readBenchmarkBaseline(filename)));
+    }
+    return *baseline;
+}
+
+TestFunc benchmarkTestFunc(const char* name, void (*benchmarkFunc)(Benchmark&))
+{
+    return
+        [name, benchmarkFunc]()
+        {
+            Benchmark benchmark(name);
+            benchmarkFunc(benchmark);
+            benchmark.assertNoRegressions();
+        };
+}
+
+static const void* volatile valueSink = nullptr;
+
+void useValue(const void* value)
+{
+    valueSink = value;
+}
+
+
 /** NOTE: The trailing '\n' in a string (if any) is treated as an empty line. */
 static std::vector<std::string> splitMultilineText(const std::string& text)
 {
@@ -341,6 +501,91 @@ void assertMultilineTextEquals(
         "The text in test case \"" + testCaseTag + "\" is not as expected; see details above.");
 }
 
+//-------------------------------------------------------------------------------------------------
+// Benchmark.
+
+void Benchmark::runBatches(
+    const std::string& variant, const std::function<double(int64_t)>& measureBatch)
+{
+    const bool isMeasuring = parsedCmdLineArgs().runBenchmarks;
+    const double sampleNs = isMeasuring ? 10e6 : 1e6;
+    const double warmUpNs = isMeasuring ? 100e6 : 0;
+    const int sampleCount = isMeasuring ? 15 : 1;
+    static constexpr int64_t kMaxIterationCount = 1000 * 1000 * 1000;
+
+    const std::string name = variant.empty() ? m_name : (m_name + "/" + variant);
+
+    // Calibrate, warming up at the same time: grow the batch until it takes a sample duration.
+    int64_t iterationCount = 1;
+    double totalNs = 0;
+    for (;;)
+    {
+        const double elapsedNs = std::max(1.0, measureBatch(iterationCount));
+        totalNs += elapsedNs;
+        if (elapsedNs >= sampleNs)
+        {
+            if (totalNs >= warmUpNs)
+                break;
+            continue; //< Keep warming up with the same batch size.
+        }
+        if (iterationCount >= kMaxIterationCount)
+            break;
+
+        // Aim slightly above the sample duration, but do not grow too fast on a noisy start.
+        const double factor = std::min(10.0, 1.2 * sampleNs / elapsedNs);
+        iterationCount = std::min(kMaxIterationCount,
+            std::max(iterationCount + 1, (int64_t) ((double) iterationCount * factor)));
+    }
+
+    std::vector<double> nsPerIteration;
+    for (int i = 0; i < sampleCount; ++i)
+        nsPerIteration.push_back(measureBatch(iterationCount) / (double) iterationCount);
+    const double medianNs = median(nsPerIteration);
+    std::vector<double> deviations;
+    for (const double ns: nsPerIteration)
+        deviations.push_back(std::fabs(ns - medianNs));
+    const double madNs = median(deviations);
+
+    benchmarkResults().push_back({name, medianNs, madNs, iterationCount, sampleCount});
+
+    std::ostringstream report;
+    report << "BENCHMARK " << name << ": " << durationStr(medianNs) << " per iteration";
+    if (!isMeasuring)
+    {
+        report << " (a single short sample; run with --benchmark to measure)";
+    }
+    else
+    {
+        report << " (MAD " << durationStr(madNs) << ", " << sampleCount << " samples of "
+            << iterationCount << " iterations)";
+
+        const auto baseline = benchmarkBaseline().find(name);
+        if (baseline != benchmarkBaseline().end() && baseline->second > 0)
+        {
+            const double changePercent = (medianNs / baseline->second - 1) * 100;
+            report << "; baseline " << durationStr(baseline->second) << ", "
+                << nx::kit::utils::format("%+.1f%%", changePercent);
+            if (changePercent > parsedCmdLineArgs().benchmarkTolerancePercent)
+            {
+                report << " REGRESSION";
+                m_regressions += "\n    " + name + ": " + durationStr(medianNs)
+                    + " instead of " + durationStr(baseline->second);
+            }
+        }
+    }
+    std::cerr << report.str() << std::endl;
+}
+
+void Benchmark::assertNoRegressions() const
+{
+    if (!m_regressions.empty())
+    {
+        throw std::runtime_error(nx::kit::utils::format(
+            "Slower than the baseline by more than %g%%:",
+            parsedCmdLineArgs().benchmarkTolerancePercent) + m_regressions);
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 // Temp dir.
 
@@ -458,6 +703,19 @@ Usage:
 
   --tmp[=]<temp-dir>
     Use <temp-dir> for temp files instead of a random dir in the system temp dir.
+
+  --benchmark
+    Run only the benchmarks, measuring them (otherwise, they are run briefly with the tests).
+
+  --benchmark-json=<file>
+    Save the benchmark results to <file>.
+
+  --benchmark-baseline=<file>
+    Compare the benchmark results with <file> saved by --benchmark-json in an earlier run, and
+    fail the benchmarks which have become slower by more than the tolerance.
+
+  --benchmark-tolerance=<percent>
+    Tolerance for --benchmark-baseline; the default is 10.
 )" + specificArgsSection;
 }
 
@@ -547,12 +805,19 @@ int runAllTests(const char *testSuiteName, const char* specificArgsHelp)
     const std::string fullSuiteName =
         std::string("suite ") + testSuiteName + " [" + suiteId() + "]";
 
+    // With --benchmark, only the benchmarks are run.
+    const auto isSelected =
+        [](const Test& test) { return !parsedCmdLineArgs().runBenchmarks || test.isBenchmark; };
+    const int testCount = (int) std::count_if(allTests().begin(), allTests().end(), isSelected);
+
     std::cerr << std::endl
-        << "Running " << allTests().size() << " test(s) from " << fullSuiteName << std::endl;
+        << "Running " << testCount << " test(s) from " << fullSuiteName << std::endl;
 
     std::vector<int> failedTests;
     for (int i = 1; i <= (int) allTests().size(); ++i)
     {
+        if (!isSelected(allTests()[i - 1]))
+            continue;
         if (!runTest(allTests()[i - 1], i))
         {
             if (parsedCmdLineArgs().stopOnFirstFailure)
@@ -561,7 +826,11 @@ int runAllTests(const char *testSuiteName, const char* specificArgsHelp)
         }
     }
 
-    if (failedTests.size() == allTests().size())
+    // Checking for the results, not to overwrite the file from another suite in the same process.
+    if (!parsedCmdLineArgs().benchmarkJsonFile.empty() && !benchmarkResults().empty())
+        writeBenchmarkJson(parsedCmdLineArgs().benchmarkJsonFile);
+
+    if (!failedTests.empty() && (int) failedTests.size() == testCount)
     {
         printSectionHeader("All %lu test(s) FAILED in %s. See messages above.",
             failedTests.size(), fullSuiteName.c_str());
@@ -569,8 +838,8 @@ int runAllTests(const char *testSuiteName, const char* specificArgsHelp)
     }
     if (failedTests.size() > 1)
     {
-        printSectionHeader("%lu of %lu tests FAILED in %s. See messages above.",
-            failedTests.size(), allTests().size(), fullSuiteName.c_str());
+        printSectionHeader("%lu of %d tests FAILED in %s. See messages above.",
+            failedTests.size(), testCount, fullSuiteName.c_str());
         return (int) failedTests.size();
     }
     if (failedTests.size() == 1)
@@ -579,8 +848,8 @@ int runAllTests(const char *testSuiteName, const char* specificArgsHelp)
             failedTests.front(), fullSuiteName.c_str());
         return 1;
     }
-    printSectionHeader("SUCCESS: All %lu test(s) PASSED in %s.",
-        allTests().size(), fullSuiteName.c_str());
+    printSectionHeader("SUCCESS: All %d test(s) PASSED in %s.",
+        testCount, fullSuiteName.c_str());
     return 0;
 }
 
@@ -6,11 +6,14 @@
  * Rudimentary standalone unit testing framework designed to mimic Google Test to a certain degree.
  */
 
+#include <chrono>
 #include <functional>
 #include <iostream>
 #include <sstream>
 #include <stdint.h>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <nx/kit/utils.h>
 
@@ -45,7 +48,7 @@ extern bool NX_KIT_API verbose; //< Use to control additional output of the unit
     int unused_##TEST_CASE##_##TEST_NAME /* Not `static const` to suppress "unused" warning. */ = \
         ::nx::kit::test::detail::regTest( \
             {#TEST_CASE, #TEST_NAME, #TEST_CASE "." #TEST_NAME, test_##TEST_CASE##_##TEST_NAME, \
-                /*tempDir*/ ""}); \
+                /*tempDir*/ "", /*isBenchmark*/ false}); \
     static void test_##TEST_CASE##_##TEST_NAME()
     // Function body follows the DEFINE_TEST macro.
 
@@ -53,6 +56,44 @@ extern bool NX_KIT_API verbose; //< Use to control additional output of the unit
     static void disabled_test_##TEST_CASE##_##TEST_NAME() /* The function will be unused. */
     // Function body follows the DISABLED_TEST macro.
 
+ /**
+  * Defines a micro-benchmark: a test which has the variable `benchmark` of type
+  * nx::kit::test::Benchmark, prepares the data, and passes the code to measure to
+  * benchmark.run(), possibly several times - once per variant to compare. ASSERT_...() can be
+  * used as in TEST().
+  *
+  * Benchmarks are registered and run along with the tests, but by default each variant is run
+  * only briefly, to check that it works. To measure, run the test executable with `--benchmark`;
+  * see `--help` for the other options.
+  *
+  * Usage:
+  * ```
+  *     BENCHMARK(MySuite, parse)
+  *     {
+  *         const std::string text = makeText();
+  *         benchmark.run("small", [&]() { nx::kit::test::doNotOptimize(parse(text)); });
+  *     }
+  * ```
+  */
+#define BENCHMARK(TEST_CASE, TEST_NAME) ENABLED_BENCHMARK(TEST_CASE, TEST_NAME)
+
+#define ENABLED_BENCHMARK(TEST_CASE, TEST_NAME) \
+    static void benchmark_##TEST_CASE##_##TEST_NAME(::nx::kit::test::Benchmark& benchmark); \
+    int unused_##TEST_CASE##_##TEST_NAME /* Not `static const` to suppress "unused" warning. */ = \
+        ::nx::kit::test::detail::regTest( \
+            {#TEST_CASE, #TEST_NAME, #TEST_CASE "." #TEST_NAME, \
+                ::nx::kit::test::detail::benchmarkTestFunc( \
+                    #TEST_CASE "." #TEST_NAME, benchmark_##TEST_CASE##_##TEST_NAME), \
+                /*tempDir*/ "", /*isBenchmark*/ true}); \
+    static void benchmark_##TEST_CASE##_##TEST_NAME(::nx::kit::test::Benchmark& benchmark)
+    // Function body follows the ENABLED_BENCHMARK macro.
+
+#define DISABLED_BENCHMARK(TEST_CASE, TEST_NAME) \
+    /* The function will be unused; `inline` suppresses the warning. */ \
+    static inline void disabled_benchmark_##TEST_CASE##_##TEST_NAME( \
+        ::nx::kit::test::Benchmark& benchmark)
+    // Function body follows the DISABLED_BENCHMARK macro.
+
 #define ASSERT_TRUE(CONDITION) \
     ::nx::kit::test::detail::assertBool(true, !!(CONDITION), #CONDITION, __FILE__, __LINE__)
 
@@ -135,6 +176,107 @@ NX_KIT_API int runAllTests(const char *testSuiteName, const char* specificArgsHe
 /** Allows zero bytes in the content. */
 NX_KIT_API void createFile(const std::string& filename, const std::string& content);
 
+class Benchmark;
+
+namespace detail {
+
+typedef std::function<void()> TestFunc;
+
+NX_KIT_API TestFunc benchmarkTestFunc(const char* name, void (*benchmarkFunc)(Benchmark&));
+
+NX_KIT_API void useValue(const void* value);
+
+} // namespace detail
+
+/**
+ * Measures the code passed to run() from the BENCHMARK() body. With `--benchmark`, each variant
+ * is warmed up, then the number of iterations is calibrated so that a sample takes about 10 ms,
+ * and the median and the median absolute deviation (MAD) of the time per iteration over the
+ * samples are reported. The results can be saved to a JSON file, and compared with a file saved
+ * by an earlier run, failing the benchmark if a variant has become slower than the tolerance.
+ */
+class NX_KIT_API Benchmark
+{
+public:
+    /**
+     * Calls the action repeatedly and reports the time per call.
+     * @param variant Name of the variant within the benchmark; can be empty if there is only one.
+     */
+    template<typename Action>
+    void run(const std::string& variant, Action action)
+    {
+        runBatches(variant,
+            [&action](int64_t iterationCount)
+            {
+                using namespace std::chrono;
+                const auto start = steady_clock::now();
+                for (int64_t i = 0; i < iterationCount; ++i)
+                    action();
+                return (double) duration_cast<nanoseconds>(steady_clock::now() - start).count();
+            });
+    }
+
+    template<typename Action>
+    void run(Action action)
+    {
+        run(std::string(), std::move(action));
+    }
+
+    /**
+     * Like run(), but calls action(threadIndex) repeatedly from each of the given number of
+     * threads at the same time, e.g. to measure contention; reports the time per call per thread.
+     */
+    template<typename Action>
+    void runConcurrently(const std::string& variant, int threadCount, Action action)
+    {
+        runBatches(variant,
+            [&action, threadCount](int64_t iterationCount)
+            {
+                using namespace std::chrono;
+                std::vector<std::thread> threads;
+                const auto start = steady_clock::now();
+                for (int t = 0; t < threadCount; ++t)
+                {
+                    threads.emplace_back(
+                        [&action, t, iterationCount]()
+                        {
+                            for (int64_t i = 0; i < iterationCount; ++i)
+                                action(t);
+                        });
+                }
+                for (auto& thread: threads)
+                    thread.join();
+                return (double) duration_cast<nanoseconds>(steady_clock::now() - start).count();
+            });
+    }
+
+private:
+    friend detail::TestFunc detail::benchmarkTestFunc(const char*, void (*)(Benchmark&));
+
+    explicit Benchmark(std::string name): m_name(std::move(name)) {}
+
+    /** @param measureBatch Runs the given number of iterations; returns the elapsed time in ns. */
+    void runBatches(
+        const std::string& variant, const std::function<double(int64_t)>& measureBatch);
+
+    void assertNoRegressions() const;
+
+private:
+    const std::string m_name;
+    std::string m_regressions;
+};
+
+/** Prevents the compiler from optimizing away the computation of the value in a benchmark. */
+template<typename T>
+void doNotOptimize(const T& value)
+{
+    #if defined(_MSC_VER)
+        detail::useValue(&value);
+    #else
+        asm volatile("" : : "m"(value) : "memory");
+    #endif
+}
+
 //-------------------------------------------------------------------------------------------------
 // Implementation
 
@@ -144,8 +286,6 @@ namespace detail {
     static const nx::kit::test::TempFile::KeepFilesInitializer tempFileKeepFilesInitializer;
 #endif
 
-typedef std::function<void()> TestFunc;
-
 struct Test
 {
     const char* const testCase;
@@ -153,6 +293,7 @@ struct Test
     const char* const testCaseDotName;
     const TestFunc testFunc;
     std::string tempDir;
+    const bool isBenchmark;
 };
 
 NX_KIT_API int regTest(const Test& test);
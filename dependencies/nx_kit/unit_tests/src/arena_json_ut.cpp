@@ -0,0 +1,95 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <nx/kit/test.h>
+#include <nx/kit/arena_json.h>
+
+#include <string>
+
+namespace nx {
+namespace kit {
+namespace test {
+
+/** Both parsers must agree on the result and on the error message. */
+static void assertSameAsJson(int line, const std::string& text)
+{
+    std::string jsonError;
+    const Json json = Json::parse(text, jsonError);
+
+    std::string arenaError;
+    const ArenaJson arenaJson = ArenaJson::parse(text, arenaError);
+
+    ASSERT_STREQ_AT_LINE(line, jsonError, arenaError);
+    ASSERT_STREQ_AT_LINE(line, json.dump(), arenaJson.root().toJson().dump());
+}
+
+TEST(arenaJson, sameAsJson)
+{
+    assertSameAsJson(__LINE__, "null");
+    assertSameAsJson(__LINE__, " [1, -2, 3.5, 1e3, 12345678901, true, false, null] ");
+    assertSameAsJson(__LINE__, R"({"b": {"x": [], "y": {}}, "a": "text", "c": [[1], [2, [3]]]})");
+    assertSameAsJson(__LINE__, R"({"k": 1, "k": 2, "j": 0})"); //< The last duplicate wins.
+    assertSameAsJson(__LINE__, R"(["esc\"aped\\\/\b\f\n\r\t", "é€😀", "\u0000"])");
+
+    // Errors.
+    assertSameAsJson(__LINE__, "");
+    assertSameAsJson(__LINE__, "[1, 2");
+    assertSameAsJson(__LINE__, "[1 2]");
+    assertSameAsJson(__LINE__, R"({"a" 1})");
+    assertSameAsJson(__LINE__, R"({"a": 1 "b": 2})");
+    assertSameAsJson(__LINE__, R"({1: 2})");
+    assertSameAsJson(__LINE__, R"(["unterminated)");
+    assertSameAsJson(__LINE__, "[\"control\x01\"]");
+    assertSameAsJson(__LINE__, R"(["\x"])");
+    assertSameAsJson(__LINE__, R"(["\u12"])");
+    assertSameAsJson(__LINE__, "[01]");
+    assertSameAsJson(__LINE__, "[1.]");
+    assertSameAsJson(__LINE__, "[1e]");
+    assertSameAsJson(__LINE__, "[-]");
+    assertSameAsJson(__LINE__, "[tru]");
+    assertSameAsJson(__LINE__, "nul");
+    assertSameAsJson(__LINE__, "{} x");
+    assertSameAsJson(__LINE__, std::string(300, '['));
+}
+
+TEST(arenaJson, access)
+{
+    std::string err;
+    ArenaJson arenaJson = ArenaJson::parse(
+        R"({"name": "plugin", "items": [{"id": 7}, 2.5, true], "escaped": "a\nb"})", err);
+    ASSERT_STREQ("", err);
+
+    const JsonView root = arenaJson.root();
+    ASSERT_TRUE(root.is_object());
+    ASSERT_EQ(3U, root.size());
+
+    // Members are sorted by key.
+    ASSERT_STREQ("escaped", root.key(0).toString());
+    ASSERT_STREQ("items", root.key(1).toString());
+    ASSERT_STREQ("name", root.key(2).toString());
+    ASSERT_TRUE(root.value(2).string_value() == std::string("plugin"));
+
+    ASSERT_TRUE(root["name"].string_value() == std::string("plugin"));
+    ASSERT_STREQ("a\nb", root["escaped"].string_value().toString());
+    ASSERT_EQ(7, root["items"][0]["id"].int_value());
+    ASSERT_EQ(2.5, root["items"][1].number_value());
+    ASSERT_TRUE(root["items"][2].bool_value());
+
+    // Missing values and type mismatches yield defaults, like in Json.
+    ASSERT_TRUE(root["missing"].is_null());
+    ASSERT_TRUE(root["items"][3].is_null());
+    ASSERT_TRUE(root["name"][0].is_null());
+    ASSERT_EQ(0, root["name"].int_value());
+    ASSERT_TRUE(root["items"].string_value().empty());
+    ASSERT_EQ(0U, root["name"].size());
+
+    // Moving the document keeps the views valid.
+    ArenaJson moved = ArenaJson::parse("[]", err);
+    const JsonView items = root["items"];
+    moved = std::move(arenaJson);
+    ASSERT_EQ(3U, items.size());
+    ASSERT_EQ(3U, moved.root().size());
+}
+
+} // namespace test
+} // namespace kit
+} // namespace nx
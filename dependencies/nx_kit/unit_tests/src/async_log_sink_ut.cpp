@@ -0,0 +1,170 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nx/kit/test.h>
+#include <nx/kit/async_log_sink.h>
+#include <nx/kit/debug.h>
+
+namespace nx {
+namespace kit {
+namespace test {
+
+/** Captures the output of the sink into a string, replacing debug::stream() for its lifetime. */
+class CapturedOutput
+{
+public:
+    explicit CapturedOutput(std::ostream* stream = nullptr):
+        m_oldStream(debug::stream())
+    {
+        debug::stream() = stream ? stream : &m_stringStream;
+    }
+
+    ~CapturedOutput() { debug::stream() = m_oldStream; }
+
+    std::string str() const { return m_stringStream.str(); }
+
+private:
+    std::ostream* const m_oldStream;
+    std::ostringstream m_stringStream;
+};
+
+TEST(asyncLogSink, concurrentRecords)
+{
+    static const int kThreadCount = 4;
+    static const int kRecordsPerThread = 200;
+
+    CapturedOutput output;
+    const AsyncLogSink::Stats statsBefore = AsyncLogSink::stats();
+    AsyncLogSink::start(/*capacity*/ kThreadCount * kRecordsPerThread);
+    ASSERT_TRUE(AsyncLogSink::isStarted());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [t]()
+            {
+                for (int i = 0; i < kRecordsPerThread; ++i)
+                    NX_PRINT << "thread " << t << ", record " << i;
+            });
+    }
+    for (auto& thread: threads)
+        thread.join();
+
+    AsyncLogSink::flush();
+    const std::string text = output.str();
+    AsyncLogSink::stop();
+    ASSERT_FALSE(AsyncLogSink::isStarted());
+
+    // Each record is written as a whole line, exactly once.
+    std::set<std::string> lines;
+    std::istringstream stream(text);
+    for (std::string line; std::getline(stream, line); )
+        ASSERT_TRUE(lines.insert(line).second);
+    ASSERT_EQ(kThreadCount * kRecordsPerThread, (int) lines.size());
+    ASSERT_EQ(1, (int) lines.count("[async_log_sink_ut] thread 3, record 199"));
+
+    const AsyncLogSink::Stats stats = AsyncLogSink::stats();
+    ASSERT_EQ(kThreadCount * kRecordsPerThread, stats.writtenRecords - statsBefore.writtenRecords);
+    ASSERT_EQ(0, stats.droppedRecords - statsBefore.droppedRecords);
+}
+
+/** Blocks the writer thread in the first write until released. */
+class BlockingBuffer: public std::stringbuf
+{
+public:
+    void waitUntilBlocked()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_isBlocked; });
+    }
+
+    void release()
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_isReleased = true;
+        m_condition.notify_all();
+    }
+
+protected:
+    virtual std::streamsize xsputn(const char* s, std::streamsize count) override
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_isBlocked = true;
+            m_condition.notify_all();
+            m_condition.wait(lock, [this]() { return m_isReleased; });
+        }
+        return std::stringbuf::xsputn(s, count);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_isBlocked = false;
+    bool m_isReleased = false;
+};
+
+TEST(asyncLogSink, dropsWhenFull)
+{
+    BlockingBuffer buffer;
+    std::ostream blockingStream(&buffer);
+    CapturedOutput output(&blockingStream);
+    const AsyncLogSink::Stats statsBefore = AsyncLogSink::stats();
+    AsyncLogSink::start(/*capacity*/ 2);
+
+    NX_PRINT << "taken by the writer";
+    buffer.waitUntilBlocked();
+
+    for (int i = 0; i < 5; ++i) //< The first two records fit into the queue.
+        NX_PRINT << "record " << i;
+
+    buffer.release();
+    AsyncLogSink::flush();
+    AsyncLogSink::stop();
+
+    ASSERT_STREQ(
+        "[async_log_sink_ut] taken by the writer\n"
+        "[async_log_sink_ut] record 0\n"
+        "[async_log_sink_ut] record 1\n"
+        "[async_log_sink] 3 record(s) dropped: the queue is full\n",
+        buffer.str());
+
+    const AsyncLogSink::Stats stats = AsyncLogSink::stats();
+    ASSERT_EQ(3, stats.writtenRecords - statsBefore.writtenRecords);
+    ASSERT_EQ(3, stats.droppedRecords - statsBefore.droppedRecords);
+}
+
+TEST(asyncLogSink, truncatesLongRecords)
+{
+    CapturedOutput output;
+    AsyncLogSink::start(AsyncLogSink::kDefaultCapacity, /*maxRecordSize*/ 64);
+    NX_PRINT << std::string(100, 'a');
+    AsyncLogSink::flush();
+    AsyncLogSink::stop();
+
+    const std::string text = output.str();
+    ASSERT_EQ(64, (int) text.size());
+    ASSERT_STREQ("[async_log_sink_ut] aaaa", text.substr(0, 24));
+    ASSERT_STREQ(" <...>\n", text.substr(64 - 7));
+}
+
+TEST(asyncLogSink, synchronousWhenStopped)
+{
+    CapturedOutput output;
+    AsyncLogSink::flush(); //< Does nothing.
+    NX_PRINT << "direct";
+    ASSERT_STREQ("[async_log_sink_ut] direct\n", output.str());
+}
+
+} // namespace test
+} // namespace kit
+} // namespace nx
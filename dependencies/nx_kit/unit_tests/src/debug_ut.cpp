@@ -1,7 +1,10 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <thread>
 
 #include <nx/kit/test.h>
 #include <nx/kit/debug.h>
@@ -50,6 +53,57 @@ TEST(debug, disabledOutput)
         NX_OUTPUT << "Should not be executed.";
 }
 
+TEST(debug, logLevels)
+{
+    static constexpr struct
+    {
+        const bool enableOutput = false;
+    } ini{};
+
+    std::ostringstream stringStream;
+    std::ostream* const oldStream = stream();
+    stream() = &stringStream;
+    const int oldLogLevel = logLevel();
+
+    int evaluatedArgs = 0;
+    setLogLevel(NX_LOG_LEVEL_INFO);
+    NX_LOG_TRACE << "trace" << ++evaluatedArgs; //< Requires enableOutput.
+    NX_LOG_DEBUG << "debug" << ++evaluatedArgs; //< Requires enableOutput.
+    NX_LOG_INFO << "info";
+    NX_LOG_WARN << "warn";
+    NX_LOG_ERROR << "error";
+    ASSERT_EQ(0, evaluatedArgs);
+
+    setLogLevel(NX_LOG_LEVEL_ERROR);
+    NX_LOG_INFO << "info" << ++evaluatedArgs;
+    NX_LOG_WARN << "warn" << ++evaluatedArgs;
+    NX_LOG_ERROR << "error";
+    ASSERT_EQ(0, evaluatedArgs);
+    ASSERT_FALSE(NX_LOG_ENABLED(NX_LOG_LEVEL_WARN));
+    ASSERT_TRUE(NX_LOG_ENABLED(NX_LOG_LEVEL_ERROR));
+
+    // Levels below NX_DEBUG_MIN_LOG_LEVEL are compiled out regardless of the runtime level.
+    setLogLevel(NX_LOG_LEVEL_TRACE);
+    #undef NX_DEBUG_MIN_LOG_LEVEL
+    #define NX_DEBUG_MIN_LOG_LEVEL NX_LOG_LEVEL_WARN
+    NX_LOG_INFO << "info" << ++evaluatedArgs;
+    NX_LOG_WARN << "warn";
+    ASSERT_FALSE(NX_LOG_ENABLED(NX_LOG_LEVEL_INFO));
+    #undef NX_DEBUG_MIN_LOG_LEVEL
+    #define NX_DEBUG_MIN_LOG_LEVEL NX_LOG_LEVEL_TRACE
+    ASSERT_EQ(0, evaluatedArgs);
+
+    setLogLevel(oldLogLevel);
+    stream() = oldStream;
+    ASSERT_STREQ(
+        "[debug_ut] info\n"
+        "[debug_ut] WARNING: warn\n"
+        "[debug_ut] ERROR: error\n"
+        "[debug_ut] ERROR: error\n"
+        "[debug_ut] WARNING: warn\n",
+        stringStream.str());
+}
+
 TEST(debug, overrideStreamStatic)
 {
     std::ostringstream stringStream;
@@ -218,6 +272,40 @@ TEST(debug, disabledTime)
     NX_TIME_END(testTag);
 }
 
+TEST(debug, latencyHistogram)
+{
+    LatencyHistogram& histogram = LatencyHistogram::get("debug_ut.latencyHistogram");
+    ASSERT_EQ(&histogram, &LatencyHistogram::get("debug_ut.latencyHistogram"));
+    ASSERT_EQ(0, histogram.percentileUs(50));
+
+    for (int64_t i = 1; i <= 10000; ++i)
+        histogram.record(i);
+
+    ASSERT_EQ(10000, histogram.count());
+    ASSERT_EQ(10000, histogram.maxUs());
+    // The buckets give each percentile within ~3%.
+    ASSERT_TRUE(std::abs(histogram.percentileUs(50) - 5000) <= 5000 * 3 / 100);
+    ASSERT_TRUE(std::abs(histogram.percentileUs(99) - 9900) <= 9900 * 3 / 100);
+    ASSERT_EQ(1, histogram.percentileUs(0));
+    ASSERT_EQ(10000, histogram.percentileUs(100));
+    ASSERT_STREQ("debug_ut.latencyHistogram: 10000 values, p50 5.1 ms, p90 9.2 ms, p99 10.0 ms, "
+        "max 10.0 ms", histogram.summary());
+}
+
+TEST(debug, latencyHistogramScope)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        NX_TIME_HISTOGRAM("debug_ut.latencyHistogramScope");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const LatencyHistogram& histogram = LatencyHistogram::get("debug_ut.latencyHistogramScope");
+    ASSERT_EQ(3, histogram.count());
+    ASSERT_TRUE(histogram.percentileUs(50) >= 1000);
+    ASSERT_TRUE(LatencyHistogram::summaryOfAll().find(histogram.summary()) != std::string::npos);
+}
+
 TEST(debug, srcFileBaseNameWithoutExt)
 {
     static const std::string s(1, nx::kit::utils::kPathSeparator);    
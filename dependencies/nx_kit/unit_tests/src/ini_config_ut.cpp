@@ -6,11 +6,15 @@
  * both of the two compilations should produce a dynamic library.
  */
 
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include <nx/kit/test.h>
 #include <nx/kit/ini_config.h>
@@ -384,3 +388,51 @@ TEST(iniConfig, testGetParamTypeAndValue)
 
     ASSERT_FALSE(ini.getParamTypeAndValue("nonExistentParameter", &type, &data));
 }
+
+/** @return Whether the condition has become true within a few seconds. */
+static bool waitFor(const std::function<bool()>& condition)
+{
+    for (int i = 0; i < 500; ++i)
+    {
+        if (condition())
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+TEST(iniConfig, testWatching)
+{
+    if (!IniConfig::isEnabled())
+    {
+        std::cerr << "IniConfig::isEnabled() -> false" << std::endl;
+        return; //< Nothing to test if IniConfig is disabled at compile time.
+    }
+
+    IniConfig::setIniFilesDir(nx::kit::test::tempDir());
+    IniConfig::setOutput(nullptr); //< The watcher thread would print the values.
+
+    TestIni ini;
+    ini.reload();
+    ini.startWatching();
+    ini.startWatching(); //< Must do nothing.
+
+    nx::kit::test::createFile(ini.iniFilePath(), "intNumber=42\n");
+    ASSERT_TRUE(waitFor([&]() { return ini.intNumber == 42; }));
+
+    nx::kit::test::createFile(ini.iniFilePath(), "intNumber=43\nstr5=changed\n");
+    ASSERT_TRUE(waitFor([&]() { return strcmp(ini.str5, "changed") == 0; }));
+    ASSERT_EQ(43, ini.intNumber);
+
+    // The values return to the defaults when the file is deleted.
+    ASSERT_EQ(0, remove(ini.iniFilePath()));
+    ASSERT_TRUE(waitFor([&]() { return ini.intNumber == 113; }));
+    ASSERT_STREQ("plain string", ini.str5);
+
+    ini.stopWatching();
+    nx::kit::test::createFile(ini.iniFilePath(), "intNumber=44\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(113, ini.intNumber);
+
+    IniConfig::setOutput(&std::cerr); //< Restore global setting.
+}
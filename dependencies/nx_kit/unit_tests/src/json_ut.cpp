@@ -6,6 +6,13 @@
 
 #include <nx/kit/test.h>
 
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
 #include <nx/kit/json.h>
 
 //-------------------------------------------------------------------------------------------------
@@ -24,6 +31,109 @@ TEST(json, nx_kit_added)
     ASSERT_STREQ(jsonString, serializedJson);
 }
 
+TEST(json, mutable_items)
+{
+    using ::nx::kit::Json;
+
+    std::string err;
+    const Json original = Json::parse(R"({"items": [1, {"name": "a"}], "type": "Settings"})", err);
+    ASSERT_STREQ("", err);
+
+    // Only arrays and objects can be edited in place.
+    Json number = 42;
+    ASSERT_TRUE(number.mutable_array_items() == nullptr);
+    ASSERT_TRUE(number.mutable_object_items() == nullptr);
+
+    // Editing a copy detaches it from the original, sharing the unchanged items.
+    Json copy = original;
+    Json::object* const object = copy.mutable_object_items();
+    ASSERT_TRUE(object != nullptr);
+    ASSERT_TRUE(copy.mutable_object_items() == object); //< Not shared anymore: no second copy.
+    Json::array* const items = (*object)["items"].mutable_array_items();
+    ASSERT_TRUE(items != nullptr);
+    items->insert(items->begin(), Json("first"));
+    (*object)["type"] = "Changed";
+
+    ASSERT_STREQ(R"({"items": [1, {"name": "a"}], "type": "Settings"})", original.dump());
+    ASSERT_STREQ(R"({"items": ["first", 1, {"name": "a"}], "type": "Changed"})", copy.dump());
+    ASSERT_TRUE(&original["items"][1].object_items() == &copy["items"][2].object_items());
+}
+
+TEST(json, string_and_number_scanning)
+{
+    using ::nx::kit::Json;
+
+    // Strings are scanned 8 chars at a time: put special chars at every position in a block.
+    for (size_t position = 0; position < 20; ++position)
+    {
+        const std::string prefix(position, 'a');
+        std::string err;
+
+        Json json = Json::parse("[\"" + prefix + "\\n\\u00e9\\\"tail of the string\"]", err);
+        ASSERT_STREQ("", err);
+        ASSERT_STREQ(prefix + "\n\xC3\xA9\"tail of the string", json[0].string_value());
+
+        json = Json::parse("[\"" + prefix + "\x01\"]", err);
+        ASSERT_STREQ("unescaped (1) in string", err);
+
+        json = Json::parse("[\"" + prefix, err);
+        ASSERT_STREQ("unexpected end of input in string", err);
+    }
+
+    std::string err;
+    const Json numbers = Json::parse("[0.1, -2.5e3, 1E2, 12345678901, 1e400]", err);
+    ASSERT_STREQ("", err);
+    ASSERT_EQ(0.1, numbers[0].number_value());
+    ASSERT_EQ(-2500.0, numbers[1].number_value());
+    ASSERT_EQ(100.0, numbers[2].number_value());
+    ASSERT_EQ(12345678901.0, numbers[3].number_value());
+    ASSERT_TRUE(numbers[4].number_value() > 1e300); //< Out of range: handled by the slow path.
+}
+
+TEST(json, number_fast_path)
+{
+    using ::nx::kit::Json;
+
+    // The numbers with up to 15 significant digits and a small exponent are converted without
+    // strtod(); each must give exactly the same double, including on the fast path boundaries.
+    std::vector<std::string> numbers = {
+        "0.0", "-0.0", "0.000", "1.5", "-1.5", "0.1", "0.3", "123456789012345",
+        "1234567890123456", "0.000000000000000000001", "1e22", "1e23", "1e-22", "1e-23",
+        "9007199254740993.0", "4.35", "2.2250738585072014e-308", "1.7976931348623157e308",
+        "0.0000000000000000000000015e22", "1.00000000000000000000000", "8.5e-3", "1E+2"};
+    uint32_t seed = 1;
+    const auto random = [&seed]() { return seed = seed * 1664525 + 1013904223; };
+    for (int i = 0; i < 10000; ++i)
+    {
+        char number[64];
+        const double mantissa = (double) random() / 4294967296.0 * (random() % 2 ? 1 : -1);
+        const int digits = 1 + (int) (random() % 17);
+        const int exponent = (int) (random() % 60) - 30;
+        snprintf(number, sizeof(number), "%.*e", digits, mantissa * pow(10.0, exponent));
+        numbers.push_back(number);
+        snprintf(number, sizeof(number), "%.*f", digits, mantissa * pow(10.0, exponent % 8));
+        numbers.push_back(number);
+    }
+
+    // 17 significant digits tell any two doubles apart, including 0 and -0.
+    const auto exactString =
+        [](const std::string& number, double value)
+        {
+            char result[64];
+            snprintf(result, sizeof(result), "%.17g", value);
+            return number + " -> " + result;
+        };
+
+    for (const std::string& number: numbers)
+    {
+        std::string err;
+        const Json json = Json::parse("[" + number + "]", err);
+        ASSERT_STREQ("", err);
+        ASSERT_STREQ(exactString(number, strtod(number.c_str(), nullptr)),
+            exactString(number, json[0].number_value()));
+    }
+}
+
 } // namespace test
 
 //-------------------------------------------------------------------------------------------------
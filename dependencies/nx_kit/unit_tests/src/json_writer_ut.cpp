@@ -0,0 +1,107 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <nx/kit/test.h>
+#include <nx/kit/json_writer.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace nx {
+namespace kit {
+namespace test {
+
+static void assertSameAsDump(int line, const Json& json)
+{
+    JsonWriter writer;
+    writer.value(json);
+    ASSERT_STREQ_AT_LINE(line, json.dump(), writer.buffer());
+}
+
+TEST(jsonWriter, sameAsDump)
+{
+    assertSameAsDump(__LINE__, Json());
+    assertSameAsDump(__LINE__, Json::array{1, -2147483647 - 1, 2147483647, 0.5, -0.0, 1e300, 3e9,
+        true, false, nullptr});
+    assertSameAsDump(__LINE__, Json::object{
+        {"b", Json::array{}}, {"a", Json::object{}}, {"c", Json::object{{"x", "y"}}}});
+
+    // Strings with escapes at every position relative to 16- and 8-char blocks.
+    const std::vector<std::string> specials{
+        "\"", "\\", "\n", "\t", "\b", "\f", "\r", std::string(1, '\0'), "\x1f", "\x7f",
+        "\xe2\x80\xa8", "\xe2\x80\xa9", "\xe2\x80", "\xe2", "\xe2\x82\xac", "é"};
+    for (const std::string& special: specials)
+    {
+        for (size_t position = 0; position < 40; ++position)
+        {
+            std::string s(40, 'a');
+            s.insert(position, special);
+            assertSameAsDump(__LINE__, Json(s));
+            assertSameAsDump(__LINE__, Json(s.substr(0, position + special.size())));
+        }
+    }
+}
+
+TEST(jsonWriter, structure)
+{
+    JsonWriter writer;
+    writer.reserve(256);
+    writer.beginObject()
+        .key("type").value("Settings")
+        .key("items").beginArray()
+            .value(1).value(2.5).null().beginObject().endObject().beginArray().endArray()
+        .endArray()
+        .key(std::string("map")).value(std::map<std::string, std::string>{{"k1", "v1"}, {"k2", ""}})
+    .endObject();
+    ASSERT_STREQ(
+        R"({"type": "Settings", "items": [1, 2.5, null, {}, []], "map": {"k1": "v1", "k2": ""}})",
+        writer.buffer());
+
+    // The buffer is reused for the next document.
+    const size_t capacity = writer.buffer().capacity();
+    writer.clear();
+    writer.value(true);
+    ASSERT_STREQ("true", writer.buffer());
+    ASSERT_EQ(capacity, writer.buffer().capacity());
+
+    ASSERT_STREQ("true", writer.takeBuffer());
+    ASSERT_TRUE(writer.buffer().empty());
+}
+
+struct StringMapMock
+{
+    std::vector<std::pair<const char*, const char*>> items;
+
+    int count() const { return (int) items.size(); }
+    const char* key(int i) const { return items[i].first; }
+    const char* value(int i) const { return items[i].second; }
+};
+
+TEST(jsonWriter, stringMapObject)
+{
+    StringMapMock map;
+    map.items = {{"name", "value \"quoted\""}, {nullptr, "skipped"}, {"empty", nullptr}};
+
+    JsonWriter writer;
+    writer.beginArray().stringMapObject(map).stringMapObject(StringMapMock()).endArray();
+    ASSERT_STREQ(R"([{"name": "value \"quoted\"", "empty": ""}, {}])", writer.buffer());
+}
+
+TEST(jsonWriter, stream)
+{
+    std::ostringstream stream;
+    {
+        JsonWriter writer(&stream, /*flushThreshold*/ 8);
+        writer.beginArray();
+        for (int i = 0; i < 10; ++i)
+            writer.value(i);
+        writer.endArray();
+        ASSERT_TRUE(writer.buffer().size() < 8 + 4); //< Flushed on the way.
+    } //< The rest is flushed on destruction.
+    ASSERT_STREQ("[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]", stream.str());
+}
+
+} // namespace test
+} // namespace kit
+} // namespace nx
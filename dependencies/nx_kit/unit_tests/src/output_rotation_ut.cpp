@@ -0,0 +1,88 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <nx/kit/test.h>
+#include <nx/kit/output_rotation.h>
+#include <nx/kit/utils.h>
+
+#if defined(_WIN32)
+    #pragma warning(disable: 4996) //< MSVC: fopen() is unsafe.
+#endif
+
+namespace nx {
+namespace kit {
+namespace test {
+
+static std::string fileContent(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+TEST(outputRotation, rotate)
+{
+    const std::string filename = std::string(tempDir()) + "output.log";
+    FILE* const stream = fopen(filename.c_str(), "w");
+    ASSERT_TRUE(stream != nullptr);
+
+    OutputRotation::Options options;
+    options.maxFileSize = 10;
+    options.keptFileCount = 2;
+
+    fprintf(stream, "small\n");
+    fflush(stream);
+    ASSERT_FALSE(OutputRotation::rotateIfNeeded(stream, filename, options));
+
+    // Only a file which the stream is writing to is rotated.
+    ASSERT_FALSE(OutputRotation::rotateIfNeeded(stdout, filename, options));
+
+    for (int i = 1; i <= 3; ++i)
+    {
+        fprintf(stream, "segment %d is big enough\n", i);
+        fflush(stream);
+        ASSERT_TRUE(OutputRotation::rotateIfNeeded(stream, filename, options));
+    }
+    fprintf(stream, "current\n");
+    fclose(stream);
+
+    ASSERT_STREQ("current\n", fileContent(filename));
+    ASSERT_STREQ("segment 3 is big enough\n", fileContent(filename + ".1"));
+    ASSERT_STREQ("segment 2 is big enough\n", fileContent(filename + ".2"));
+    ASSERT_FALSE(utils::fileExists((filename + ".3").c_str()));
+}
+
+TEST(outputRotation, compress)
+{
+    if (!OutputRotation::isCompressionSupported(OutputRotation::Compression::gzip))
+        return;
+
+    const std::string filename = std::string(tempDir()) + "output.log";
+    FILE* const stream = fopen(filename.c_str(), "w");
+    ASSERT_TRUE(stream != nullptr);
+
+    OutputRotation::Options options;
+    options.maxFileSize = 1000;
+    options.compression = OutputRotation::Compression::gzip;
+
+    for (int i = 0; i < 100; ++i)
+        fprintf(stream, "a repetitive log line\n");
+    fflush(stream);
+    ASSERT_TRUE(OutputRotation::rotateIfNeeded(stream, filename, options));
+    fclose(stream);
+
+    ASSERT_FALSE(utils::fileExists((filename + ".1").c_str()));
+    const std::string compressed = fileContent(filename + ".1.gz");
+    ASSERT_TRUE(compressed.size() > 2 && compressed.size() < 200);
+    ASSERT_EQ('\x1f', compressed[0]); //< gzip magic.
+    ASSERT_EQ('\x8b', compressed[1]);
+}
+
+} // namespace test
+} // namespace kit
+} // namespace nx
@@ -6,6 +6,7 @@
 
 #include <nx/kit/test.h>
 
+#include <atomic>
 #include <fstream>
 #include <string>
 
@@ -134,6 +135,45 @@ TEST(utils, universalString)
     }
 }
 
+BENCHMARK(test, benchmark)
+{
+    int callCount = 0;
+    benchmark.run(
+        [&]()
+        {
+            ++callCount;
+            doNotOptimize(callCount);
+        });
+    ASSERT_TRUE(callCount > 1); //< The iteration count is calibrated.
+
+    std::string text;
+    benchmark.run("variant",
+        [&]()
+        {
+            text = nx::kit::utils::toString(callCount);
+            doNotOptimize(text);
+        });
+    ASSERT_FALSE(text.empty());
+}
+
+BENCHMARK(test, concurrentBenchmark)
+{
+    static constexpr int kThreadCount = 3;
+    std::atomic<int64_t> callCounts[kThreadCount]{};
+    benchmark.runConcurrently("threads", kThreadCount,
+        [&](int threadIndex) { callCounts[threadIndex].fetch_add(1, std::memory_order_relaxed); });
+
+    // Each thread runs the same calibrated number of iterations.
+    ASSERT_TRUE(callCounts[0] > 1);
+    for (const auto& callCount: callCounts)
+        ASSERT_EQ(callCounts[0].load(), callCount.load());
+}
+
+DISABLED_BENCHMARK(test, disabledBenchmark)
+{
+    benchmark.run([]() { ASSERT_TRUE(false); });
+}
+
 } // namespace test
 } // namespace test
 } // namespace kit
@@ -0,0 +1,124 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <system_error>
+
+#include <nx/kit/ini_config.h>
+
+#include <cloudfuse/child_process.h>
+
+// Stands for the real CloudfuseMngr, so that the plugin can be benchmarked without cloudfuse and
+// without touching the user's home dir: the commands succeed at once. Like cloudfuse, the stub
+// remembers which mount dirs are mounted, regardless of whether the dirs exist: on Linux, mounting
+// fails unless the plugin has created the mount dir; on Windows, mounting creates the dir and
+// unmounting removes it. The dirs are created in the ini files dir, which the benchmark sets to
+// its temp dir.
+
+namespace fs = std::filesystem;
+
+static std::mutex mountedDirsMutex;
+static std::set<std::string> mountedDirs;
+
+static processReturn failed(const std::string &output)
+{
+    return processReturn{1, output};
+}
+
+static processReturn succeeded()
+{
+    return processReturn{0, ""};
+}
+
+CloudfuseMngr::CloudfuseMngr()
+{
+    const std::string baseDir = nx::kit::IniConfig::iniFilesDir();
+    mountDir = baseDir + "cloudfuse";
+    fileCacheDir = baseDir + "cloudfuse_cache";
+    configFile = baseDir + "nx_plugin_config.aes";
+    templateFile = baseDir + "nx_plugin_config.yaml";
+}
+
+#ifdef _WIN32
+processReturn CloudfuseMngr::dryRun(const std::string passphrase)
+{
+    return succeeded();
+}
+
+processReturn CloudfuseMngr::mount(const std::string passphrase)
+{
+    const std::lock_guard<std::mutex> lock(mountedDirsMutex);
+    if (!mountedDirs.insert(mountDir).second)
+        return failed("already mounted: " + mountDir);
+    std::error_code errCode;
+    fs::create_directories(mountDir, errCode);
+    return succeeded();
+}
+
+processReturn CloudfuseMngr::genS3Config(const std::string accessKeyId, const std::string secretAccessKey,
+                                         const std::string endpoint, const std::string bucketName,
+                                         const uint64_t bucketSizeMb, const std::string passphrase)
+{
+    return succeeded();
+}
+#elif defined(__linux__) || defined(__APPLE__)
+processReturn CloudfuseMngr::dryRun(const std::string accessKeyId, const std::string secretAccessKey,
+                                    const std::string passphrase)
+{
+    return succeeded();
+}
+
+processReturn CloudfuseMngr::mount(const std::string accessKeyId, const std::string secretAccessKey,
+                                   const std::string passphrase)
+{
+    std::error_code errCode;
+    if (!fs::is_directory(mountDir, errCode))
+        return failed("mount dir does not exist: " + mountDir);
+    const std::lock_guard<std::mutex> lock(mountedDirsMutex);
+    if (!mountedDirs.insert(mountDir).second)
+        return failed("already mounted: " + mountDir);
+    return succeeded();
+}
+
+processReturn CloudfuseMngr::genS3Config(const std::string endpoint, const std::string bucketName,
+                                         const uint64_t bucketSizeMb, const std::string passphrase)
+{
+    return succeeded();
+}
+#endif
+
+std::string CloudfuseMngr::getMountDir()
+{
+    return mountDir;
+}
+
+std::string CloudfuseMngr::getFileCacheDir()
+{
+    return fileCacheDir;
+}
+
+processReturn CloudfuseMngr::unmount()
+{
+    const std::lock_guard<std::mutex> lock(mountedDirsMutex);
+    if (mountedDirs.erase(mountDir) == 0)
+        return failed("not mounted: " + mountDir);
+#ifdef _WIN32
+    std::error_code errCode;
+    fs::remove(mountDir, errCode);
+#endif
+    return succeeded();
+}
+
+bool CloudfuseMngr::isInstalled()
+{
+    return true;
+}
+
+bool CloudfuseMngr::isMounted()
+{
+    const std::lock_guard<std::mutex> lock(mountedDirsMutex);
+    return mountedDirs.count(mountDir) > 0;
+}
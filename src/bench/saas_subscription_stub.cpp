@@ -0,0 +1,16 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#include "settings/saas_subscription.h"
+
+// Stands for the real check, which spawns sed and curl to ask the local media server, so that
+// setSettings() is measured without process spawning and the network.
+
+namespace settings
+{
+
+SaasSubscriptionResult checkSaasSubscription()
+{
+    return SaasSubscriptionResult::SubscriptionValid;
+}
+
+} // namespace settings
@@ -23,7 +23,17 @@
 */
 
 #include "child_process.h"
+#include <cstdio>
 #include <fstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 std::string CloudfuseMngr::getMountDir()
 {
@@ -35,9 +45,100 @@ std::string CloudfuseMngr::getFileCacheDir()
     return fileCacheDir;
 }
 
+// one stat() call instead of opening and reading the file
+static bool statFile(const std::string &path, int64_t *outSize, int64_t *outModificationTimeNs, uint64_t *outInode)
+{
+#ifdef _WIN32
+    struct _stat64 fileStat;
+    if (_stat64(path.c_str(), &fileStat) != 0)
+    {
+        return false;
+    }
+    *outModificationTimeNs = static_cast<int64_t>(fileStat.st_mtime) * 1000000000;
+    *outInode = 0; // not provided on Windows
+#else
+    struct stat fileStat;
+    if (stat(path.c_str(), &fileStat) != 0)
+    {
+        return false;
+    }
+    *outModificationTimeNs =
+        static_cast<int64_t>(fileStat.st_mtim.tv_sec) * 1000000000 + static_cast<int64_t>(fileStat.st_mtim.tv_nsec);
+    *outInode = static_cast<uint64_t>(fileStat.st_ino);
+#endif
+    *outSize = static_cast<int64_t>(fileStat.st_size);
+    return true;
+}
+
+// write the content to a temp file, flush it to the disk, and rename it over the target file, so
+// that after a crash the target file holds either the old or the new content, never a partial one
+static bool replaceFileDurably(const std::string &path, const std::string &content)
+{
+    const std::string tempPath = path + ".tmp";
+#ifdef _WIN32
+    HANDLE file = CreateFileA(tempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    DWORD bytesWritten = 0;
+    bool written = WriteFile(file, content.data(), static_cast<DWORD>(content.size()), &bytesWritten, NULL) &&
+                   bytesWritten == content.size() && FlushFileBuffers(file);
+    written = CloseHandle(file) && written;
+    // MOVEFILE_WRITE_THROUGH returns only when the rename is on the disk
+    written = written && MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    const int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+        return false;
+    }
+    bool written = true;
+    size_t offset = 0;
+    while (written && offset < content.size())
+    {
+        const ssize_t bytesWritten = write(fd, content.data() + offset, content.size() - offset);
+        written = bytesWritten > 0;
+        offset += written ? static_cast<size_t>(bytesWritten) : 0;
+    }
+    written = written && fsync(fd) == 0;
+    written = close(fd) == 0 && written;
+    written = written && rename(tempPath.c_str(), path.c_str()) == 0;
+    if (written)
+    {
+        // make the rename itself durable; a failure here only loses the rename, not the old file
+        const size_t separator = path.find_last_of('/');
+        const std::string dir = separator == std::string::npos ? "." : path.substr(0, separator + 1);
+        const int dirFd = open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+        if (dirFd != -1)
+        {
+            fsync(dirFd);
+            close(dirFd);
+        }
+    }
+#endif
+    if (!written)
+    {
+        std::remove(tempPath.c_str());
+    }
+    return written;
+}
+
 // check the first line of the template file for a matching version
 bool CloudfuseMngr::templateValid()
 {
+    FileStamp stamp;
+    if (!statFile(templateFile, &stamp.size, &stamp.modificationTimeNs, &stamp.inode))
+    {
+        // the file doesn't exist (or can't be accessed), so we need to write it
+        return false;
+    }
+    // the file has not changed since it was last validated (or written by us)
+    if (stamp == validTemplateStamp)
+    {
+        return true;
+    }
+
     std::string firstLine;
     bool readFailed = false;
     // open the template file
@@ -57,26 +158,28 @@ bool CloudfuseMngr::templateValid()
         return false;
     }
     // if the versions don't match, we need to overwrite the template
-    return templateVersionString.compare(firstLine) == 0;
+    if (templateVersionString.compare(firstLine) != 0)
+    {
+        return false;
+    }
+    validTemplateStamp = stamp;
+    return true;
 }
 
 bool CloudfuseMngr::writeTemplate()
 {
-    // write the template file
-    std::ofstream out(templateFile, std::ios::trunc);
-    if (!out.is_open())
-    {
-        // failed to open template file for writing
-        printf("Failed to open config template (%s).\n", templateFile.c_str());
-        return false;
-    }
-    out << config_template;
-    out.close();
-    if (out.fail())
+    // forget the stamp first: if the write fails, the file has to be validated again
+    validTemplateStamp = FileStamp();
+    if (!replaceFileDurably(templateFile, configTemplate()))
     {
         // failed to write template file
         printf("Failed to write config template (%s).\n", templateFile.c_str());
         return false;
     }
+    FileStamp stamp;
+    if (statFile(templateFile, &stamp.size, &stamp.modificationTimeNs, &stamp.inode))
+    {
+        validTemplateStamp = stamp;
+    }
     return true;
-}
\ No newline at end of file
+}
@@ -65,12 +65,27 @@ class CloudfuseMngr
     bool isMounted();
 
   private:
+    // identifies a version of a file without reading it
+    struct FileStamp
+    {
+        int64_t size = -1;
+        int64_t modificationTimeNs = -1;
+        uint64_t inode = 0;
+
+        bool operator==(const FileStamp &other) const
+        {
+            return size == other.size && modificationTimeNs == other.modificationTimeNs && inode == other.inode;
+        }
+    };
+
     std::string mountDir;
     std::string configFile;
     std::string fileCacheDir;
     std::string templateFile;
     std::string templateVersionString;
-    std::string config_template;
+    // the template file as it was when last found valid (or written), so it is not read again
+    FileStamp validTemplateStamp;
+    std::string configTemplate();
     bool templateValid();
     bool writeTemplate();
 #ifdef _WIN32
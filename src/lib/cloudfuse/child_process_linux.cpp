@@ -27,7 +27,6 @@
 #include <fstream>
 #include <sys/stat.h>
 #include <sys/utsname.h>
-#include <sys/wait.h>
 #include <unistd.h>
 
 const std::string PATH = "PATH=/usr/bin:/usr";
@@ -46,11 +45,33 @@ std::string getSystemName()
 
 CloudfuseMngr::CloudfuseMngr()
 {
-    // generate template contents
-    std::string systemName = getSystemName();
     // NOTE: increment the version number when the config template changes
     templateVersionString = "template-version: 0.6";
-    config_template = templateVersionString + R"(
+
+    std::string homeEnv;
+    const char *home = std::getenv("HOME");
+    if (home == nullptr)
+    {
+        homeEnv = "";
+    }
+    else
+    {
+        homeEnv = home;
+    }
+    mountDir = homeEnv + "/cloudfuse";
+    fileCacheDir = homeEnv + "/cloudfuse_cache";
+    configFile = homeEnv + "/nx_plugin_config.aes";
+    templateFile = homeEnv + "/nx_plugin_config.yaml";
+
+    // the template is validated and written by genS3Config(), which is the only user of it, so
+    // that creating the Engine while the Server loads the plugins does no file I/O
+}
+
+// generated on demand: only needed when the template file is missing or outdated
+std::string CloudfuseMngr::configTemplate()
+{
+    const std::string systemName = getSystemName();
+    return templateVersionString + R"(
 allow-other: true
 nonempty: true
 
@@ -86,104 +107,7 @@ s3storage:
   endpoint: { ENDPOINT }
   enable-dir-marker: true
   enable-checksum: true
-  subdirectory: )" + systemName +
-                      "\n";
-
-    std::string homeEnv;
-    const char *home = std::getenv("HOME");
-    if (home == nullptr)
-    {
-        homeEnv = "";
-    }
-    else
-    {
-        homeEnv = home;
-    }
-    mountDir = homeEnv + "/cloudfuse";
-    fileCacheDir = homeEnv + "/cloudfuse_cache";
-    configFile = homeEnv + "/nx_plugin_config.aes";
-    templateFile = homeEnv + "/nx_plugin_config.yaml";
-
-    if (!templateValid())
-    {
-        writeTemplate();
-    }
-}
-
-processReturn ChildProcess::spawnProcess(char *const argv[], char *const envp[])
-{
-    processReturn ret;
-
-    int pipefd[2];
-    if (pipe(pipefd) == -1)
-    {
-        ret.errCode = 1;
-        return ret;
-    }
-
-    pid_t pid = fork();
-    if (pid == -1)
-    {
-        // Fork failed
-        close(pipefd[0]);
-        close(pipefd[1]);
-        ret.errCode = 1;
-        return ret;
-    }
-    else if (pid != 0)
-    {
-        // Parent process
-        close(pipefd[1]); // Close write end of pipe
-
-        char buffer[4096];
-        int bytesRead;
-        while ((bytesRead = read(pipefd[0], buffer, sizeof(buffer))) > 0)
-        {
-            ret.output.append(buffer, bytesRead);
-        }
-
-        close(pipefd[0]); // Close read end of pipe
-
-        // Wait for cloudfuse command to stop
-        int status;
-        waitpid(pid, &status, 0);
-        if (WIFEXITED(status))
-        {
-            ret.errCode = WEXITSTATUS(status);
-            return ret;
-        }
-        else if (WIFSIGNALED(status))
-        {
-            ret.errCode = WTERMSIG(status);
-            return ret;
-        }
-
-        ret.errCode = WTERMSIG(status);
-        return ret;
-    }
-    else
-    {
-        // Child process
-        close(pipefd[0]); // Close read end of pipe
-
-        if (dup2(pipefd[1], STDOUT_FILENO) == -1 || dup2(pipefd[1], STDERR_FILENO) == -1)
-        {
-            close(pipefd[1]);
-            exit(EXIT_FAILURE);
-        }
-
-        close(pipefd[1]); // Close write end of pipe
-
-        execve(argv[0], argv, envp);
-
-        // if execve succeeded, none of the following lines will run
-        // print an error message to STDERR, which is piped to the parent
-        // this should prevent the parent from hanging (maybe)
-        char errorMessage[256];
-        std::snprintf(errorMessage, sizeof(errorMessage), "execve(%s, ...) failed", argv[0]);
-        perror(errorMessage);
-        exit(EXIT_FAILURE);
-    }
+  subdirectory: )" + systemName + "\n";
 }
 
 processReturn CloudfuseMngr::genS3Config(const std::string endpoint, const std::string bucketName,
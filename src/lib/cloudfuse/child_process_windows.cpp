@@ -75,11 +75,41 @@ std::string getSystemName()
 
 CloudfuseMngr::CloudfuseMngr()
 {
-    // generate template contents
-    std::string systemName = getSystemName();
     // NOTE: increment the version number when the config template changes
     templateVersionString = "template-version: 0.6";
-    config_template = templateVersionString + R"(
+
+    std::string appdataEnv;
+    char *buf = nullptr;
+    size_t len;
+    if (_dupenv_s(&buf, &len, "APPDATA") == 0 && buf != nullptr)
+    {
+        appdataEnv = std::string(buf);
+        free(buf);
+    }
+    else
+    {
+        appdataEnv = "";
+    }
+
+    const fs::path appdata(appdataEnv);
+    const fs::path fileCacheDirPath = appdata / fs::path("Cloudfuse\\cloudfuse_cache");
+    const fs::path configFilePath = appdata / fs::path("Cloudfuse\\nx_plugin_config.aes");
+    const fs::path templateFilePath = appdata / fs::path("Cloudfuse\\nx_plugin_config.yaml");
+
+    mountDir = getAvailableDriveLetter();
+    fileCacheDir = fileCacheDirPath.generic_string();
+    configFile = configFilePath.generic_string();
+    templateFile = templateFilePath.generic_string();
+
+    // the template is validated and written by genS3Config(), which is the only user of it, so
+    // that creating the Engine while the Server loads the plugins does no file I/O
+}
+
+// generated on demand: only needed when the template file is missing or outdated
+std::string CloudfuseMngr::configTemplate()
+{
+    const std::string systemName = getSystemName();
+    return templateVersionString + R"(
 allow-other: true
 logging:
   type: base
@@ -115,36 +145,7 @@ s3storage:
   endpoint: { ENDPOINT }
   enable-dir-marker: true
   enable-checksum: true
-  subdirectory: )" + systemName +
-                      "\n";
-
-    std::string appdataEnv;
-    char *buf = nullptr;
-    size_t len;
-    if (_dupenv_s(&buf, &len, "APPDATA") == 0 && buf != nullptr)
-    {
-        appdataEnv = std::string(buf);
-        free(buf);
-    }
-    else
-    {
-        appdataEnv = "";
-    }
-
-    const fs::path appdata(appdataEnv);
-    const fs::path fileCacheDirPath = appdata / fs::path("Cloudfuse\\cloudfuse_cache");
-    const fs::path configFilePath = appdata / fs::path("Cloudfuse\\nx_plugin_config.aes");
-    const fs::path templateFilePath = appdata / fs::path("Cloudfuse\\nx_plugin_config.yaml");
-
-    mountDir = getAvailableDriveLetter();
-    fileCacheDir = fileCacheDirPath.generic_string();
-    configFile = configFilePath.generic_string();
-    templateFile = templateFilePath.generic_string();
-
-    if (!templateValid())
-    {
-        writeTemplate();
-    }
+  subdirectory: )" + systemName + "\n";
 }
 
 using HandleGuard = std::unique_ptr<void, decltype(&::CloseHandle)>;
@@ -217,128 +218,6 @@ bool createNamedPipeForCurrentUser(HANDLE &hPipeOut, std::wstring &pipeNameOut)
     return true;
 }
 
-processReturn ChildProcess::spawnProcess(wchar_t *argv, std::wstring envp)
-{
-    processReturn ret;
-
-    STARTUPINFO si;
-    PROCESS_INFORMATION pi;
-
-    // Set the bInheritHandle flag so pipe handles are inherited.
-    SECURITY_ATTRIBUTES sa;
-    sa.nLength = sizeof(sa);
-    sa.lpSecurityDescriptor = NULL;
-    sa.bInheritHandle = TRUE;
-
-    HANDLE hReadStdOut, hWriteStdOut, hReadStdErr, hWriteStdErr;
-    // Create a pipe for the child process's STDOUT.
-    if (!CreatePipe(&hReadStdOut, &hWriteStdOut, &sa, 0))
-    {
-        ret.errCode = 1;
-        return ret;
-    }
-    // Ensure the read handle to the pipe for STDOUT is not inherited.
-    if (!SetHandleInformation(hReadStdOut, HANDLE_FLAG_INHERIT, 0))
-    {
-        ret.errCode = 1;
-        return ret;
-    }
-
-    // Create a pipe for the child process's STDERR.
-    if (!CreatePipe(&hReadStdErr, &hWriteStdErr, &sa, 0))
-    {
-        ret.errCode = 1;
-        return ret;
-    }
-    // Ensure the read handle to the pipe for STDERR is not inherited.
-    if (!SetHandleInformation(hReadStdErr, HANDLE_FLAG_INHERIT, 0))
-    {
-        ret.errCode = 1;
-        return ret;
-    }
-
-    ZeroMemory(&si, sizeof(si));
-    si.cb = sizeof(si);
-    si.hStdOutput = hWriteStdOut;
-    si.hStdError = hWriteStdErr;
-    si.dwFlags |= STARTF_USESTDHANDLES;
-    ZeroMemory(&pi, sizeof(pi));
-
-    LPVOID lpvEnv = GetEnvironmentStringsW();
-
-    // If the returned pointer is NULL, exit.
-    if (lpvEnv == NULL)
-    {
-        printf("GetEnvironmentStrings failed (%d)\n", GetLastError());
-        ret.errCode = 1;
-        return ret;
-    }
-
-    // Append current environment to new environment variables
-    LPTSTR lpszVariable = (LPTSTR)lpvEnv;
-    while (*lpszVariable)
-    {
-        envp += lpszVariable;
-        envp += L'\0';
-        lpszVariable += lstrlen(lpszVariable) + 1;
-    }
-
-    // Environment block must be double null terminated
-    envp += L'\0';
-
-    // Start the child process.
-    if (!CreateProcessW(NULL,                       // No module name (use command line)
-                        LPWSTR(argv),               // Command line
-                        NULL,                       // Process handle not inheritable
-                        NULL,                       // Thread handle not inheritable
-                        TRUE,                       // Set handle inheritance to FALSE
-                        CREATE_UNICODE_ENVIRONMENT, // Use unicode environment
-                        (LPVOID)envp.c_str(),       // Use new environment
-                        NULL,                       // Use parent's starting directory
-                        &si,                        // Pointer to STARTUPINFO structure
-                        &pi)                        // Pointer to PROCESS_INFORMATION structure
-    )
-    {
-        CloseHandle(hWriteStdOut);
-        CloseHandle(hReadStdOut);
-        CloseHandle(hWriteStdErr);
-        CloseHandle(hReadStdErr);
-        printf("CreateProcess failed (%d).\n", GetLastError());
-        ret.errCode = 1;
-        return ret;
-    }
-
-    CloseHandle(hWriteStdOut);
-    CloseHandle(hWriteStdErr);
-
-    // Wait until child process exits.
-    unsigned long errCode;
-    WaitForSingleObject(pi.hProcess, INFINITE);
-    GetExitCodeProcess(pi.hProcess, &errCode);
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
-    ret.errCode = errCode;
-
-    const int BUFSIZE = 4096;
-    DWORD bytesRead;
-    CHAR buffer[BUFSIZE];
-    while (ReadFile(hReadStdOut, buffer, BUFSIZE - 1, &bytesRead, NULL) && bytesRead > 0)
-    {
-        buffer[bytesRead] = 0;
-        ret.output.append(buffer);
-    }
-    while (ReadFile(hReadStdErr, buffer, BUFSIZE - 1, &bytesRead, NULL) && bytesRead > 0)
-    {
-        buffer[bytesRead] = 0;
-        ret.output.append(buffer);
-    }
-
-    // Close handles.
-    CloseHandle(hReadStdOut);
-    CloseHandle(hReadStdErr);
-    return ret;
-}
-
 processReturn CloudfuseMngr::genS3Config(const std::string accessKeyId, const std::string secretAccessKey,
                                          const std::string endpoint, const std::string bucketName,
                                          const uint64_t bucketSizeMb, const std::string passphrase)
@@ -0,0 +1,114 @@
+/*
+   Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+   Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE
+*/
+
+#if defined(__linux__)
+#include "child_process.h"
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <nx/kit/debug.h>
+
+processReturn ChildProcess::spawnProcess(char *const argv[], char *const envp[])
+{
+    NX_TIME_HISTOGRAM("spawnProcess");
+    processReturn ret;
+
+    int pipefd[2];
+    if (pipe(pipefd) == -1)
+    {
+        ret.errCode = 1;
+        return ret;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1)
+    {
+        // Fork failed
+        close(pipefd[0]);
+        close(pipefd[1]);
+        ret.errCode = 1;
+        return ret;
+    }
+    else if (pid != 0)
+    {
+        // Parent process
+        close(pipefd[1]); // Close write end of pipe
+
+        char buffer[4096];
+        int bytesRead;
+        while ((bytesRead = read(pipefd[0], buffer, sizeof(buffer))) > 0)
+        {
+            ret.output.append(buffer, bytesRead);
+        }
+
+        close(pipefd[0]); // Close read end of pipe
+
+        // Wait for cloudfuse command to stop
+        int status;
+        waitpid(pid, &status, 0);
+        if (WIFEXITED(status))
+        {
+            ret.errCode = WEXITSTATUS(status);
+            return ret;
+        }
+        else if (WIFSIGNALED(status))
+        {
+            ret.errCode = WTERMSIG(status);
+            return ret;
+        }
+
+        ret.errCode = WTERMSIG(status);
+        return ret;
+    }
+    else
+    {
+        // Child process
+        close(pipefd[0]); // Close read end of pipe
+
+        if (dup2(pipefd[1], STDOUT_FILENO) == -1 || dup2(pipefd[1], STDERR_FILENO) == -1)
+        {
+            close(pipefd[1]);
+            _exit(EXIT_FAILURE);
+        }
+
+        close(pipefd[1]); // Close write end of pipe
+
+        execve(argv[0], argv, envp);
+
+        // if execve succeeded, none of the following lines will run
+        // print an error message to STDERR, which is piped to the parent
+        // this should prevent the parent from hanging (maybe)
+        char errorMessage[256];
+        std::snprintf(errorMessage, sizeof(errorMessage), "execve(%s, ...) failed", argv[0]);
+        perror(errorMessage);
+        // the child is a copy of a multithreaded process: exit() would run its static destructors
+        // and atexit handlers, which may wait for threads or locks that do not exist in the child,
+        // keeping the pipe open and the parent waiting forever
+        _exit(EXIT_FAILURE);
+    }
+}
+
+#endif
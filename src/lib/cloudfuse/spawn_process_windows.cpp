@@ -0,0 +1,164 @@
+/*
+   Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+   Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE
+*/
+
+#ifdef _WIN32
+#include "child_process.h"
+
+#ifndef UNICODE
+#define UNICODE
+#define UNICODE_WAS_UNDEFINED
+#endif
+#include <windows.h>
+#ifdef UNICODE_WAS_UNDEFINED
+#undef UNICODE
+#endif
+
+#include <cstdio>
+
+#include <nx/kit/debug.h>
+
+processReturn ChildProcess::spawnProcess(wchar_t *argv, std::wstring envp)
+{
+    NX_TIME_HISTOGRAM("spawnProcess");
+    processReturn ret;
+
+    STARTUPINFO si;
+    PROCESS_INFORMATION pi;
+
+    // Set the bInheritHandle flag so pipe handles are inherited.
+    SECURITY_ATTRIBUTES sa;
+    sa.nLength = sizeof(sa);
+    sa.lpSecurityDescriptor = NULL;
+    sa.bInheritHandle = TRUE;
+
+    HANDLE hReadStdOut, hWriteStdOut, hReadStdErr, hWriteStdErr;
+    // Create a pipe for the child process's STDOUT.
+    if (!CreatePipe(&hReadStdOut, &hWriteStdOut, &sa, 0))
+    {
+        ret.errCode = 1;
+        return ret;
+    }
+    // Ensure the read handle to the pipe for STDOUT is not inherited.
+    if (!SetHandleInformation(hReadStdOut, HANDLE_FLAG_INHERIT, 0))
+    {
+        ret.errCode = 1;
+        return ret;
+    }
+
+    // Create a pipe for the child process's STDERR.
+    if (!CreatePipe(&hReadStdErr, &hWriteStdErr, &sa, 0))
+    {
+        ret.errCode = 1;
+        return ret;
+    }
+    // Ensure the read handle to the pipe for STDERR is not inherited.
+    if (!SetHandleInformation(hReadStdErr, HANDLE_FLAG_INHERIT, 0))
+    {
+        ret.errCode = 1;
+        return ret;
+    }
+
+    ZeroMemory(&si, sizeof(si));
+    si.cb = sizeof(si);
+    si.hStdOutput = hWriteStdOut;
+    si.hStdError = hWriteStdErr;
+    si.dwFlags |= STARTF_USESTDHANDLES;
+    ZeroMemory(&pi, sizeof(pi));
+
+    LPVOID lpvEnv = GetEnvironmentStringsW();
+
+    // If the returned pointer is NULL, exit.
+    if (lpvEnv == NULL)
+    {
+        printf("GetEnvironmentStrings failed (%d)\n", GetLastError());
+        ret.errCode = 1;
+        return ret;
+    }
+
+    // Append current environment to new environment variables
+    LPTSTR lpszVariable = (LPTSTR)lpvEnv;
+    while (*lpszVariable)
+    {
+        envp += lpszVariable;
+        envp += L'\0';
+        lpszVariable += lstrlen(lpszVariable) + 1;
+    }
+
+    // Environment block must be double null terminated
+    envp += L'\0';
+
+    // Start the child process.
+    if (!CreateProcessW(NULL,                       // No module name (use command line)
+                        LPWSTR(argv),               // Command line
+                        NULL,                       // Process handle not inheritable
+                        NULL,                       // Thread handle not inheritable
+                        TRUE,                       // Set handle inheritance to FALSE
+                        CREATE_UNICODE_ENVIRONMENT, // Use unicode environment
+                        (LPVOID)envp.c_str(),       // Use new environment
+                        NULL,                       // Use parent's starting directory
+                        &si,                        // Pointer to STARTUPINFO structure
+                        &pi)                        // Pointer to PROCESS_INFORMATION structure
+    )
+    {
+        CloseHandle(hWriteStdOut);
+        CloseHandle(hReadStdOut);
+        CloseHandle(hWriteStdErr);
+        CloseHandle(hReadStdErr);
+        printf("CreateProcess failed (%d).\n", GetLastError());
+        ret.errCode = 1;
+        return ret;
+    }
+
+    CloseHandle(hWriteStdOut);
+    CloseHandle(hWriteStdErr);
+
+    // Wait until child process exits.
+    unsigned long errCode;
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    GetExitCodeProcess(pi.hProcess, &errCode);
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+    ret.errCode = errCode;
+
+    const int BUFSIZE = 4096;
+    DWORD bytesRead;
+    CHAR buffer[BUFSIZE];
+    while (ReadFile(hReadStdOut, buffer, BUFSIZE - 1, &bytesRead, NULL) && bytesRead > 0)
+    {
+        buffer[bytesRead] = 0;
+        ret.output.append(buffer);
+    }
+    while (ReadFile(hReadStdErr, buffer, BUFSIZE - 1, &bytesRead, NULL) && bytesRead > 0)
+    {
+        buffer[bytesRead] = 0;
+        ret.output.append(buffer);
+    }
+
+    // Close handles.
+    CloseHandle(hReadStdOut);
+    CloseHandle(hReadStdErr);
+    return ret;
+}
+
+#endif
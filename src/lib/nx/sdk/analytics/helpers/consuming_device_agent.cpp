@@ -2,6 +2,10 @@
 
 #include "consuming_device_agent.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
 #include <nx/sdk/helpers/log_utils.h>
 #include <nx/sdk/ptr.h>
 #include <nx/sdk/helpers/string.h>
@@ -23,6 +27,40 @@
 
 namespace nx::sdk::analytics {
 
+struct ConsumingDeviceAgent::AsyncDataProcessing
+{
+    AsyncDataProcessing(int queueCapacity, DataPacketQueue::DropPolicy dropPolicy):
+        queue(queueCapacity, dropPolicy)
+    {
+    }
+
+    DataPacketQueue queue;
+    std::thread worker;
+    std::atomic<bool> isRunning{false};
+    std::atomic<bool> isStopRequested{false};
+
+    /** Lets producers skip locking the mutex while the worker has packets to process. */
+    std::atomic<bool> isWorkerWaiting{false};
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+
+    std::atomic<int> maxQueueDepth{0};
+    std::atomic<int64_t> processedCount{0};
+    std::atomic<int64_t> lastLatencyNs{0};
+    std::atomic<int64_t> maxLatencyNs{0};
+    std::atomic<int64_t> totalLatencyNs{0};
+};
+
+template<typename Value>
+static void updateMax(std::atomic<Value>* maxValue, Value value)
+{
+    Value current = maxValue->load(std::memory_order_relaxed);
+    while (value > current
+        && !maxValue->compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
 static std::string makePrintPrefix(
     const std::string& pluginInstanceId, const IDeviceInfo* deviceInfo)
 {
@@ -44,6 +82,11 @@ ConsumingDeviceAgent::ConsumingDeviceAgent(
 
 ConsumingDeviceAgent::~ConsumingDeviceAgent()
 {
+    // The derived part is already destroyed, so the worker cannot be stopped safely here: it may
+    // be calling the derived virtual methods right now.
+    NX_KIT_ASSERT(!m_asyncDataProcessing || !m_asyncDataProcessing->worker.joinable(),
+        "The async data processing must be stopped by finalize() or stopAsyncDataProcessing() "
+        "before the DeviceAgent is destroyed.");
     NX_PRINT << "Destroyed " << this;
 }
 
@@ -74,8 +117,49 @@ void ConsumingDeviceAgent::setHandler(IDeviceAgent::IHandler* handler)
     m_handler = shareToPtr(handler);
 }
 
+Ptr<IDeviceAgent::IHandler> ConsumingDeviceAgent::handler() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_handler;
+}
+
 void ConsumingDeviceAgent::doPushDataPacket(
     Result<void>* outResult, IDataPacket* dataPacket)
+{
+    if (dataPacket && m_asyncDataProcessing && m_asyncDataProcessing->isRunning)
+    {
+        AsyncDataProcessing& async = *m_asyncDataProcessing;
+        if (!async.queue.push(dataPacket))
+        {
+            NX_OUTPUT << __func__ << "(): The queue of " << async.queue.capacity()
+                << " packets is full; dropped a packet.";
+        }
+        updateMax(&async.maxQueueDepth, async.queue.size());
+
+        // Pairs with the fence in runAsyncDataProcessing(): either the worker sees the packet, or
+        // we see that the worker is about to sleep. Pairs with the fence in
+        // stopAsyncDataProcessing() likewise: either its final drain sees the packet, or we see
+        // that it has stopped, and drop the packet ourselves instead of leaving it in the queue.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!async.isRunning.load(std::memory_order_relaxed))
+        {
+            for (DataPacketQueue::Item item; async.queue.pop(&item); )
+            {
+            }
+            return;
+        }
+        if (async.isWorkerWaiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(async.mutex);
+            async.wakeUp.notify_one();
+        }
+        return;
+    }
+
+    processDataPacket(outResult, dataPacket);
+}
+
+void ConsumingDeviceAgent::processDataPacket(Result<void>* outResult, IDataPacket* dataPacket)
 {
     const auto logError =
         [this, outResult, func = __func__](ErrorCode errorCode, const std::string& message)
@@ -117,7 +201,7 @@ void ConsumingDeviceAgent::doPushDataPacket(
         return logError(ErrorCode::invalidParams, "Unsupported frame supplied; ignored.");
     }
 
-    if (!m_handler)
+    if (!handler())
         return logError(ErrorCode::internalError, "setHandler() was not called.");
 
     std::vector<IMetadataPacket*> metadataPackets;
@@ -138,11 +222,9 @@ void ConsumingDeviceAgent::processMetadataPackets(
             << " metadata packet(s).";
     }
 
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        for (int i = 0; i < (int) metadataPackets.size(); ++i)
-            processMetadataPacket(Ptr(metadataPackets.at(i)).get(), i);
-    }
+    const auto handler = this->handler();
+    for (int i = 0; i < (int) metadataPackets.size(); ++i)
+        processMetadataPacket(handler.get(), Ptr(metadataPackets.at(i)).get(), i);
 }
 
 static std::string packetIndexName(int packetIndex)
@@ -151,9 +233,9 @@ static std::string packetIndexName(int packetIndex)
 }
 
 void ConsumingDeviceAgent::processMetadataPacket(
-    IMetadataPacket* metadataPacket, int packetIndex = -1)
+    IDeviceAgent::IHandler* handler, IMetadataPacket* metadataPacket, int packetIndex = -1)
 {
-    if (!m_handler)
+    if (!handler)
     {
         NX_PRINT << __func__ << "(): "
             << "INTERNAL ERROR: setHandler() was not called; ignoring the packet";
@@ -168,7 +250,7 @@ void ConsumingDeviceAgent::processMetadataPacket(
 
     logMetadataPacketIfNeeded(metadataPacket, packetIndex);
     NX_KIT_ASSERT(metadataPacket->timestampUs() >= 0);
-    m_handler->handleMetadata(metadataPacket);
+    handler->handleMetadata(metadataPacket);
 }
 
 void ConsumingDeviceAgent::getManifest(Result<const IString*>* outResult) const
@@ -193,6 +275,7 @@ void ConsumingDeviceAgent::getPluginSideSettings(
 void ConsumingDeviceAgent::finalize()
 {
     NX_OUTPUT << __func__ << "()";
+    stopAsyncDataProcessing();
 }
 
 void ConsumingDeviceAgent::doGetSettingsOnActiveSettingChange(
@@ -207,9 +290,15 @@ void ConsumingDeviceAgent::doGetSettingsOnActiveSettingChange(
 void ConsumingDeviceAgent::pushMetadataPacket(
     IMetadataPacket* metadataPacket)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    processMetadataPacket(metadataPacket);
-    metadataPacket->releaseRef();
+    processMetadataPacket(handler().get(), metadataPacket);
+    if (metadataPacket)
+        metadataPacket->releaseRef();
+}
+
+void ConsumingDeviceAgent::pushMetadataPackets(
+    const std::vector<IMetadataPacket*>& metadataPackets)
+{
+    processMetadataPackets(metadataPackets);
 }
 
 void ConsumingDeviceAgent::pushPluginDiagnosticEvent(
@@ -217,8 +306,8 @@ void ConsumingDeviceAgent::pushPluginDiagnosticEvent(
     std::string caption,
     std::string description) const
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (!m_handler)
+    const auto handler = this->handler();
+    if (!handler)
     {
         NX_PRINT << __func__ << "(): "
             << "INTERNAL ERROR: setHandler() was not called; ignoring Plugin Diagnostic Event.";
@@ -230,7 +319,7 @@ void ConsumingDeviceAgent::pushPluginDiagnosticEvent(
 
     NX_OUTPUT << "Producing Plugin Diagnostic Event:\n" + event->toString();
 
-    m_handler->handlePluginDiagnosticEvent(event.get());
+    handler->handlePluginDiagnosticEvent(event.get());
 }
 
 // TODO: Consider making a template with param type, checked according to the manifest.
@@ -240,7 +329,7 @@ std::string ConsumingDeviceAgent::settingValue(const std::string& settingName) c
     if (it != m_settings.end())
         return it->second;
 
-    NX_PRINT << "ERROR: Requested setting "
+    NX_LOG_ERROR << "Requested setting "
         << nx::kit::utils::toString(settingName) << " is missing; implying empty string.";
     return "";
 }
@@ -253,14 +342,102 @@ std::map<std::string, std::string> ConsumingDeviceAgent::currentSettings() const
 void ConsumingDeviceAgent::pushManifest(const std::string& manifest)
 {
     const auto manifestSdkString = nx::sdk::makePtr<nx::sdk::String>(manifest);
-    m_handler->pushManifest(manifestSdkString.get());
+    if (const auto handler = this->handler())
+        handler->pushManifest(manifestSdkString.get());
+    else
+        NX_PRINT << __func__ << "(): INTERNAL ERROR: setHandler() was not called; ignoring it.";
+}
+
+void ConsumingDeviceAgent::startAsyncDataProcessing(
+    int queueCapacity, DataPacketQueue::DropPolicy dropPolicy)
+{
+    if (!NX_KIT_ASSERT(!m_asyncDataProcessing, "Async data processing has already been started."))
+        return;
+
+    m_asyncDataProcessing = std::make_unique<AsyncDataProcessing>(queueCapacity, dropPolicy);
+    m_asyncDataProcessing->isRunning = true;
+    m_asyncDataProcessing->worker = std::thread([this]() { runAsyncDataProcessing(); });
+    NX_OUTPUT << __func__ << "(): Queue capacity: " << m_asyncDataProcessing->queue.capacity();
+}
+
+void ConsumingDeviceAgent::stopAsyncDataProcessing()
+{
+    if (!m_asyncDataProcessing || !m_asyncDataProcessing->worker.joinable())
+        return;
+
+    AsyncDataProcessing& async = *m_asyncDataProcessing;
+    async.isRunning = false; //< Further packets, if any, will be processed synchronously.
+    {
+        std::lock_guard<std::mutex> lock(async.mutex);
+        async.isStopRequested = true;
+    }
+    async.wakeUp.notify_one();
+    async.worker.join();
+
+    // See doPushDataPacket().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int droppedCount = 0;
+    for (DataPacketQueue::Item item; async.queue.pop(&item); )
+        ++droppedCount;
+    NX_OUTPUT << __func__ << "(): Dropped " << droppedCount << " queued packet(s).";
+}
+
+ConsumingDeviceAgent::AsyncDataProcessingStatistics
+    ConsumingDeviceAgent::asyncDataProcessingStatistics() const
+{
+    AsyncDataProcessingStatistics statistics;
+    if (!m_asyncDataProcessing)
+        return statistics;
+
+    const AsyncDataProcessing& async = *m_asyncDataProcessing;
+    statistics.queueDepth = async.queue.size();
+    statistics.maxQueueDepth = async.maxQueueDepth.load(std::memory_order_relaxed);
+    statistics.processedCount = async.processedCount.load(std::memory_order_relaxed);
+    statistics.droppedCount = async.queue.droppedCount();
+    statistics.lastLatencyUs = async.lastLatencyNs.load(std::memory_order_relaxed) / 1000;
+    statistics.maxLatencyUs = async.maxLatencyNs.load(std::memory_order_relaxed) / 1000;
+    if (statistics.processedCount > 0)
+    {
+        statistics.averageLatencyUs = async.totalLatencyNs.load(std::memory_order_relaxed)
+            / statistics.processedCount / 1000;
+    }
+    return statistics;
+}
+
+void ConsumingDeviceAgent::runAsyncDataProcessing()
+{
+    AsyncDataProcessing& async = *m_asyncDataProcessing;
+    DataPacketQueue::Item item;
+    while (!async.isStopRequested)
+    {
+        if (async.queue.pop(&item))
+        {
+            const int64_t latencyNs = DataPacketQueue::nowNs() - item.enqueuedAtNs;
+            async.lastLatencyNs.store(latencyNs, std::memory_order_relaxed);
+            updateMax(&async.maxLatencyNs, latencyNs);
+            async.totalLatencyNs.fetch_add(latencyNs, std::memory_order_relaxed);
+
+            Result<void> result; //< Errors are logged by processDataPacket().
+            processDataPacket(&result, item.packet.get());
+            item.packet.reset();
+            async.processedCount.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(async.mutex);
+        async.isWorkerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        async.wakeUp.wait(lock,
+            [&async]() { return async.isStopRequested || async.queue.size() > 0; });
+        async.isWorkerWaiting.store(false, std::memory_order_relaxed);
+    }
 }
 
 void ConsumingDeviceAgent::logMetadataPacketIfNeeded(
     const IMetadataPacket* metadataPacket,
     int packetIndex) const
 {
-    if (!NX_DEBUG_ENABLE_OUTPUT || !NX_KIT_ASSERT(metadataPacket))
+    if (!NX_LOG_ENABLED(NX_LOG_LEVEL_DEBUG) || !NX_KIT_ASSERT(metadataPacket))
         return;
 
     std::string packetName;
@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -14,6 +16,7 @@
 #include <nx/sdk/analytics/i_engine.h>
 #include <nx/sdk/analytics/i_metadata_types.h>
 #include <nx/sdk/analytics/i_uncompressed_video_frame.h>
+#include <nx/sdk/analytics/helpers/data_packet_queue.h>
 #include <nx/sdk/helpers/log_utils.h>
 #include <nx/sdk/helpers/ref_countable.h>
 #include <nx/sdk/ptr.h>
@@ -35,6 +38,20 @@ namespace nx::sdk::analytics {
  */
 class ConsumingDeviceAgent: public RefCountable<IConsumingDeviceAgent>
 {
+public:
+    struct AsyncDataProcessingStatistics
+    {
+        int queueDepth = 0;
+        int maxQueueDepth = 0;
+        int64_t processedCount = 0;
+        int64_t droppedCount = 0;
+
+        /** Time from enqueueing a packet to the start of its processing. */
+        int64_t lastLatencyUs = 0;
+        int64_t maxLatencyUs = 0;
+        int64_t averageLatencyUs = 0;
+    };
+
 protected:
     const LogUtils logUtils;
 
@@ -83,9 +100,18 @@ protected:
     /**
      * Send a newly constructed metadata packet to Server. Can be called at any time, from any
      * thread. As an alternative, send metadata to Server by implementing pullMetadataPackets().
+     *
+     * NOTE: The packet is delivered outside of the internal lock, so the Server handler may be
+     * called concurrently by several threads pushing metadata.
      */
     void pushMetadataPacket(IMetadataPacket* metadataPacket);
 
+    /**
+     * Same as calling pushMetadataPacket() for each packet, but takes the internal lock once for
+     * the whole batch. Releases a reference to each packet.
+     */
+    void pushMetadataPackets(const std::vector<IMetadataPacket*>& metadataPackets);
+
     /**
      * Sends a PluginDiagnosticEvent to the Server. Can be called from any thread, but if called
      * before settingsReceived() was called, will be ignored in case setHandler() was not called
@@ -121,6 +147,32 @@ protected:
 
     void pushManifest(const std::string& pushManifest);
 
+    /**
+     * Makes doPushDataPacket() only enqueue the packet and return, and the push...() methods,
+     * pullMetadataPackets() and the delivery of the pulled metadata packets to be called on a
+     * dedicated worker thread, so that slow processing never blocks the Server media thread. When
+     * the queue is full, packets are dropped according to the drop policy.
+     *
+     * Intended to be called from the constructor of the derived class.
+     *
+     * ATTENTION: The worker must be stopped while the derived class is still alive, because the
+     * worker calls its virtual methods. finalize(), which the Server calls before releasing the
+     * DeviceAgent, does it; a derived class that overrides finalize() must call the base one, or
+     * call stopAsyncDataProcessing() itself. The destructor of this class only asserts that the
+     * worker has been stopped.
+     */
+    void startAsyncDataProcessing(
+        int queueCapacity,
+        DataPacketQueue::DropPolicy dropPolicy = DataPacketQueue::DropPolicy::dropOldest);
+
+    /**
+     * Stops the worker thread, dropping the queued packets; packets pushed afterwards are
+     * processed synchronously. Does nothing if not started.
+     */
+    void stopAsyncDataProcessing();
+
+    AsyncDataProcessingStatistics asyncDataProcessingStatistics() const;
+
     virtual void finalize() override;
 
     virtual void doGetSettingsOnActiveSettingChange(
@@ -144,16 +196,25 @@ protected:
     virtual void getManifest(Result<const IString*>* outResult) const override;
 
 private:
+    struct AsyncDataProcessing;
+
+    void processDataPacket(Result<void>* outResult, IDataPacket* dataPacket);
+    void runAsyncDataProcessing();
     void logMetadataPacketIfNeeded(
         const IMetadataPacket* metadataPacket,
         int packetIndex) const;
+    /** @return Handler set by setHandler(), or null; the lock is held only to copy the Ptr. */
+    Ptr<IDeviceAgent::IHandler> handler() const;
+
     void processMetadataPackets(const std::vector<IMetadataPacket*>& metadataPackets);
-    void processMetadataPacket(IMetadataPacket* metadataPacket, int packetIndex /*= -1*/);
+    void processMetadataPacket(
+        IDeviceAgent::IHandler* handler, IMetadataPacket* metadataPacket, int packetIndex /*= -1*/);
 
 private:
     mutable std::mutex m_mutex;
     Ptr<IDeviceAgent::IHandler> m_handler;
     std::map<std::string, std::string> m_settings;
+    std::unique_ptr<AsyncDataProcessing> m_asyncDataProcessing;
 };
 
 } // namespace nx::sdk::analytics
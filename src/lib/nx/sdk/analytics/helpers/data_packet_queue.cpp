@@ -0,0 +1,148 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "data_packet_queue.h"
+
+#include <chrono>
+#include <utility>
+
+#include <nx/sdk/analytics/i_compressed_video_packet.h>
+#include <nx/sdk/analytics/i_uncompressed_video_frame.h>
+
+namespace nx::sdk::analytics {
+
+struct DataPacketQueue::Slot
+{
+    std::atomic<size_t> sequence{0};
+    Item item;
+};
+
+static size_t roundUpToPowerOf2(int value)
+{
+    size_t result = 2;
+    while ((int) result < value)
+        result <<= 1;
+    return result;
+}
+
+static bool canBeProcessedOnItsOwn(IDataPacket* packet)
+{
+    if (const auto compressedFrame = packet->queryInterface<ICompressedVideoPacket>())
+    {
+        return (static_cast<uint32_t>(compressedFrame->flags())
+            & static_cast<uint32_t>(ICompressedVideoPacket::MediaFlags::keyFrame)) != 0;
+    }
+    return (bool) packet->queryInterface<IUncompressedVideoFrame>();
+}
+
+DataPacketQueue::DataPacketQueue(int capacity, DropPolicy dropPolicy):
+    m_dropPolicy(dropPolicy)
+{
+    const size_t slotCount = roundUpToPowerOf2(capacity);
+    m_mask = slotCount - 1;
+    m_slots.reset(new Slot[slotCount]);
+    for (size_t i = 0; i < slotCount; ++i)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+DataPacketQueue::~DataPacketQueue() = default;
+
+int64_t DataPacketQueue::nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+bool DataPacketQueue::push(IDataPacket* packet)
+{
+    Item item{shareToPtr(packet), nowNs()};
+    bool isAnyPacketDropped = false;
+    while (!tryPush(&item))
+    {
+        if (m_dropPolicy == DropPolicy::dropNonKey && !canBeProcessedOnItsOwn(packet))
+        {
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Item evictedItem;
+        if (pop(&evictedItem))
+        {
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            isAnyPacketDropped = true;
+        }
+    }
+    return !isAnyPacketDropped;
+}
+
+bool DataPacketQueue::tryPush(Item* item)
+{
+    Slot* slot = nullptr;
+    size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        slot = &m_slots[position & m_mask];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+        if (difference == 0)
+        {
+            if (m_enqueuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false; //< The slot still holds an item from the previous lap: full.
+        }
+        else
+        {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->item = std::move(*item);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool DataPacketQueue::pop(Item* outItem)
+{
+    Slot* slot = nullptr;
+    size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        slot = &m_slots[position & m_mask];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const intptr_t difference = (intptr_t) sequence - (intptr_t) (position + 1);
+        if (difference == 0)
+        {
+            if (m_dequeuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false; //< The slot has not been written in this lap: empty.
+        }
+        else
+        {
+            position = m_dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    *outItem = std::move(slot->item);
+    slot->sequence.store(position + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+int DataPacketQueue::size() const
+{
+    const size_t dequeuePosition = m_dequeuePosition.load(std::memory_order_relaxed);
+    const size_t enqueuePosition = m_enqueuePosition.load(std::memory_order_relaxed);
+    return enqueuePosition > dequeuePosition ? (int) (enqueuePosition - dequeuePosition) : 0;
+}
+
+} // namespace nx::sdk::analytics
@@ -0,0 +1,83 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <nx/sdk/analytics/i_data_packet.h>
+#include <nx/sdk/ptr.h>
+
+namespace nx::sdk::analytics {
+
+/**
+ * Bounded lock-free queue of data packets, intended to pass the packets from the Server threads
+ * to a DeviceAgent worker thread. Any number of threads may push and pop concurrently.
+ *
+ * Based on the bounded MPMC queue by Dmitry Vyukov: each slot has a sequence number telling
+ * whether it is ready to be written or read, so the threads contend only on the head and tail
+ * counters. Popping from any thread is what allows a producer to evict the oldest packet when the
+ * queue is full.
+ */
+class DataPacketQueue
+{
+public:
+    enum class DropPolicy
+    {
+        /** When the queue is full, the oldest queued packet is dropped to make room. */
+        dropOldest,
+
+        /**
+         * When the queue is full, the new packet is dropped, unless it can be processed on its
+         * own (a compressed video key frame or an uncompressed frame), in which case the oldest
+         * queued packet is dropped to make room.
+         */
+        dropNonKey,
+    };
+
+    struct Item
+    {
+        Ptr<IDataPacket> packet;
+        int64_t enqueuedAtNs = 0; /**< In terms of std::chrono::steady_clock. */
+    };
+
+    /** @param capacity Rounded up to a power of 2. */
+    DataPacketQueue(int capacity, DropPolicy dropPolicy);
+    ~DataPacketQueue();
+
+    /**
+     * Adds a reference to the packet and enqueues it, dropping a packet according to the drop
+     * policy if the queue is full.
+     * @return False if some packet (either this one or a queued one) has been dropped.
+     */
+    bool push(IDataPacket* packet);
+
+    /** @return False if the queue is empty. */
+    bool pop(Item* outItem);
+
+    /** @return Number of the queued packets; can be outdated by the time it is used. */
+    int size() const;
+
+    int capacity() const { return (int) (m_mask + 1); }
+    DropPolicy dropPolicy() const { return m_dropPolicy; }
+    int64_t droppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
+    static int64_t nowNs();
+
+private:
+    struct Slot;
+
+    bool tryPush(Item* item);
+
+private:
+    const DropPolicy m_dropPolicy;
+    size_t m_mask = 0;
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<size_t> m_enqueuePosition{0};
+    alignas(64) std::atomic<size_t> m_dequeuePosition{0};
+    alignas(64) std::atomic<int64_t> m_droppedCount{0};
+};
+
+} // namespace nx::sdk::analytics
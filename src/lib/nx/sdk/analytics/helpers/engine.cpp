@@ -43,17 +43,23 @@ Engine::Engine(bool enableOutput, const std::string& pluginInstanceId):
 // TODO: Consider making a template with param type, checked according to the manifest.
 std::string Engine::settingValue(const std::string& settingName) const
 {
-    const auto it = m_settings.find(settingName);
-    if (it != m_settings.end())
-        return it->second;
+    const auto settings = settingsSnapshot();
+    if (settings->contains(settingName))
+        return settings->value(settingName);
 
-    NX_PRINT << "ERROR: Requested setting "
+    NX_LOG_ERROR << "Requested setting "
         << nx::kit::utils::toString(settingName) << " is missing; implying empty string.";
     return "";
 }
 
 std::map<std::string, std::string> Engine::currentSettings() const
 {
+    return settingsSnapshot()->toMap();
+}
+
+std::shared_ptr<const SettingsSnapshot> Engine::settingsSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
     return m_settings;
 }
 
@@ -102,10 +108,21 @@ void Engine::setEngineInfo(const IEngineInfo* engineInfo)
 void Engine::doSetSettings(
     Result<const ISettingsResponse*>* outResult, const IStringMap* settings)
 {
-    if (!logUtils.convertAndOutputStringMap(&m_settings, settings, "Received settings"))
+    // The received values are merged into the current ones: the keys the Server omits keep their
+    // values, as they did before the settings became snapshots.
+    std::map<std::string, std::string> settingsMap = settingsSnapshot()->toMap();
+    if (!logUtils.convertAndOutputStringMap(&settingsMap, settings, "Received settings"))
+    {
         *outResult = error(ErrorCode::invalidParams, "Unable to convert the input string map");
-    else
-        *outResult = settingsReceived();
+        return;
+    }
+
+    auto snapshot = SettingsSnapshot::make(settingsMap);
+    {
+        std::lock_guard<std::mutex> lock(m_settingsMutex);
+        m_settings = std::move(snapshot);
+    }
+    *outResult = settingsReceived();
 }
 
 void Engine::getPluginSideSettings(Result<const ISettingsResponse*>* /*outResult*/) const
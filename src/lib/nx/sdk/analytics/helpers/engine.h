@@ -3,12 +3,14 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 
 #include <nx/sdk/analytics/i_engine.h>
 #include <nx/sdk/helpers/log_utils.h>
 #include <nx/sdk/helpers/ref_countable.h>
+#include <nx/sdk/helpers/settings_snapshot.h>
 #include <nx/sdk/i_string_map.h>
 #include <nx/sdk/ptr.h>
 #include <nx/sdk/result.h>
@@ -70,6 +72,13 @@ protected:
      */
     std::map<std::string, std::string> currentSettings() const;
 
+    /**
+     * Same as currentSettings(), but without copying: the returned snapshot is immutable and is
+     * replaced as a whole when the new settings are received, so it can be kept and compared with
+     * a later one cheaply.
+     */
+    std::shared_ptr<const SettingsSnapshot> settingsSnapshot() const;
+
     /**
      * Action handler. Called when some Action defined by this Engine is triggered by the Server.
      * @param actionId Id of the Action being triggered.
@@ -128,7 +137,8 @@ protected:
 
 private:
     mutable std::mutex m_mutex;
-    std::map<std::string, std::string> m_settings;
+    mutable std::mutex m_settingsMutex;
+    std::shared_ptr<const SettingsSnapshot> m_settings = SettingsSnapshot::empty();
     Ptr<IEngine::IHandler> m_handler;
     std::string m_pluginInstanceId;
 };
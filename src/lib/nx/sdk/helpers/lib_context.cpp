@@ -8,6 +8,8 @@
 
 namespace nx::sdk {
 
+std::atomic<bool> LibContext::s_hasRefCountableRegistry{false};
+
 void LibContext::setName(const char* name)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -39,6 +41,7 @@ void LibContext::setRefCountableRegistry(IRefCountableRegistry* refCountableRegi
     }
 
     m_refCountableRegistry.reset(refCountableRegistry);
+    s_hasRefCountableRegistry.store(m_refCountableRegistry != nullptr, std::memory_order_release);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -54,7 +55,18 @@ public:
     /** @return Null if the registry has not been set. */
     IRefCountableRegistry* refCountableRegistry() const { return m_refCountableRegistry.get(); }
 
+    /**
+     * Cheap check for the code creating and destroying ref-countable objects at a high rate: does
+     * not access the LibContext instance.
+     */
+    static bool hasRefCountableRegistry()
+    {
+        return s_hasRefCountableRegistry.load(std::memory_order_acquire);
+    }
+
 private:
+    static std::atomic<bool> s_hasRefCountableRegistry;
+
     static constexpr const char *kDefaultName = "unnamed_lib_context";
     std::string m_name = kDefaultName;
     std::unique_ptr<IRefCountableRegistry> m_refCountableRegistry;
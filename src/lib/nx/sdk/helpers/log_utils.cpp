@@ -25,18 +25,18 @@ bool LogUtils::convertAndOutputStringMap(
 {
     if (!stringMap)
     {
-        NX_PRINT << "ERROR: stringMap is null";
+        NX_LOG_ERROR << "stringMap is null";
         return false;
     }
 
     const auto count = stringMap->count();
     if (count < 0)
     {
-        NX_PRINT << "ERROR: " << caption << ": count is " << count;
+        NX_LOG_ERROR << caption << ": count is " << count;
         return false;
     }
 
-    if (NX_DEBUG_ENABLE_OUTPUT)
+    if (NX_LOG_ENABLED(NX_LOG_LEVEL_DEBUG))
     {
         const std::string indentStr(outputIndent, ' ');
 
@@ -53,8 +53,9 @@ bool LogUtils::convertAndOutputStringMap(
         NX_OUTPUT << indentStr << "}";
     }
 
+    // IStringMap items normally come sorted by key, so hinting the end makes each insertion O(1).
     for (int i = 0; i < count; ++i)
-        (*outMap)[stringMap->key(i)] = stringMap->value(i);
+        outMap->insert_or_assign(outMap->end(), stringMap->key(i), stringMap->value(i));
 
     return true;
 }
@@ -0,0 +1,212 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace nx::sdk {
+
+/**
+ * Opt-in recycling of the memory of objects of type T, intended for ref-countable helper objects
+ * which are created and destroyed at a high rate, like the ones making up a settings response.
+ * When enabled, the memory of a deleted object (on its final releaseRef()) is kept in a free list
+ * and reused for the next object of the same type instead of going to the heap.
+ *
+ * Disabled by default: until setEnabled(true) is called, objects are allocated and deallocated
+ * with the global operator new and operator delete, as if there was no pool.
+ *
+ * A type participates by inheriting PooledAllocation<T>. Objects of classes derived from T have
+ * a different size and always go to the heap.
+ *
+ * Thread-safe. The free lists are per-thread, so that recycling does not take any locks; the
+ * memory of an object deleted on another thread than it was created on is reused by that thread.
+ * setEnabled(false) stops the recycling in all threads at once; each thread frees the memory kept
+ * in its free list on its next allocation or deletion of a T, or when it exits. Objects deleted
+ * during the thread exit, after its free list has been destroyed, go to the heap.
+ */
+template<class T>
+class ObjectPool
+{
+public:
+    static constexpr int kDefaultMaxFreeObjects = 64;
+
+    /** The pool is never destroyed, so objects may be deleted during the static deinitialization. */
+    static ObjectPool& instance()
+    {
+        static ObjectPool* const pool = new ObjectPool();
+        return *pool;
+    }
+
+    /**
+     * @param maxFreeObjects How many deleted objects each thread keeps for reuse; the memory of
+     *     objects deleted when the free list is full goes back to the heap.
+     */
+    void setEnabled(bool enabled, int maxFreeObjects = kDefaultMaxFreeObjects)
+    {
+        m_maxFreeObjects.store(enabled ? maxFreeObjects : 0, std::memory_order_relaxed);
+        m_enabled.store(enabled, std::memory_order_relaxed);
+        if (!enabled)
+        {
+            m_generation.fetch_add(1, std::memory_order_relaxed); //< Invalidates all free lists.
+            currentFreeList();
+        }
+    }
+
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /** @return Number of allocations served from a free list while the pool was enabled. */
+    int64_t hitCount() const { return m_hitCount.load(std::memory_order_relaxed); }
+
+    /** @return Number of allocations which went to the heap while the pool was enabled. */
+    int64_t missCount() const { return m_missCount.load(std::memory_order_relaxed); }
+
+    /** @return Number of objects in the free list of the calling thread. */
+    int freeCount() const
+    {
+        const FreeList* const list = currentFreeList();
+        return list ? (int) list->blocks.size() : 0;
+    }
+
+    void resetCounters()
+    {
+        m_hitCount.store(0, std::memory_order_relaxed);
+        m_missCount.store(0, std::memory_order_relaxed);
+    }
+
+    void* allocate(std::size_t size)
+    {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+            "Over-aligned types are not supported by ObjectPool.");
+
+        if (size != sizeof(T) || !isEnabled())
+        {
+            freeStaleList();
+            return ::operator new(size);
+        }
+
+        FreeList* const list = currentFreeList();
+        if (list && !list->blocks.empty())
+        {
+            void* const p = list->blocks.back();
+            list->blocks.pop_back();
+            m_hitCount.fetch_add(1, std::memory_order_relaxed);
+            return p;
+        }
+        m_missCount.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    void deallocate(void* p, std::size_t size)
+    {
+        if (p == nullptr)
+            return;
+
+        if (size == sizeof(T) && isEnabled())
+        {
+            FreeList* const list = currentFreeList();
+            if (list && (int) list->blocks.size() < m_maxFreeObjects.load(std::memory_order_relaxed))
+            {
+                list->blocks.push_back(p);
+                return;
+            }
+        }
+        else
+        {
+            freeStaleList();
+        }
+        ::operator delete(p);
+    }
+
+private:
+    struct FreeList
+    {
+        std::vector<void*> blocks;
+        uint32_t generation = 0; //< Value of m_generation when the blocks were added.
+        bool* const isDestroyed;
+
+        FreeList(bool* isDestroyed): isDestroyed(isDestroyed) {}
+
+        ~FreeList()
+        {
+            clear();
+            *isDestroyed = true;
+        }
+
+        void clear()
+        {
+            for (void* const p: blocks)
+                ::operator delete(p);
+            blocks.clear();
+        }
+    };
+
+    ObjectPool() = default;
+
+    /** @return Free list of the calling thread, or null if it has been destroyed on thread exit. */
+    static FreeList* freeList()
+    {
+        // Has a trivial destructor, so it remains valid after the list is destroyed, e.g. when a
+        // destructor of another thread_local object deletes a T.
+        thread_local bool isDestroyed = false;
+        if (isDestroyed)
+            return nullptr;
+        thread_local FreeList list(&isDestroyed);
+        return &list;
+    }
+
+    /** @return Free list of the calling thread, emptied if the pool was disabled since filling it. */
+    FreeList* currentFreeList() const
+    {
+        FreeList* const list = freeList();
+        if (!list)
+            return nullptr;
+        const uint32_t generation = m_generation.load(std::memory_order_relaxed);
+        if (list->generation != generation)
+        {
+            list->clear();
+            list->generation = generation;
+        }
+        return list;
+    }
+
+    /** While the pool is disabled, frees the memory the calling thread may still keep. */
+    void freeStaleList() const
+    {
+        // Until the pool is disabled for the first time, there is nothing to free.
+        if (m_generation.load(std::memory_order_relaxed) != 0)
+            currentFreeList();
+    }
+
+private:
+    std::atomic<bool> m_enabled{false};
+    std::atomic<int> m_maxFreeObjects{0};
+    std::atomic<int64_t> m_hitCount{0};
+    std::atomic<int64_t> m_missCount{0};
+    std::atomic<uint32_t> m_generation{0}; //< Incremented each time the pool is disabled.
+};
+
+/**
+ * Base class which routes `new` and `delete` of the Derived class via ObjectPool<Derived>. The
+ * deleting destructor of a ref-countable object looks up operator delete in the scope of its
+ * dynamic type, so the final releaseRef() returns the memory to the pool.
+ */
+template<class Derived>
+class PooledAllocation
+{
+public:
+    static void* operator new(std::size_t size)
+    {
+        return ObjectPool<Derived>::instance().allocate(size);
+    }
+
+    static void operator delete(void* p, std::size_t size)
+    {
+        ObjectPool<Derived>::instance().deallocate(p, size);
+    }
+};
+
+} // namespace nx::sdk
@@ -4,12 +4,13 @@
 
 #include <string>
 
+#include <nx/sdk/helpers/object_pool.h>
 #include <nx/sdk/helpers/ref_countable.h>
 #include <nx/sdk/i_plugin_diagnostic_event.h>
 
 namespace nx::sdk {
 
-class PluginDiagnosticEvent: public RefCountable<IPluginDiagnosticEvent>
+class PluginDiagnosticEvent: public RefCountable<IPluginDiagnosticEvent>, public PooledAllocation<PluginDiagnosticEvent>
 {
 public:
     PluginDiagnosticEvent(Level level, std::string caption, std::string description);
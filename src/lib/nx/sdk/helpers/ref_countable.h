@@ -3,12 +3,39 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 
 #include <nx/sdk/helpers/lib_context.h>
 #include <nx/sdk/i_ref_countable.h>
 
 namespace nx::sdk {
 
+/**
+ * Memory ordering and layout of the reference counter, used as a template argument of
+ * BasicRefCountableHolder and RefCountable.
+ *
+ * Incrementing the counter needs no ordering, because a new reference can only be made from an
+ * existing one. Decrementing it needs acquire-release ordering, so that all the accesses to the
+ * object made via other references happen before the deletion.
+ */
+struct RefCountPolicy
+{
+    static constexpr std::memory_order kAddRefOrder = std::memory_order_relaxed;
+    static constexpr std::memory_order kReleaseRefOrder = std::memory_order_acq_rel;
+    static constexpr size_t kCounterAlignment = alignof(std::atomic<int>);
+};
+
+/**
+ * For objects which are referenced from several threads at a high rate, like media packets: puts
+ * the counter on its own cache line, padded on both sides, so that changing it does not
+ * invalidate the cache lines with the object data, at the cost of up to two cache lines of padding
+ * per object.
+ */
+struct CacheLineAlignedRefCountPolicy: RefCountPolicy
+{
+    static constexpr size_t kCounterAlignment = 64;
+};
+
 /**
  * Not recommended to be used directly - use RefCountable, unless there is some special case.
  *
@@ -20,14 +47,15 @@ namespace nx::sdk {
  * The instance is supposed to be nested into a ref-countable object, explicitly calling addRef()
  * and releaseRef() from the respective methods of that ref-countable class.
  */
-class RefCountableHolder
+template<class Policy = RefCountPolicy>
+class BasicRefCountableHolder
 {
 public:
-    RefCountableHolder(const RefCountableHolder&) = delete;
-    RefCountableHolder& operator=(const RefCountableHolder&) = delete;
-    RefCountableHolder(RefCountableHolder&&) = delete;
-    RefCountableHolder& operator=(RefCountableHolder&&) = delete;
-    ~RefCountableHolder() = default;
+    BasicRefCountableHolder(const BasicRefCountableHolder&) = delete;
+    BasicRefCountableHolder& operator=(const BasicRefCountableHolder&) = delete;
+    BasicRefCountableHolder(BasicRefCountableHolder&&) = delete;
+    BasicRefCountableHolder& operator=(BasicRefCountableHolder&&) = delete;
+    ~BasicRefCountableHolder() = default;
 
     /**
      * Takes ownership of the given object - it will be deleted when the reference counter
@@ -35,16 +63,21 @@ public:
      *
      * NOTE: After creation, the reference counter is 1.
      */
-    RefCountableHolder(const IRefCountable* refCountable): m_refCountable(refCountable) {}
+    BasicRefCountableHolder(const IRefCountable* refCountable): m_refCountable(refCountable) {}
 
     /**
      * Delegates reference counting to another object. Does not change the reference counter.
      */
-    RefCountableHolder(const RefCountableHolder* delegate): m_refCountHolderDelegate(delegate) {}
+    BasicRefCountableHolder(const BasicRefCountableHolder* delegate):
+        m_refCountHolderDelegate(delegate)
+    {
+    }
 
     int addRef() const
     {
-        return m_refCountHolderDelegate ? m_refCountHolderDelegate->addRef() : ++m_refCount;
+        if (m_refCountHolderDelegate)
+            return m_refCountHolderDelegate->addRef();
+        return m_refCount.value.fetch_add(1, Policy::kAddRefOrder) + 1;
     }
 
     /**
@@ -55,7 +88,7 @@ public:
         if (m_refCountHolderDelegate)
             return m_refCountHolderDelegate->releaseRef();
 
-        const int newRefCounter = --m_refCount;
+        const int newRefCounter = m_refCount.value.fetch_sub(1, Policy::kReleaseRefOrder) - 1;
         if (newRefCounter == 0)
             delete m_refCountable;
         return newRefCounter;
@@ -65,21 +98,32 @@ public:
     {
         if (m_refCountHolderDelegate)
             return m_refCountHolderDelegate->refCount();
-        return m_refCount;
+        return m_refCount.value.load(std::memory_order_relaxed);
     }
 
 private:
-    mutable std::atomic<int> m_refCount{1};
+    /** Aligning the struct also rounds its size up, so the members below start on the next line. */
+    struct alignas(Policy::kCounterAlignment) Counter
+    {
+        mutable std::atomic<int> value{1};
+    };
+
+    Counter m_refCount;
     const IRefCountable* const m_refCountable = nullptr;
-    const RefCountableHolder* const m_refCountHolderDelegate = nullptr;
+    const BasicRefCountableHolder* const m_refCountHolderDelegate = nullptr;
 };
 
+using RefCountableHolder = BasicRefCountableHolder<>;
+
 /**
  * Recommended base class for objects implementing an interface.
  *
- * Supports tracking the ref-countable objects via RefCountableRegistry.
+ * Supports tracking the ref-countable objects via RefCountableRegistry; when the registry is not
+ * installed, creating and destroying objects does not access LibContext at all.
+ *
+ * @param Policy See RefCountPolicy.
  */
-template<class RefCountableInterface>
+template<class RefCountableInterface, class Policy = RefCountPolicy>
 class RefCountable: public RefCountableInterface
 {
 public:
@@ -90,6 +134,8 @@ public:
 
     virtual ~RefCountable()
     {
+        if (!LibContext::hasRefCountableRegistry())
+            return;
         if (const auto refCountableRegistry = libContext().refCountableRegistry())
             refCountableRegistry->notifyDestroyed(this, refCount());
     }
@@ -102,12 +148,14 @@ public:
 protected:
     RefCountable(): m_refCountableHolder(static_cast<const IRefCountable*>(this))
     {
+        if (!LibContext::hasRefCountableRegistry())
+            return;
         if (const auto refCountableRegistry = libContext().refCountableRegistry())
             refCountableRegistry->notifyCreated(this, refCount());
     }
 
 private:
-    const RefCountableHolder m_refCountableHolder;
+    const BasicRefCountableHolder<Policy> m_refCountableHolder;
 };
 
 } // namespace nx::sdk
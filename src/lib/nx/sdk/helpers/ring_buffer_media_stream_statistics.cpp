@@ -0,0 +1,240 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "ring_buffer_media_stream_statistics.h"
+
+#include <algorithm>
+
+namespace nx::sdk {
+
+using namespace std::chrono;
+
+/** Enough for a few seconds of a usual stream; the ring grows for higher frame rates. */
+static constexpr size_t kInitialCapacity = 256;
+
+static size_t roundUpToPowerOf2(int value)
+{
+    size_t result = 2;
+    while ((int) result < value)
+        result <<= 1;
+    return result;
+}
+
+static int64_t nowNs()
+{
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+RingBufferMediaStreamStatistics::RingBufferMediaStreamStatistics(
+    std::chrono::microseconds windowSize,
+    int maxDurationInFrames,
+    int capacity)
+    :
+    m_windowSizeUs(windowSize.count()),
+    m_maxDurationInFrames(maxDurationInFrames),
+    m_capacity(roundUpToPowerOf2(capacity)),
+    m_ring(std::min(m_capacity, kInitialCapacity))
+{
+    m_mask = m_ring.size() - 1;
+    reset();
+}
+
+void RingBufferMediaStreamStatistics::setWindowSize(std::chrono::microseconds windowSize)
+{
+    m_windowSizeUs.store(windowSize.count(), std::memory_order_relaxed);
+}
+
+void RingBufferMediaStreamStatistics::setMaxDurationInFrames(int maxDurationInFrames)
+{
+    std::lock_guard<std::mutex> locker(m_writeMutex);
+    m_maxDurationInFrames = maxDurationInFrames;
+}
+
+void RingBufferMediaStreamStatistics::reset()
+{
+    std::lock_guard<std::mutex> locker(m_writeMutex);
+    m_begin = 0;
+    m_end = 0;
+    m_totalSizeBytes = 0;
+    m_keyFrameCount = 0;
+    publishUnsafe();
+}
+
+void RingBufferMediaStreamStatistics::onData(
+    microseconds timestamp, size_t dataSize, bool isKeyFrame)
+{
+    const Data data{timestamp.count(), (int64_t) dataSize, isKeyFrame};
+    const int64_t windowSizeUs = m_windowSizeUs.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> locker(m_writeMutex);
+    if (m_begin == m_end || data.timestampUs >= at(m_end - 1).timestampUs)
+    {
+        // Fast path: frames normally arrive in timestamp order.
+        makeRoomUnsafe();
+        pushBackUnsafe(data);
+    }
+    else
+    {
+        // Remove future data in case of media stream time has been changed.
+        while (m_begin != m_end && at(m_end - 1).timestampUs >= data.timestampUs + windowSizeUs)
+            popBackUnsafe();
+        insertUnsafe(data);
+    }
+
+    // Remove old data.
+    const int64_t oldestTimestampUs = at(m_end - 1).timestampUs - windowSizeUs;
+    while (at(m_begin).timestampUs < oldestTimestampUs)
+        popFrontUnsafe();
+    if (m_maxDurationInFrames > 0)
+    {
+        while (m_end - m_begin > (uint64_t) m_maxDurationInFrames)
+            popFrontUnsafe();
+    }
+
+    publishUnsafe();
+}
+
+int64_t RingBufferMediaStreamStatistics::bitrateBitsPerSecond() const
+{
+    const Summary s = summary();
+    if (s.frameCount == 0 || isStale(s))
+        return 0;
+
+    if (s.intervalUs > 0)
+        return ((s.totalSizeBytes - s.lastFrameSizeBytes) * 8'000'000) / s.intervalUs;
+    return 0;
+}
+
+bool RingBufferMediaStreamStatistics::hasMediaData() const
+{
+    return m_publishedTotalSizeBytes.load(std::memory_order_relaxed) > 0;
+}
+
+float RingBufferMediaStreamStatistics::getFrameRate() const
+{
+    const Summary s = summary();
+    if (s.frameCount == 0 || isStale(s))
+        return 0;
+
+    if (s.intervalUs > 0)
+        return (float) (s.frameCount - 1) * 1'000'000.0F / (float) s.intervalUs;
+    return 0;
+}
+
+float RingBufferMediaStreamStatistics::getAverageGopSize() const
+{
+    const Summary s = summary();
+    return s.keyFrameCount > 0 ? (float) s.frameCount / (float) s.keyFrameCount : 0;
+}
+
+RingBufferMediaStreamStatistics::Summary RingBufferMediaStreamStatistics::summary() const
+{
+    Summary s;
+    for (;;)
+    {
+        const uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+        if (sequence & 1) //< A writer is publishing; it holds the data only for a few stores.
+            continue;
+
+        s.frameCount = m_frameCount.load(std::memory_order_relaxed);
+        s.totalSizeBytes = m_publishedTotalSizeBytes.load(std::memory_order_relaxed);
+        s.keyFrameCount = m_publishedKeyFrameCount.load(std::memory_order_relaxed);
+        s.intervalUs = m_intervalUs.load(std::memory_order_relaxed);
+        s.lastFrameSizeBytes = m_lastFrameSizeBytes.load(std::memory_order_relaxed);
+        s.lastDataTimeNs = m_lastDataTimeNs.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == sequence)
+            return s;
+    }
+}
+
+bool RingBufferMediaStreamStatistics::isStale(const Summary& s) const
+{
+    const int64_t windowSizeNs = m_windowSizeUs.load(std::memory_order_relaxed) * 1000;
+    return nowNs() - s.lastDataTimeNs > windowSizeNs;
+}
+
+void RingBufferMediaStreamStatistics::makeRoomUnsafe()
+{
+    const size_t frameCount = (size_t) (m_end - m_begin);
+    if (frameCount < m_ring.size())
+        return;
+
+    if (m_ring.size() == m_capacity)
+    {
+        popFrontUnsafe();
+        return;
+    }
+
+    // Readers only see the published aggregates, so the ring can be reallocated under the lock.
+    std::vector<Data> ring(m_ring.size() * 2);
+    for (size_t i = 0; i < frameCount; ++i)
+        ring[i] = at(m_begin + i);
+    m_ring.swap(ring);
+    m_mask = m_ring.size() - 1;
+    m_begin = 0;
+    m_end = frameCount;
+}
+
+void RingBufferMediaStreamStatistics::pushBackUnsafe(const Data& data)
+{
+    at(m_end++) = data;
+    m_totalSizeBytes += data.size;
+    if (data.isKeyFrame)
+        ++m_keyFrameCount;
+}
+
+void RingBufferMediaStreamStatistics::popFrontUnsafe()
+{
+    const Data& data = at(m_begin++);
+    m_totalSizeBytes -= data.size;
+    if (data.isKeyFrame)
+        --m_keyFrameCount;
+}
+
+void RingBufferMediaStreamStatistics::popBackUnsafe()
+{
+    const Data& data = at(--m_end);
+    m_totalSizeBytes -= data.size;
+    if (data.isKeyFrame)
+        --m_keyFrameCount;
+}
+
+void RingBufferMediaStreamStatistics::insertUnsafe(const Data& data)
+{
+    makeRoomUnsafe();
+
+    // Same position as std::lower_bound() would give: before the frames with equal timestamps.
+    uint64_t position = m_end;
+    while (position != m_begin && at(position - 1).timestampUs >= data.timestampUs)
+    {
+        at(position) = at(position - 1);
+        --position;
+    }
+    at(position) = data;
+    ++m_end;
+    m_totalSizeBytes += data.size;
+    if (data.isKeyFrame)
+        ++m_keyFrameCount;
+}
+
+void RingBufferMediaStreamStatistics::publishUnsafe()
+{
+    const bool isEmpty = m_begin == m_end;
+    const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_frameCount.store((int64_t) (m_end - m_begin), std::memory_order_relaxed);
+    m_publishedTotalSizeBytes.store(m_totalSizeBytes, std::memory_order_relaxed);
+    m_publishedKeyFrameCount.store(m_keyFrameCount, std::memory_order_relaxed);
+    m_intervalUs.store(
+        isEmpty ? 0 : at(m_end - 1).timestampUs - at(m_begin).timestampUs,
+        std::memory_order_relaxed);
+    m_lastFrameSizeBytes.store(isEmpty ? 0 : at(m_end - 1).size, std::memory_order_relaxed);
+    m_lastDataTimeNs.store(nowNs(), std::memory_order_relaxed);
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+} // namespace nx::sdk
@@ -0,0 +1,107 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace nx::sdk {
+
+/**
+ * Drop-in alternative to MediaStreamStatistics for high-rate streams: calculates media stream
+ * bitrate, average frame rate and GOP size over a fixed-capacity ring buffer.
+ *
+ * - onData() is O(1) for timestamps that are not older than the latest one (the usual case);
+ *     older timestamps are inserted in order at O(N) cost.
+ * - Byte totals and key frame counts are maintained incrementally.
+ * - Readers never take a lock: the aggregates are published via a seqlock, so getters do not
+ *     contend with onData() called from the media thread.
+ *
+ * The ring starts small and doubles whenever the window holds more frames than it fits, up to
+ * `capacity` frames (kDefaultCapacity is 10 seconds at 6500 fps, using 1.5 MB). Only if even more
+ * frames fall within the window, the oldest ones are dropped, as if
+ * setMaxDurationInFrames(capacity) was called, which shortens the averaging window.
+ */
+class RingBufferMediaStreamStatistics
+{
+public:
+    static constexpr int kDefaultCapacity = 64 * 1024;
+
+    RingBufferMediaStreamStatistics(
+        std::chrono::microseconds windowSize = std::chrono::seconds(2),
+        int maxDurationInFrames = 0,
+        int capacity = kDefaultCapacity);
+
+    void setWindowSize(std::chrono::microseconds windowSize);
+    void setMaxDurationInFrames(int maxDurationInFrames);
+
+    void reset();
+    void onData(std::chrono::microseconds timestamp, size_t dataSize, bool isKeyFrame);
+    int64_t bitrateBitsPerSecond() const;
+    float getFrameRate() const;
+    float getAverageGopSize() const;
+    bool hasMediaData() const;
+
+    /** @return Number of frames the ring buffer can grow to (capacity rounded up to a power of 2). */
+    int capacity() const { return (int) m_capacity; }
+
+private:
+    struct Data
+    {
+        int64_t timestampUs = 0;
+        int64_t size = 0;
+        bool isKeyFrame = false;
+    };
+
+    /** Consistent copy of the aggregates, as seen by the readers. */
+    struct Summary
+    {
+        int64_t frameCount = 0;
+        int64_t totalSizeBytes = 0;
+        int64_t keyFrameCount = 0;
+        int64_t intervalUs = 0;
+        int64_t lastFrameSizeBytes = 0;
+        int64_t lastDataTimeNs = 0;
+    };
+
+    Summary summary() const;
+    bool isStale(const Summary& summary) const;
+
+    // The following methods require m_writeMutex to be locked.
+    Data& at(uint64_t index) { return m_ring[index & m_mask]; }
+    const Data& at(uint64_t index) const { return m_ring[index & m_mask]; }
+    void makeRoomUnsafe();
+    void pushBackUnsafe(const Data& data);
+    void popFrontUnsafe();
+    void popBackUnsafe();
+    void insertUnsafe(const Data& data);
+    void publishUnsafe();
+
+private:
+    std::atomic<int64_t> m_windowSizeUs;
+    int m_maxDurationInFrames = 0;
+
+    std::mutex m_writeMutex; //< Serializes writers; readers use m_sequence instead.
+    const size_t m_capacity;
+    std::vector<Data> m_ring;
+    uint64_t m_mask = 0;
+    uint64_t m_begin = 0; //< Index of the oldest frame; wraps via m_mask.
+    uint64_t m_end = 0; //< Index past the newest frame; wraps via m_mask.
+    int64_t m_totalSizeBytes = 0;
+    int64_t m_keyFrameCount = 0;
+
+    // Seqlock-protected copy of the aggregates; odd m_sequence means a write is in progress.
+    std::atomic<uint32_t> m_sequence{0};
+    std::atomic<int64_t> m_frameCount{0};
+    std::atomic<int64_t> m_publishedTotalSizeBytes{0};
+    std::atomic<int64_t> m_publishedKeyFrameCount{0};
+    std::atomic<int64_t> m_intervalUs{0};
+    std::atomic<int64_t> m_lastFrameSizeBytes{0};
+    std::atomic<int64_t> m_lastDataTimeNs{0};
+};
+
+} // namespace nx::sdk
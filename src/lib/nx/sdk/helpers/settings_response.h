@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <nx/sdk/helpers/object_pool.h>
 #include <nx/sdk/helpers/ref_countable.h>
 #include <nx/sdk/helpers/string.h>
 #include <nx/sdk/helpers/string_map.h>
@@ -10,7 +11,7 @@
 
 namespace nx::sdk {
 
-class SettingsResponse: public RefCountable<ISettingsResponse>
+class SettingsResponse: public RefCountable<ISettingsResponse>, public PooledAllocation<SettingsResponse>
 {
 public:
     SettingsResponse() = default;
@@ -0,0 +1,96 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "settings_snapshot.h"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+namespace nx::sdk {
+
+/**
+ * @return Pointer to the pooled copy of the key, stable for the lifetime of the process. Setting
+ *     names come from the settings models, so the pool stays small.
+ */
+static const std::string* internKey(const std::string& key)
+{
+    static std::mutex mutex;
+    static std::unordered_set<std::string> pool;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*pool.insert(key).first; //< Elements of unordered_set never move.
+}
+
+SettingsSnapshot::SettingsSnapshot(const Map& map)
+{
+    m_items.reserve(map.size());
+    for (const auto& [key, value]: map)
+    {
+        const std::string* const internedKey = internKey(key);
+        m_items.emplace_back(internedKey, value);
+        m_hash = m_hash * 31
+            + (std::hash<const std::string*>()(internedKey) ^ std::hash<std::string>()(value));
+    }
+}
+
+std::shared_ptr<const SettingsSnapshot> SettingsSnapshot::make(const Map& map)
+{
+    return std::make_shared<const SettingsSnapshot>(map);
+}
+
+const std::shared_ptr<const SettingsSnapshot>& SettingsSnapshot::empty()
+{
+    static const auto emptySnapshot = std::make_shared<const SettingsSnapshot>();
+    return emptySnapshot;
+}
+
+const SettingsSnapshot::Item* SettingsSnapshot::find(const std::string& key) const
+{
+    const auto it = std::lower_bound(m_items.begin(), m_items.end(), key,
+        [](const Item& item, const std::string& key) { return *item.first < key; });
+    if (it == m_items.end() || *it->first != key)
+        return nullptr;
+    return &*it;
+}
+
+bool SettingsSnapshot::contains(const std::string& key) const
+{
+    return find(key) != nullptr;
+}
+
+const std::string& SettingsSnapshot::value(const std::string& key) const
+{
+    static const std::string emptyValue;
+
+    const Item* const item = find(key);
+    return item ? item->second : emptyValue;
+}
+
+SettingsSnapshot::Map SettingsSnapshot::toMap() const
+{
+    Map map;
+    for (const auto& [key, value]: m_items)
+        map.emplace_hint(map.end(), *key, value);
+    return map;
+}
+
+bool SettingsSnapshot::operator==(const SettingsSnapshot& other) const
+{
+    if (this == &other)
+        return true;
+    if (m_hash != other.m_hash || m_items.size() != other.m_items.size())
+        return false;
+    for (size_t i = 0; i < m_items.size(); ++i)
+    {
+        // Interned keys are equal only if the pointers are equal.
+        if (m_items[i].first != other.m_items[i].first
+            || m_items[i].second != other.m_items[i].second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace nx::sdk
@@ -0,0 +1,60 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nx::sdk {
+
+/**
+ * Immutable set of setting values, intended to be shared via std::shared_ptr<const
+ * SettingsSnapshot> instead of copying std::map<std::string, std::string> each time the settings
+ * are inspected.
+ *
+ * Keys are interned in a process-wide pool, so the snapshots hold only a pointer per key, and
+ * comparing two snapshots compares the key pointers and a precomputed hash before the values.
+ */
+class SettingsSnapshot
+{
+public:
+    using Map = std::map<std::string, std::string>;
+
+    SettingsSnapshot() = default;
+    explicit SettingsSnapshot(const Map& map);
+
+    static std::shared_ptr<const SettingsSnapshot> make(const Map& map);
+
+    /** @return Snapshot without any settings; shared by all callers. */
+    static const std::shared_ptr<const SettingsSnapshot>& empty();
+
+    int count() const { return (int) m_items.size(); }
+    const std::string& key(int i) const { return *m_items[i].first; }
+    const std::string& value(int i) const { return m_items[i].second; }
+
+    bool contains(const std::string& key) const;
+
+    /** @return Reference valid for the lifetime of the snapshot, or an empty string if no key. */
+    const std::string& value(const std::string& key) const;
+
+    Map toMap() const;
+
+    /** Structural comparison: equal if the keys and values are the same. */
+    bool operator==(const SettingsSnapshot& other) const;
+    bool operator!=(const SettingsSnapshot& other) const { return !(*this == other); }
+
+private:
+    using Item = std::pair<const std::string* /*interned key*/, std::string>;
+
+    const Item* find(const std::string& key) const;
+
+private:
+    std::vector<Item> m_items; //< Sorted by key.
+    size_t m_hash = 0;
+};
+
+} // namespace nx::sdk
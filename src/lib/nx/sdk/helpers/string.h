@@ -4,12 +4,13 @@
 
 #include <string>
 
+#include <nx/sdk/helpers/object_pool.h>
 #include <nx/sdk/helpers/ref_countable.h>
 #include <nx/sdk/i_string.h>
 
 namespace nx::sdk {
 
-class String: public RefCountable<IString>
+class String: public RefCountable<IString>, public PooledAllocation<String>
 {
 public:
     String() = default;
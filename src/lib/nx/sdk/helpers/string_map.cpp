@@ -2,46 +2,60 @@
 
 #include "string_map.h"
 
-#include <iterator>
+#include <algorithm>
+#include <cstring>
 
 #include <nx/kit/debug.h>
 
 namespace nx::sdk {
 
+StringMap::StringMap(const Map& map): m_items(map.begin(), map.end())
+{
+}
+
 void StringMap::setItem(const std::string& key, const std::string& value)
 {
     NX_KIT_ASSERT(!key.empty());
-    m_map[key] = value;
+
+    // Appending in key order, as when filling from a sorted source, needs no search.
+    if (m_items.empty() || m_items.back().first < key)
+    {
+        m_items.emplace_back(key, value);
+        return;
+    }
+
+    const auto it = std::lower_bound(m_items.begin(), m_items.end(), key,
+        [](const Item& item, const std::string& key) { return item.first < key; });
+    if (it != m_items.end() && it->first == key)
+        it->second = value;
+    else
+        m_items.emplace(it, key, value);
 }
 
 void StringMap::clear()
 {
-    m_map.clear();
+    m_items.clear();
 }
 
 int StringMap::count() const
 {
-    return (int) m_map.size();
+    return (int) m_items.size();
 }
 
 const char* StringMap::key(int i) const
 {
-    if (i < 0 || i >= (int) m_map.size())
+    if (i < 0 || i >= (int) m_items.size())
         return nullptr;
 
-    auto position = m_map.cbegin();
-    std::advance(position, i);
-    return position->first.c_str();
+    return m_items[i].first.c_str();
 }
 
 const char* StringMap::value(int i) const
 {
-    if (i < 0 || i >= (int) m_map.size())
+    if (i < 0 || i >= (int) m_items.size())
         return nullptr;
 
-    auto position = m_map.cbegin();
-    std::advance(position, i);
-    return position->second.c_str();
+    return m_items[i].second.c_str();
 }
 
 const char* StringMap::value(const char* key) const
@@ -49,8 +63,9 @@ const char* StringMap::value(const char* key) const
     if (key == nullptr)
         return nullptr;
 
-    const Map::const_iterator it = m_map.find(key);
-    if (it == m_map.cend())
+    const auto it = std::lower_bound(m_items.cbegin(), m_items.cend(), key,
+        [](const Item& item, const char* key) { return strcmp(item.first.c_str(), key) < 0; });
+    if (it == m_items.cend() || it->first != key)
         return nullptr;
 
     return it->second.c_str();
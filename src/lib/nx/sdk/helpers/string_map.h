@@ -3,21 +3,28 @@
 #pragma once
 
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include <nx/sdk/helpers/object_pool.h>
 #include <nx/sdk/helpers/ref_countable.h>
 #include <nx/sdk/i_string_map.h>
 
 namespace nx::sdk {
 
-// TODO: Do something with O(N^2) complexity of lookup by index.
-class StringMap: public RefCountable<IStringMap>
+/**
+ * Stores the items in a vector sorted by key, so that walking the map by index via key(i) and
+ * value(i) is O(1) per item, and lookup by key is a binary search over contiguous memory.
+ */
+class StringMap: public RefCountable<IStringMap>, public PooledAllocation<StringMap>
 {
 public:
     using Map = std::map<std::string, std::string>;
 
     StringMap() = default;
 
-    StringMap(Map map): m_map(std::move(map)) {}
+    StringMap(const Map& map);
 
     void setItem(const std::string& key, const std::string& value);
 
@@ -34,7 +41,9 @@ public:
     virtual const char* value(const char* key) const override;
 
 private:
-    Map m_map;
+    using Item = std::pair<std::string, std::string>;
+
+    std::vector<Item> m_items; //< Sorted by key; keys are unique.
 };
 
 } // namespace nx::sdk
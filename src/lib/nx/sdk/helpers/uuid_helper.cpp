@@ -3,8 +3,6 @@
 #include "uuid_helper.h"
 
 #include <limits>
-#include <sstream>
-#include <iomanip>
 #include <cstdlib>
 
 #include <nx/kit/debug.h>
@@ -13,89 +11,285 @@
 #include <stdint.h>
 #include <mutex>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define NX_SDK_UUID_HELPER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define NX_SDK_UUID_HELPER_NEON
+#endif
+
 namespace nx::sdk {
 
 namespace UuidHelper {
 
-Uuid fromStdString(const std::string& str)
+static constexpr int kHexDigitCount = 2 * Uuid::kSize;
+
+/** Lengths of the hyphen-separated groups of hex digits in the canonical form. */
+static constexpr int kGroupLengths[] = {8, 4, 4, 4, 12};
+
+/** @return Value of the hex digit, or -1 if the char is not a hex digit. */
+static inline int hexDigitValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Conversion of 32 hex digits to and from 16 bytes: SSE2 or NEON with a scalar fallback.
+// SSE2 has no byte shuffle to look the nibbles up in a table, so the nibbles are converted
+// arithmetically, which takes a few more instructions but stays branch-free.
+
+#if defined(NX_SDK_UUID_HELPER_SSE2)
+
+/** @param outIsValid Receives 0xFF in the bytes which hold hex digits, and 0 in the others. */
+static inline __m128i hexDigitValues(__m128i chars, __m128i* outIsValid)
+{
+    // There is no unsigned byte comparison: compare signed values with the flipped sign bits.
+    const __m128i signBit = _mm_set1_epi8((char) 0x80);
+    const auto unsignedLess =
+        [&signBit](__m128i a, int b)
+        {
+            return _mm_cmplt_epi8(_mm_xor_si128(a, signBit), _mm_set1_epi8((char) (b ^ 0x80)));
+        };
+
+    const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i isDigit = unsignedLess(digit, 10);
+    const __m128i isLetter = unsignedLess(letter, 6);
+
+    *outIsValid = _mm_or_si128(isDigit, isLetter);
+    return _mm_or_si128(
+        _mm_and_si128(isDigit, digit),
+        _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+static bool decodeHexDigits(const char* hex, uint8_t* bytes)
+{
+    __m128i isValid0, isValid1;
+    const __m128i values0 = hexDigitValues(_mm_loadu_si128((const __m128i*) hex), &isValid0);
+    const __m128i values1 = hexDigitValues(_mm_loadu_si128((const __m128i*) (hex + 16)), &isValid1);
+    if (_mm_movemask_epi8(_mm_and_si128(isValid0, isValid1)) != 0xFFFF)
+        return false;
+
+    // In each 16-bit lane, the low byte holds the first (high-order) digit of a byte.
+    const auto joinDigitPairs =
+        [](__m128i values)
+        {
+            return _mm_or_si128(
+                _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 4),
+                _mm_srli_epi16(values, 8));
+        };
+    _mm_storeu_si128((__m128i*) bytes,
+        _mm_packus_epi16(joinDigitPairs(values0), joinDigitPairs(values1)));
+    return true;
+}
+
+static void encodeHexDigits(const uint8_t* bytes, char* hex, bool uppercase)
+{
+    const __m128i data = _mm_loadu_si128((const __m128i*) bytes);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(data, 4), nibbleMask);
+    const __m128i low = _mm_and_si128(data, nibbleMask);
+
+    const __m128i letterOffset = _mm_set1_epi8((char) ((uppercase ? 'A' : 'a') - '0' - 10));
+    const auto toChars =
+        [&letterOffset](__m128i nibbles)
+        {
+            const __m128i isLetter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+            return _mm_add_epi8(
+                _mm_add_epi8(nibbles, _mm_set1_epi8('0')), _mm_and_si128(isLetter, letterOffset));
+        };
+    _mm_storeu_si128((__m128i*) hex, toChars(_mm_unpacklo_epi8(high, low)));
+    _mm_storeu_si128((__m128i*) (hex + 16), toChars(_mm_unpackhi_epi8(high, low)));
+}
+
+#elif defined(NX_SDK_UUID_HELPER_NEON)
+
+/** @param outIsValid Receives 0xFF in the bytes which hold hex digits, and 0 in the others. */
+static inline uint8x16_t hexDigitValues(uint8x16_t chars, uint8x16_t* outIsValid)
+{
+    const uint8x16_t digit = vsubq_u8(chars, vdupq_n_u8('0'));
+    const uint8x16_t letter = vsubq_u8(vorrq_u8(chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    const uint8x16_t isDigit = vcltq_u8(digit, vdupq_n_u8(10));
+    const uint8x16_t isLetter = vcltq_u8(letter, vdupq_n_u8(6));
+
+    *outIsValid = vorrq_u8(isDigit, isLetter);
+    return vorrq_u8(
+        vandq_u8(isDigit, digit), vandq_u8(isLetter, vaddq_u8(letter, vdupq_n_u8(10))));
+}
+
+static bool decodeHexDigits(const char* hex, uint8_t* bytes)
+{
+    uint8x16_t isValid0, isValid1;
+    const uint8x16_t values0 = hexDigitValues(vld1q_u8((const uint8_t*) hex), &isValid0);
+    const uint8x16_t values1 = hexDigitValues(vld1q_u8((const uint8_t*) hex + 16), &isValid1);
+    const uint64x2_t isValid = vreinterpretq_u64_u8(vandq_u8(isValid0, isValid1));
+    if ((vgetq_lane_u64(isValid, 0) & vgetq_lane_u64(isValid, 1)) != UINT64_MAX)
+        return false;
+
+    // The even bytes hold the first (high-order) digits, the odd bytes - the second ones.
+    const uint8x16x2_t digitPairs = vuzpq_u8(values0, values1);
+    vst1q_u8(bytes, vorrq_u8(vshlq_n_u8(digitPairs.val[0], 4), digitPairs.val[1]));
+    return true;
+}
+
+static void encodeHexDigits(const uint8_t* bytes, char* hex, bool uppercase)
 {
-    static const int kMinUuidStrSize = 32;
+    const uint8x16_t data = vld1q_u8(bytes);
+    const uint8x16x2_t nibbles = vzipq_u8(vshrq_n_u8(data, 4), vandq_u8(data, vdupq_n_u8(0x0F)));
+
+    const uint8x16_t letterOffset = vdupq_n_u8((uint8_t) ((uppercase ? 'A' : 'a') - '0' - 10));
+    for (int i = 0; i < 2; ++i)
+    {
+        const uint8x16_t isLetter = vcgtq_u8(nibbles.val[i], vdupq_n_u8(9));
+        vst1q_u8((uint8_t*) hex + 16 * i, vaddq_u8(
+            vaddq_u8(nibbles.val[i], vdupq_n_u8('0')), vandq_u8(isLetter, letterOffset)));
+    }
+}
 
-    if ((int) str.size() < kMinUuidStrSize)
+#else
+
+static bool decodeHexDigits(const char* hex, uint8_t* bytes)
+{
+    for (int i = 0; i < Uuid::kSize; ++i)
+    {
+        const int high = hexDigitValue(hex[2 * i]);
+        const int low = hexDigitValue(hex[2 * i + 1]);
+        if (high < 0 || low < 0)
+            return false;
+        bytes[i] = (uint8_t) ((high << 4) | low);
+    }
+    return true;
+}
+
+static void encodeHexDigits(const uint8_t* bytes, char* hex, bool uppercase)
+{
+    const char* const digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    for (int i = 0; i < Uuid::kSize; ++i)
+    {
+        hex[2 * i] = digits[bytes[i] >> 4];
+        hex[2 * i + 1] = digits[bytes[i] & 0x0F];
+    }
+}
+
+#endif
+
+/**
+ * If the string has the canonical form (32 hex digits, optionally separated by hyphens into
+ * groups, and optionally enclosed in braces), copies the digits to `hex`.
+ */
+static bool collectCanonicalHexDigits(const char* str, int size, char* hex)
+{
+    if (size == kHexDigitCount)
+    {
+        memcpy(hex, str, kHexDigitCount);
+        return true;
+    }
+
+    if (size == kMaxStringLength && str[0] == '{' && str[kMaxStringLength - 1] == '}')
+    {
+        ++str;
+        size -= 2;
+    }
+    if (size != kHexDigitCount + 4)
+        return false;
+
+    for (const int groupLength: kGroupLengths)
+    {
+        memcpy(hex, str, groupLength);
+        hex += groupLength;
+        str += groupLength;
+        if (groupLength != 12 && *str++ != '-')
+            return false;
+    }
+    return true;
+}
+
+Uuid fromStdString(const std::string& str)
+{
+    if ((int) str.size() < kHexDigitCount)
         return Uuid();
 
     Uuid uuid;
-    int currentByteIndex = 0;
-    std::string currentByteString;
+
+    char hex[kHexDigitCount];
+    if (collectCanonicalHexDigits(str.data(), (int) str.size(), hex)
+        && decodeHexDigits(hex, uuid.data()))
+    {
+        return uuid;
+    }
+
+    // Any other layout: braces, hyphens and whitespace are allowed anywhere.
+    int digitCount = 0;
     for (const char c: str)
     {
         switch (c)
         {
-            case '{': case '}': case '-': case '\t': case '\n': case 'r': case ' ':
+            // 'r' was listed here instead of '\r' in the earlier versions; still skipped.
+            case '{': case '}': case '-': case '\t': case '\n': case '\r': case 'r': case ' ':
                 continue;
         }
 
-        if (currentByteIndex >= (int) sizeof(Uuid))
+        const int value = hexDigitValue(c);
+        if (value < 0 || digitCount >= kHexDigitCount)
             return Uuid();
 
-        currentByteString += c;
-        if (currentByteString.size() == 2)
-        {
-            char* pEnd = nullptr;
-            errno = 0; //< Required before strtol().
-            const long v = std::strtol(currentByteString.c_str(), &pEnd, /*base*/ 16);
-            const bool hasError =
-                v > std::numeric_limits<uint8_t>::max()
-                || v < std::numeric_limits<uint8_t>::min()
-                || errno != 0
-                || *pEnd != '\0';
-
-            if (hasError)
-                return Uuid();
-
-            uuid[currentByteIndex] = (uint8_t) v;
-            ++currentByteIndex;
-            currentByteString.clear();
-        }
+        if (digitCount % 2 == 0)
+            uuid[digitCount / 2] = (uint8_t) (value << 4);
+        else
+            uuid[digitCount / 2] |= (uint8_t) value;
+        ++digitCount;
     }
 
-    if (currentByteIndex != sizeof(Uuid))
+    if (digitCount != kHexDigitCount)
         return Uuid();
 
     return uuid;
 }
 
-std::string toStdString(const Uuid& uuid, FormatOptions formatOptions)
+int toChars(const Uuid& uuid, char* buffer, FormatOptions formatOptions)
 {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
+    char hex[kHexDigitCount];
+    encodeHexDigits(uuid.data(), hex, formatOptions & FormatOptions::uppercase);
 
+    char* p = buffer;
     if (formatOptions & FormatOptions::braces)
-        ss << '{';
-    if (formatOptions & FormatOptions::uppercase)
-        ss << std::uppercase;
-    for (int i = 0; i < 4; ++i)
-        ss << std::setw(2) << (int) uuid[i];
-    if (formatOptions & FormatOptions::hyphens)
-        ss << '-';
-    for (int i = 0; i < 2; ++i)
-        ss << std::setw(2) << (int) uuid[4 + i];
-    if (formatOptions & FormatOptions::hyphens)
-        ss << "-";
-    for (int i = 0; i < 2; ++i)
-        ss << std::setw(2) << (int) uuid[6 + i];
-    if (formatOptions & FormatOptions::hyphens)
-        ss << "-";
-    for (int i = 0; i < 2; ++i)
-        ss << std::setw(2) << (int) uuid[8 + i];
+        *p++ = '{';
     if (formatOptions & FormatOptions::hyphens)
-        ss << "-";
-    for (int i = 0; i < 6; ++i)
-        ss << std::setw(2) << (int) uuid[10 + i];
+    {
+        const char* digits = hex;
+        for (const int groupLength: kGroupLengths)
+        {
+            if (digits != hex)
+                *p++ = '-';
+            memcpy(p, digits, groupLength);
+            p += groupLength;
+            digits += groupLength;
+        }
+    }
+    else
+    {
+        memcpy(p, hex, kHexDigitCount);
+        p += kHexDigitCount;
+    }
     if (formatOptions & FormatOptions::braces)
-        ss << '}';
+        *p++ = '}';
+    *p = '\0';
+
+    return (int) (p - buffer);
+}
 
-    return ss.str();
+std::string toStdString(const Uuid& uuid, FormatOptions formatOptions)
+{
+    char buffer[kMaxStringLength + 1];
+    const int length = toChars(uuid, buffer, formatOptions);
+    return std::string(buffer, length);
 }
 
 class RandomGenerator64Bit
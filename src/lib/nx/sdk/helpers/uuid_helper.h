@@ -37,6 +37,16 @@ namespace UuidHelper
     /** @return String representation according to RFC-1422. */
     std::string toStdString(const Uuid& uuid, FormatOptions formatOptions = FormatOptions::all);
 
+    /** Maximum length of the string produced by toStdString() and toChars(). */
+    constexpr int kMaxStringLength = 38;
+
+    /**
+     * Same as toStdString(), but writes to the buffer instead of allocating a string.
+     * @param buffer At least kMaxStringLength + 1 chars; receives a null-terminated string.
+     * @return Length of the string, not counting the terminating '\0'.
+     */
+    int toChars(const Uuid& uuid, char* buffer, FormatOptions formatOptions = FormatOptions::all);
+
     Uuid randomUuid();
 }
 
@@ -49,7 +59,9 @@ namespace std {
 
 inline std::ostream& operator<<(std::ostream& os, const nx::sdk::Uuid& uuid)
 {
-    return os << nx::sdk::UuidHelper::toStdString(uuid);
+    char buffer[nx::sdk::UuidHelper::kMaxStringLength + 1];
+    nx::sdk::UuidHelper::toChars(uuid, buffer);
+    return os << buffer;
 }
 
 template<>
@@ -2,8 +2,8 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
-#include <vector>
 #include <string>
 #include <type_traits>
 
@@ -69,6 +69,44 @@ public:
 
         bool operator==(const InterfaceId& other) const { return strcmp(value, other.value) == 0; }
         bool operator!=(const InterfaceId& other) const { return !(*this == other); }
+
+        /**
+         * FNV-1a hash of an interface id string. Equal ids have equal hashes, so comparing the
+         * hashes first leaves strcmp() only for the (almost certain) match.
+         */
+        static constexpr uint32_t hashOf(const char* s)
+        {
+            uint32_t hash = 2166136261U;
+            for (; *s != '\0'; ++s)
+                hash = (hash ^ (uint8_t) *s) * 16777619U;
+            return hash;
+        }
+    };
+
+    /**
+     * Interface id together with its alternative ids, if any. Refers to the id strings without
+     * owning them, so it is cheap to copy and never allocates.
+     */
+    class InterfaceIdList
+    {
+    public:
+        static constexpr int kMaxSize = 2;
+
+        explicit InterfaceIdList(const InterfaceId* id): m_ids{id, nullptr}, m_size(1) {}
+
+        InterfaceIdList(const InterfaceId* id, const InterfaceId* alternativeId):
+            m_ids{id, alternativeId}, m_size(2)
+        {
+        }
+
+        int size() const { return m_size; }
+        const InterfaceId* operator[](int i) const { return m_ids[i]; }
+        const InterfaceId* const* begin() const { return m_ids; }
+        const InterfaceId* const* end() const { return m_ids + m_size; }
+
+    private:
+        const InterfaceId* m_ids[kMaxSize];
+        int m_size;
     };
 
 protected:
@@ -84,7 +122,7 @@ protected:
 
     /** Intended to be used in interfaceId(). Can be called only with two string literals. */
     template<int len, int alternativeLen>
-    static std::vector<const InterfaceId*> makeIdWithAlternative(
+    static InterfaceIdList makeIdWithAlternative(
         const char (&charArray)[len], const char (&alternativeCharArray)[alternativeLen])
     {
         static_assert(len + /*terminating \0*/ 1 >= InterfaceId::minSize(),
@@ -92,10 +130,9 @@ protected:
         static_assert(alternativeLen + /*terminating \0*/ 1 >= InterfaceId::minSize(),
             "Alternative interface id is too short");
 
-        return {
+        return InterfaceIdList(
             reinterpret_cast<const InterfaceId*>(charArray),
-            reinterpret_cast<const InterfaceId*>(alternativeCharArray),
-        };
+            reinterpret_cast<const InterfaceId*>(alternativeCharArray));
     }
 
 public:
@@ -132,12 +169,12 @@ protected:
         return reinterpret_cast<const InterfaceId*>(id.c_str());
     }
 
-    static std::vector<const InterfaceId*> alternativeInterfaceIds(const InterfaceId* id)
+    static InterfaceIdList alternativeInterfaceIds(const InterfaceId* id)
     {
-        return std::vector<const InterfaceId*>(1, id);
+        return InterfaceIdList(id);
     }
 
-    static std::vector<const InterfaceId*> alternativeInterfaceIds(std::vector<const InterfaceId*> ids)
+    static InterfaceIdList alternativeInterfaceIds(InterfaceIdList ids)
     {
         return ids;
     }
@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
+#include <type_traits>
 
 #include <nx/sdk/uuid.h>
 
@@ -53,10 +55,16 @@ public:
 protected:
     virtual IRefCountable* queryInterface(const IRefCountable::InterfaceId* id) override
     {
-        return doQueryInterface(id);
+        return doQueryInterface(id, IRefCountable::InterfaceId::hashOf(id->value));
     }
 
-    /** Call from DerivedInterface::queryInterface() to support interface id from the old SDK. */
+    /**
+     * Call from DerivedInterface::queryInterface() to support interface id from the old SDK.
+     *
+     * NOTE: Interfaces derived from DerivedInterface look up its ids without calling its virtual
+     * queryInterface(), thus the deprecated id is recognized only for objects which implement
+     * DerivedInterface as their most derived interface.
+     */
     IRefCountable* queryInterfaceSupportingDeprecatedId(
         const IRefCountable::InterfaceId* id,
         const Uuid& deprecatedInterfaceId)
@@ -69,7 +77,34 @@ protected:
             // The cast is needed to shift the pointer in case of multiple inheritance.
             return static_cast<DerivedInterface*>(this);
         }
-        return doQueryInterface(id);
+        return doQueryInterface(id, IRefCountable::InterfaceId::hashOf(id->value));
+    }
+
+    /**
+     * Walks this interface and its bases, comparing the ids of each level with the requested one.
+     * The hash of the requested id is calculated once by the caller, and the hashes of own ids
+     * once per interface, so that no allocations are made, and strcmp() is called only when the
+     * hashes match.
+     */
+    IRefCountable* doQueryInterface(const IRefCountable::InterfaceId* id, uint32_t idHash)
+    {
+        static const OwnIds ownIds(
+            IRefCountable::alternativeInterfaceIds(DerivedInterface::interfaceId()));
+
+        for (int i = 0; i < ownIds.ids.size(); ++i)
+        {
+            if (ownIds.hashes[i] == idHash && *ownIds.ids[i] == *id)
+            {
+                this->addRef();
+                // The cast is needed to shift the pointer in case of multiple inheritance.
+                return static_cast<DerivedInterface*>(this);
+            }
+        }
+
+        if constexpr (std::is_same<BaseInterface, IRefCountable>::value)
+            return BaseInterface::queryInterface(id);
+        else
+            return BaseInterface::doQueryInterface(id, idHash);
     }
 
 private:
@@ -88,19 +123,17 @@ private:
 
     friend DerivedInterface;
 
-    IRefCountable* doQueryInterface(const IRefCountable::InterfaceId* id)
+    struct OwnIds
     {
-        for (const auto& ownId: IRefCountable::alternativeInterfaceIds(DerivedInterface::interfaceId()))
+        const IRefCountable::InterfaceIdList ids;
+        uint32_t hashes[IRefCountable::InterfaceIdList::kMaxSize];
+
+        explicit OwnIds(IRefCountable::InterfaceIdList ids): ids(ids)
         {
-            if (*ownId == *id)
-            {
-                this->addRef();
-                // The cast is needed to shift the pointer in case of multiple inheritance.
-                return static_cast<DerivedInterface*>(this);
-            }
+            for (int i = 0; i < ids.size(); ++i)
+                hashes[i] = IRefCountable::InterfaceId::hashOf(ids[i]->value);
         }
-        return BaseInterface::queryInterface(id);
-    }
+    };
 };
 
 } // namespace nx::sdk
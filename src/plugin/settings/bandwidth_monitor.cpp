@@ -0,0 +1,66 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#include "bandwidth_monitor.h"
+
+#include <algorithm>
+
+namespace settings
+{
+
+static const int64_t kBitsPerMegabit = 1000 * 1000;
+
+bool BandwidthMonitor::setUploadCapacityMbps(int64_t megabitsPerSecond, Status *outStatus)
+{
+    const int64_t clampedMbps = std::min(std::max<int64_t>(0, megabitsPerSecond), kMaxUploadCapacityMbps);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacityBitsPerSecond = clampedMbps * kBitsPerMegabit;
+    return checkUnsafe(outStatus);
+}
+
+bool BandwidthMonitor::updateDeviceBitrate(const std::string &deviceId, int64_t bitsPerSecond, Status *outStatus)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_deviceBitrates[deviceId] = std::max<int64_t>(0, bitsPerSecond);
+    return checkUnsafe(outStatus);
+}
+
+bool BandwidthMonitor::removeDevice(const std::string &deviceId, Status *outStatus)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_deviceBitrates.erase(deviceId);
+    return checkUnsafe(outStatus);
+}
+
+BandwidthMonitor::Status BandwidthMonitor::status() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return statusUnsafe();
+}
+
+BandwidthMonitor::Status BandwidthMonitor::statusUnsafe() const
+{
+    Status status;
+    for (const auto &deviceBitrate : m_deviceBitrates)
+    {
+        status.demandBitsPerSecond += deviceBitrate.second;
+    }
+    status.capacityBitsPerSecond = m_capacityBitsPerSecond;
+    status.deviceCount = m_deviceBitrates.size();
+    status.exceeded = m_exceeded;
+    return status;
+}
+
+bool BandwidthMonitor::checkUnsafe(Status *outStatus)
+{
+    Status status = statusUnsafe();
+    status.exceeded = status.capacityBitsPerSecond > 0 && status.demandBitsPerSecond > status.capacityBitsPerSecond;
+    const bool changed = status.exceeded != m_exceeded;
+    m_exceeded = status.exceeded;
+    if (outStatus)
+    {
+        *outStatus = status;
+    }
+    return changed;
+}
+
+} // namespace settings
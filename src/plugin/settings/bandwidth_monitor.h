@@ -0,0 +1,50 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace settings
+{
+
+// Sums the bitrates reported by the DeviceAgents into the backup bandwidth demand, and compares it
+// with the upload capacity entered by the operator.
+class BandwidthMonitor
+{
+  public:
+    // larger settings (1 Tbps) are clamped, so that converting them to bits cannot overflow
+    static constexpr int64_t kMaxUploadCapacityMbps = 1000 * 1000;
+
+    struct Status
+    {
+        int64_t demandBitsPerSecond = 0;
+        int64_t capacityBitsPerSecond = 0;
+        size_t deviceCount = 0;
+        bool exceeded = false;
+    };
+
+    // Each of these returns whether the demand has crossed the capacity in either direction, so
+    // that a congested link is reported once instead of on every update. 0 capacity disables the
+    // check.
+    bool setUploadCapacityMbps(int64_t megabitsPerSecond, Status *outStatus = nullptr);
+    bool updateDeviceBitrate(const std::string &deviceId, int64_t bitsPerSecond, Status *outStatus = nullptr);
+    bool removeDevice(const std::string &deviceId, Status *outStatus = nullptr);
+
+    Status status() const;
+
+  private:
+    Status statusUnsafe() const;
+    bool checkUnsafe(Status *outStatus);
+
+  private:
+    mutable std::mutex m_mutex;
+    std::map<std::string, int64_t> m_deviceBitrates;
+    int64_t m_capacityBitsPerSecond = 0;
+    bool m_exceeded = false;
+};
+
+} // namespace settings
@@ -0,0 +1,151 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#include "capacity_tracker.h"
+
+namespace settings
+{
+
+// a trend over less history than this is mostly noise (e.g. a single large upload)
+static const std::chrono::minutes kMinTrendSpan(30);
+static const size_t kMinTrendSamples = 3;
+static const double kSecondsPerDay = 24 * 60 * 60;
+
+CapacityTracker::CapacityTracker(std::chrono::seconds window, size_t maxSamples)
+    : m_window(window), m_maxSamples(maxSamples)
+{
+}
+
+uint64_t CapacityTracker::generation() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_generation;
+}
+
+void CapacityTracker::invalidate()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_generation;
+}
+
+void CapacityTracker::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_samples.clear();
+    m_capacityBytes = 0;
+    ++m_generation;
+}
+
+bool CapacityTracker::addSample(uint64_t generation, Clock::time_point time, uint64_t usedBytes,
+                                uint64_t capacityBytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (generation != m_generation)
+    {
+        return false;
+    }
+    m_samples.push_back({time, usedBytes});
+    m_capacityBytes = capacityBytes;
+    // drop samples that fell out of the window
+    while (m_samples.size() > m_maxSamples || (time - m_samples.front().time) > m_window)
+    {
+        m_samples.pop_front();
+    }
+    return true;
+}
+
+size_t CapacityTracker::sampleCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_samples.size();
+}
+
+uint64_t CapacityTracker::usedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_samples.empty() ? 0 : m_samples.back().usedBytes;
+}
+
+uint64_t CapacityTracker::capacityBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacityBytes;
+}
+
+bool CapacityTracker::hasTrend() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return hasTrendUnsafe();
+}
+
+double CapacityTracker::growthBytesPerDay() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return growthBytesPerDayUnsafe();
+}
+
+double CapacityTracker::daysUntilFull() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_samples.empty() || m_capacityBytes == 0)
+    {
+        return -1;
+    }
+    const uint64_t usedBytes = m_samples.back().usedBytes;
+    if (usedBytes >= m_capacityBytes)
+    {
+        return 0;
+    }
+    const double growth = growthBytesPerDayUnsafe();
+    if (growth <= 0)
+    {
+        // usage is flat or shrinking (e.g. old recordings are being deleted)
+        return -1;
+    }
+    return static_cast<double>(m_capacityBytes - usedBytes) / growth;
+}
+
+bool CapacityTracker::hasTrendUnsafe() const
+{
+    return m_samples.size() >= kMinTrendSamples && m_samples.back().time - m_samples.front().time >= kMinTrendSpan;
+}
+
+double CapacityTracker::growthBytesPerDayUnsafe() const
+{
+    if (!hasTrendUnsafe())
+    {
+        return 0;
+    }
+
+    // least-squares slope, with both axes centered on their means to keep the sums small
+    const auto origin = m_samples.front().time;
+    const auto secondsSinceOrigin = [origin](const Sample &sample) {
+        return std::chrono::duration<double>(sample.time - origin).count();
+    };
+    double meanSeconds = 0;
+    double meanBytes = 0;
+    for (const auto &sample : m_samples)
+    {
+        meanSeconds += secondsSinceOrigin(sample);
+        meanBytes += static_cast<double>(sample.usedBytes);
+    }
+    const double count = static_cast<double>(m_samples.size());
+    meanSeconds /= count;
+    meanBytes /= count;
+
+    double covariance = 0;
+    double variance = 0;
+    for (const auto &sample : m_samples)
+    {
+        const double dx = secondsSinceOrigin(sample) - meanSeconds;
+        const double dy = static_cast<double>(sample.usedBytes) - meanBytes;
+        covariance += dx * dy;
+        variance += dx * dx;
+    }
+    if (variance <= 0)
+    {
+        return 0;
+    }
+    return covariance / variance * kSecondsPerDay;
+}
+
+} // namespace settings
@@ -0,0 +1,61 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace settings
+{
+
+// Keeps a history of the space used in the bucket and fits a linear growth trend to it, so we can
+// tell the operator how long it will take to fill the bucket.
+class CapacityTracker
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    CapacityTracker(std::chrono::seconds window = std::chrono::hours(24 * 7), size_t maxSamples = 2048);
+
+    // the generation changes on every reset() and invalidate(); a sample measured across a change
+    // (e.g. a listing of the bucket that was unmounted while it ran) is dropped by addSample()
+    uint64_t generation() const;
+    void invalidate();
+    void reset();
+    // returns false, without recording the sample, if the generation has changed since it was read
+    bool addSample(uint64_t generation, Clock::time_point time, uint64_t usedBytes, uint64_t capacityBytes);
+
+    size_t sampleCount() const;
+    uint64_t usedBytes() const;
+    uint64_t capacityBytes() const;
+
+    // whether there is enough history to fit a growth trend
+    bool hasTrend() const;
+    // growth in bytes per day from a least-squares fit, or 0 if there is not enough history yet
+    double growthBytesPerDay() const;
+    // days until the bucket is full, or a negative value if the trend does not predict it
+    double daysUntilFull() const;
+
+  private:
+    struct Sample
+    {
+        Clock::time_point time;
+        uint64_t usedBytes;
+    };
+
+    bool hasTrendUnsafe() const;
+    double growthBytesPerDayUnsafe() const;
+
+  private:
+    const std::chrono::seconds m_window;
+    const size_t m_maxSamples;
+    mutable std::mutex m_mutex;
+    std::deque<Sample> m_samples;
+    uint64_t m_capacityBytes = 0;
+    uint64_t m_generation = 0;
+};
+
+} // namespace settings
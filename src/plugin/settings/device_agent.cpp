@@ -21,13 +21,23 @@ using nx::kit::Json;
 using namespace nx::sdk;
 using namespace nx::sdk::analytics;
 
+// averaging window for the stream bitrate, long enough to cover several GOPs
+static const std::chrono::seconds kBitrateWindow(10);
+// enough ring buffer slots to hold the whole window of a 200 fps stream
+static const int kBitrateWindowMaxFrames = 2048;
+// how often each DeviceAgent reports its bitrate to the Engine
+static const std::chrono::seconds kBitrateReportInterval(1);
+
 DeviceAgent::DeviceAgent(Engine *engine, const nx::sdk::IDeviceInfo *deviceInfo)
-    : ConsumingDeviceAgent(deviceInfo, NX_DEBUG_ENABLE_OUTPUT, engine->plugin()->instanceId()), m_engine(engine)
+    : ConsumingDeviceAgent(deviceInfo, NX_DEBUG_ENABLE_OUTPUT, engine->plugin()->instanceId()), m_engine(engine),
+      m_deviceId(deviceInfo->id()),
+      m_streamStatistics(kBitrateWindow, /*maxDurationInFrames*/ 0, kBitrateWindowMaxFrames)
 {
 }
 
 DeviceAgent::~DeviceAgent()
 {
+    m_engine->removeDevice(m_deviceId);
 }
 
 std::string DeviceAgent::manifestString() const
@@ -39,6 +49,23 @@ std::string DeviceAgent::manifestString() const
 )json";
 }
 
+bool DeviceAgent::pushCompressedVideoFrame(const ICompressedVideoPacket *videoFrame)
+{
+    const bool isKeyFrame = (static_cast<uint32_t>(videoFrame->flags()) &
+                             static_cast<uint32_t>(ICompressedVideoPacket::MediaFlags::keyFrame)) != 0;
+    m_streamStatistics.onData(std::chrono::microseconds(videoFrame->timestampUs()),
+                              static_cast<size_t>(videoFrame->dataSize()), isKeyFrame);
+
+    // the Engine aggregates the bitrates into the total backup bandwidth demand
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastBitrateReport >= kBitrateReportInterval)
+    {
+        m_lastBitrateReport = now;
+        m_engine->updateDeviceBitrate(m_deviceId, m_streamStatistics.bitrateBitsPerSecond());
+    }
+    return true;
+}
+
 Result<const ISettingsResponse *> DeviceAgent::settingsReceived()
 {
     return Error(ErrorCode::noError, nullptr);
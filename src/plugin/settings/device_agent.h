@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include <chrono>
+#include <string>
+
 #include <nx/sdk/analytics/helpers/consuming_device_agent.h>
+#include <nx/sdk/helpers/ring_buffer_media_stream_statistics.h>
 
 #include <nx/kit/json.h>
 
@@ -27,6 +31,8 @@ class DeviceAgent : public nx::sdk::analytics::ConsumingDeviceAgent
 
     virtual std::string manifestString() const override;
 
+    virtual bool pushCompressedVideoFrame(const nx::sdk::analytics::ICompressedVideoPacket *videoFrame) override;
+
     virtual nx::sdk::Result<const nx::sdk::ISettingsResponse *> settingsReceived() override;
 
     virtual void doGetSettingsOnActiveSettingChange(
@@ -38,6 +44,9 @@ class DeviceAgent : public nx::sdk::analytics::ConsumingDeviceAgent
 
   private:
     Engine *const m_engine;
+    const std::string m_deviceId;
+    nx::sdk::RingBufferMediaStreamStatistics m_streamStatistics;
+    std::chrono::steady_clock::time_point m_lastBitrateReport;
 };
 
 } // namespace settings
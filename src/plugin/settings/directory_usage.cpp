@@ -0,0 +1,103 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#include "directory_usage.h"
+
+namespace fs = std::filesystem;
+
+namespace settings
+{
+
+bool DirectoryUsage::scan(const std::string &rootDir, const std::atomic<bool> &stop, uint64_t *outBytes)
+{
+    // directories that are gone are not copied over, so the cache does not outgrow the tree
+    std::map<fs::path, Directory> directories;
+    size_t listedDirectoryCount = 0;
+    uint64_t usedBytes = 0;
+    std::vector<fs::path> pending{fs::path(rootDir)};
+    while (!pending.empty())
+    {
+        if (stop)
+        {
+            return false;
+        }
+        const fs::path path = std::move(pending.back());
+        pending.pop_back();
+
+        std::error_code errCode;
+        const fs::file_time_type mtime = fs::last_write_time(path, errCode);
+        if (errCode)
+        {
+            if (path == rootDir)
+            {
+                return false;
+            }
+            // removed after its parent was listed
+            continue;
+        }
+        Directory directory;
+        const auto cached = m_directories.find(path);
+        if (cached != m_directories.end() && cached->second.mtime == mtime)
+        {
+            directory = std::move(cached->second);
+        }
+        else
+        {
+            directory.mtime = mtime;
+            if (!listDirectory(path, &directory))
+            {
+                if (path == rootDir)
+                {
+                    return false;
+                }
+                continue;
+            }
+            ++listedDirectoryCount;
+        }
+        usedBytes += directory.fileBytes;
+        pending.insert(pending.end(), directory.subdirectories.begin(), directory.subdirectories.end());
+        directories.emplace(path, std::move(directory));
+    }
+    m_directories = std::move(directories);
+    m_listedDirectoryCount = listedDirectoryCount;
+    *outBytes = usedBytes;
+    return true;
+}
+
+void DirectoryUsage::clear()
+{
+    m_directories.clear();
+}
+
+size_t DirectoryUsage::listedDirectoryCount() const
+{
+    return m_listedDirectoryCount;
+}
+
+bool DirectoryUsage::listDirectory(const fs::path &path, Directory *outDirectory) const
+{
+    std::error_code errCode;
+    fs::directory_iterator it(path, fs::directory_options::skip_permission_denied, errCode);
+    for (; !errCode && it != fs::directory_iterator(); it.increment(errCode))
+    {
+        std::error_code entryErrCode;
+        if (it->is_symlink(entryErrCode))
+        {
+            continue;
+        }
+        if (it->is_directory(entryErrCode))
+        {
+            outDirectory->subdirectories.push_back(it->path());
+        }
+        else if (it->is_regular_file(entryErrCode))
+        {
+            const uintmax_t fileSize = it->file_size(entryErrCode);
+            if (!entryErrCode)
+            {
+                outDirectory->fileBytes += fileSize;
+            }
+        }
+    }
+    return !errCode;
+}
+
+} // namespace settings
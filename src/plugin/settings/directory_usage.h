@@ -0,0 +1,46 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace settings
+{
+
+// Sums the sizes of the files under a directory tree. A scan lists again only the directories
+// whose mtime changed since the previous scan: adding, removing or renaming an entry updates the
+// mtime of its directory, so the listing of a recorded archive that did not change is reused.
+// A file that grows in place leaves its directory's mtime alone; clear() before a scan to list
+// everything again.
+class DirectoryUsage
+{
+  public:
+    // returns false if the tree could not be listed, or if stop was set during the scan
+    bool scan(const std::string &rootDir, const std::atomic<bool> &stop, uint64_t *outBytes);
+    void clear();
+
+    // the number of directories the last scan had to list, rather than reuse
+    size_t listedDirectoryCount() const;
+
+  private:
+    struct Directory
+    {
+        std::filesystem::file_time_type mtime;
+        uint64_t fileBytes = 0;
+        std::vector<std::filesystem::path> subdirectories;
+    };
+
+    bool listDirectory(const std::filesystem::path &path, Directory *outDirectory) const;
+
+  private:
+    std::map<std::filesystem::path, Directory> m_directories;
+    size_t m_listedDirectoryCount = 0;
+};
+
+} // namespace settings
@@ -5,17 +5,19 @@
 
 #include <algorithm>
 #include <chrono>
-#include <codecvt>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <openssl/bio.h>
 #include <openssl/buffer.h>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
+#include <sstream>
 #include <string>
 #include <thread>
 
 #include "device_agent.h"
+#include "saas_subscription.h"
 #include "settings_model.h"
 #include "stub_analytics_plugin_settings_ini.h"
 
@@ -23,15 +25,13 @@
 // #define NX_PRINT_PREFIX (this->logUtils.printPrefix)
 #define NX_PRINT_PREFIX "[cloudfuse] "
 // #define NX_DEBUG_ENABLE_OUTPUT true
+#include <nx/kit/async_log_sink.h>
 #include <nx/kit/debug.h>
 #include <nx/kit/ini_config.h>
+#include <nx/kit/json_writer.h>
 #include <nx/sdk/helpers/active_setting_changed_response.h>
 #include <nx/sdk/helpers/error.h>
 
-#ifdef _WIN32
-#include <windows.h>
-#endif
-
 namespace fs = std::filesystem;
 
 namespace settings
@@ -41,28 +41,42 @@ using namespace nx::sdk;
 using namespace nx::sdk::analytics;
 using namespace nx::kit;
 
-enum class SaasSubscriptionResult
-{
-    SubscriptionValid,
-    NoSubscription,
-    Error
-};
-
-static SaasSubscriptionResult checkSaasSubscription();
 static std::string generatePassphrase();
 static void enableLogging(std::string iniDir);
 static std::string parseCloudfuseError(std::string error);
 
+static const Json &parsedEngineSettingsModel(std::string *outParseError);
+static std::string formatMbps(int64_t bitsPerSecond);
+static std::string makeBannerJson(const std::string &bannerId, const std::string &icon, const std::string &text);
+
 static int maxWaitSecondsAfterMount = 10;
+static const int64_t kBitsPerMegabit = 1000 * 1000;
+static const double kBytesPerGigabyte = 1024.0 * 1024.0 * 1024.0;
+static const std::chrono::minutes kCapacitySampleInterval(10);
+static const std::chrono::hours kFullUsageScanInterval(24);
+// warn when the bucket is forecast to be full in less than this
+static const double kCapacityWarningDays = 30;
 
 Engine::Engine(Plugin *plugin)
     : nx::sdk::analytics::Engine(NX_DEBUG_ENABLE_OUTPUT, plugin->instanceId()), m_plugin(plugin), m_cfManager()
 {
+    // the Server creates the Engine while loading the plugins: the capacity sampling thread and
+    // CloudfuseMngr's file I/O wait until the bucket is mounted
     NX_PRINT << "cloudfuse Engine::Engine";
 }
 
 Engine::~Engine()
 {
+    {
+        std::lock_guard<std::mutex> lock(m_capacitySamplingMutex);
+        m_stopCapacitySampling = true;
+    }
+    m_capacitySamplingCondition.notify_all();
+    if (m_capacitySamplingThread.joinable())
+    {
+        m_capacitySamplingThread.join();
+    }
+
     NX_PRINT << "cloudfuse Engine::~Engine unmount cloudfuse";
     const processReturn unmountRet = m_cfManager.unmount();
     if (unmountRet.errCode != 0)
@@ -71,27 +85,40 @@ Engine::~Engine()
     }
     // enable logging for the _next_ time the mediaserver starts
     enableLogging(IniConfig::iniFilesDir());
+    NX_PRINT << "cloudfuse Engine::~Engine latencies:\n" << debug::LatencyHistogram::summaryOfAll();
+    // the unmount result must reach the log file even if the server is killed right after this
+    AsyncLogSink::flush();
+}
+
+// the manifests are assembled at compile time; the ini flag only selects one of them
+// the bucket settings belong to the Engine; DeviceAgents have none, so the cameras' plugin settings
+// tabs stay empty
+static constexpr auto kEngineManifestTail = StaticString(R"json(
+    "deviceAgentSettingsModel": {
+        "type": "Settings",
+        "items": []
+    }
 }
+)json");
+static constexpr auto kEngineManifest = StaticString("{") + kEngineManifestTail;
+// to estimate the backup bandwidth, DeviceAgents need the stream that is being recorded
+static constexpr auto kEngineManifestWithStream = StaticString(R"json({
+    "streamTypeFilter": "compressedVideo",
+    "preferredStream": "primary",)json") + kEngineManifestTail;
 
 std::string Engine::manifestString() const
 {
     NX_PRINT << "cloudfuse Engine::manifestString";
-    std::string result = /*suppress newline*/ 1 + (const char *)R"json(
-{
-    "deviceAgentSettingsModel":
-)json" + kEngineSettingsModel +
-                         R"json(
-}
-)json";
-
-    return result;
+    return ini().enableBandwidthEstimation ? kEngineManifestWithStream.str() : kEngineManifest.str();
 }
 
 Result<const ISettingsResponse *> Engine::settingsReceived()
 {
+    NX_TIME_HISTOGRAM("settingsReceived");
     NX_PRINT << "cloudfuse Engine::settingsReceived";
     std::string parseError;
-    Json::object model = Json::parse(kEngineSettingsModel, parseError).object_items();
+    // shares the pre-parsed model; setStatusBanner() copies only what it changes
+    Json model = parsedEngineSettingsModel(&parseError);
     if (parseError != "")
     {
         std::string errorMessage = "Failed to parse engine settings model. Here's why:" + parseError;
@@ -99,11 +126,33 @@ Result<const ISettingsResponse *> Engine::settingsReceived()
         return error(ErrorCode::internalError, errorMessage);
     }
 
-    std::map<std::string, std::string> values = currentSettings();
+    const std::shared_ptr<const SettingsSnapshot> settings = settingsSnapshot();
     // check if settings changed
-    bool mountRequired = settingsChanged();
+    bool mountRequired = settingsChanged(*settings);
+    // a retry of a failed mount keeps the usage history of the same bucket
+    const bool bucketSettingsChanged = bucketChanged(*settings);
     // write new settings to previous
-    m_prevSettings = values;
+    m_prevSettings = settings;
+
+    // upload capacity for the backup bandwidth check (0 or invalid disables it)
+    int64_t uploadCapacityMbps = 0;
+    if (settings->contains(kUploadCapacityTextFieldId))
+    {
+        const std::string &uploadCapacity = settings->value(kUploadCapacityTextFieldId);
+        try
+        {
+            uploadCapacityMbps = std::stoll(uploadCapacity);
+        }
+        catch (std::logic_error &)
+        {
+            NX_PRINT << "Bad input for upload capacity: " << uploadCapacity;
+        }
+    }
+    BandwidthMonitor::Status bandwidthStatus;
+    if (m_bandwidthMonitor.setUploadCapacityMbps(uploadCapacityMbps, &bandwidthStatus))
+    {
+        reportBandwidthChange(bandwidthStatus);
+    }
 
     // SaaS subscription
     // default to true, since initial checks are error-prone
@@ -111,11 +160,12 @@ Result<const ISettingsResponse *> Engine::settingsReceived()
     // check whether this plugin is authorized by an active SaaS subscription
     SaasSubscriptionResult subscriptionCheckResult = checkSaasSubscription();
     // only update the state if there was no error
-    auto subscriptionStatusJson = kStatusUnkownSaaSSubscription;
+    const char *subscriptionStatusJson = kStatusUnkownSaaSSubscription.c_str();
     if (subscriptionCheckResult != SaasSubscriptionResult::Error)
     {
         m_saasSubscriptionValid = subscriptionCheckResult == SaasSubscriptionResult::SubscriptionValid;
-        subscriptionStatusJson = m_saasSubscriptionValid ? kStatusSaaSSubscriptionVerified : kStatusNoSaaSSubscription;
+        subscriptionStatusJson =
+            m_saasSubscriptionValid ? kStatusSaaSSubscriptionVerified.c_str() : kStatusNoSaaSSubscription.c_str();
         // enforce subscription requirement
         if (!m_saasSubscriptionValid)
         {
@@ -125,6 +175,7 @@ Result<const ISettingsResponse *> Engine::settingsReceived()
             {
                 NX_PRINT << "Unmounting due to invalid subscription";
                 m_cfManager.unmount();
+                m_capacityTracker.invalidate();
             }
         }
     }
@@ -135,11 +186,22 @@ Result<const ISettingsResponse *> Engine::settingsReceived()
         NX_PRINT << "SaaS subscription status message update failed!";
     }
 
+    // show the backup bandwidth estimate, if enabled
+    if (ini().enableBandwidthEstimation && !setStatusBanner(&model, kBandwidthStatusBannerId, bandwidthStatusJson()))
+    {
+        NX_PRINT << "Bandwidth status message update failed!";
+    }
+
     // if settings have changed, mount the container
     bool mountSuccessful = false;
     if (mountRequired)
     {
         NX_PRINT << "Settings changed.";
+        if (bucketSettingsChanged)
+        {
+            // the usage history of another bucket, or of another capacity, no longer applies
+            m_capacityTracker.reset();
+        }
         mountSuccessful = mount();
         if (!mountSuccessful)
         {
@@ -152,17 +214,27 @@ Result<const ISettingsResponse *> Engine::settingsReceived()
         mountSuccessful = m_cfManager.isMounted();
     }
     // update the model so user can see mount status
-    auto statusJson = mountSuccessful ? kStatusSuccess : kStatusFailure;
+    const char *statusJson = mountSuccessful ? kStatusSuccess.c_str() : kStatusFailure.c_str();
     if (!setStatusBanner(&model, kBucketStatusBannerId, statusJson))
     {
         // on failure, no changes will be written to the model
         NX_PRINT << "Status message update failed!";
     }
+    // show how fast the bucket is filling up; the usage is measured on the sampling thread, since
+    // listing the bucket may take a while
+    if (mountSuccessful)
+    {
+        startCapacitySampling();
+        if (!setStatusBanner(&model, kCapacityStatusBannerId, capacityStatusJson()))
+        {
+            NX_PRINT << "Capacity status message update failed!";
+        }
+    }
 
     // returning invalid JSON to the VMS will crash the server
     // validate JSON before sending.
     NX_PRINT << "Returning settingsResponse...";
-    auto settingValuesMap = makePtr<StringMap>(values);
+    auto settingValuesMap = makePtr<StringMap>(settings->toMap());
     std::map<std::string, std::string> validSettings;
     if (!logUtils.convertAndOutputStringMap(&validSettings, settingValuesMap.get(), "Validating settingsResponse"))
     {
@@ -172,7 +244,11 @@ Result<const ISettingsResponse *> Engine::settingsReceived()
     }
 
     auto settingsResponse = new SettingsResponse();
-    settingsResponse->setModel(makePtr<String>(Json(model).dump()));
+    // serialize straight into the response string, sized for the model plus the status banners
+    JsonWriter modelWriter;
+    modelWriter.reserve(kEngineSettingsModel.size() + 1024);
+    modelWriter.value(model);
+    settingsResponse->setModel(makePtr<String>(modelWriter.takeBuffer()));
     settingsResponse->setValues(settingValuesMap);
     return settingsResponse;
 }
@@ -215,12 +291,66 @@ bool Engine::mount()
 
 bool Engine::isCompatible(const IDeviceInfo *deviceInfo) const
 {
-    return false;
+    // DeviceAgents are only needed to estimate the backup bandwidth
+    return ini().enableBandwidthEstimation;
 }
 
 void Engine::doObtainDeviceAgent(Result<IDeviceAgent *> *outResult, const IDeviceInfo *deviceInfo)
 {
-    *outResult = nullptr;
+    *outResult = new DeviceAgent(this, deviceInfo);
+}
+
+void Engine::updateDeviceBitrate(const std::string &deviceId, int64_t bitsPerSecond)
+{
+    BandwidthMonitor::Status status;
+    if (m_bandwidthMonitor.updateDeviceBitrate(deviceId, bitsPerSecond, &status))
+    {
+        reportBandwidthChange(status);
+    }
+}
+
+void Engine::removeDevice(const std::string &deviceId)
+{
+    BandwidthMonitor::Status status;
+    if (m_bandwidthMonitor.removeDevice(deviceId, &status))
+    {
+        reportBandwidthChange(status);
+    }
+}
+
+void Engine::reportBandwidthChange(const BandwidthMonitor::Status &status)
+{
+    const std::string description = "Cameras produce " + formatMbps(status.demandBitsPerSecond) +
+                                    " Mbps of video, upload capacity is " + formatMbps(status.capacityBitsPerSecond) +
+                                    " Mbps.";
+    NX_PRINT << "Backup bandwidth " << (status.exceeded ? "exceeds" : "within") << " upload capacity: " << description;
+    if (status.exceeded)
+    {
+        pushPluginDiagnosticEvent(IPluginDiagnosticEvent::Level::warning, "Backup Bandwidth Warning",
+                                  description + " Backups will fall behind the recorded archive.");
+    }
+    else
+    {
+        pushPluginDiagnosticEvent(IPluginDiagnosticEvent::Level::info, "Backup Bandwidth Recovered", description);
+    }
+}
+
+std::string Engine::bandwidthStatusJson()
+{
+    const BandwidthMonitor::Status status = m_bandwidthMonitor.status();
+    std::string text = "Backup bandwidth demand: " + formatMbps(status.demandBitsPerSecond) + " Mbps from " +
+                       std::to_string(status.deviceCount) + " camera(s)";
+    std::string icon = "info";
+    if (status.capacityBitsPerSecond > 0)
+    {
+        text += " of " + formatMbps(status.capacityBitsPerSecond) + " Mbps upload capacity";
+        if (status.demandBitsPerSecond > status.capacityBitsPerSecond)
+        {
+            text += " - backups will fall behind!";
+            icon = "warning";
+        }
+    }
+    return makeBannerJson(kBandwidthStatusBannerId, icon, text);
 }
 
 void Engine::getPluginSideSettings(Result<const ISettingsResponse *> *outResult) const
@@ -236,13 +366,10 @@ void Engine::doGetSettingsOnActiveSettingChange(Result<const IActiveSettingChang
     NX_PRINT << "cloudfuse Engine::doGetSettingsOnActiveSettingChange";
 }
 
-bool Engine::settingsChanged()
+bool Engine::settingsChanged(const SettingsSnapshot &newValues)
 {
-    // pull settings
-    std::map<std::string, std::string> newValues = currentSettings();
-
     // check if settings are empty
-    if (newValues[kKeyIdTextFieldId] == "" && newValues[kSecretKeyPasswordFieldId] == "")
+    if (newValues.value(kKeyIdTextFieldId) == "" && newValues.value(kSecretKeyPasswordFieldId) == "")
     {
         NX_PRINT << "Settings are empty. Ignoring...";
         return false;
@@ -256,44 +383,44 @@ bool Engine::settingsChanged()
     }
 
     // if we're mounted and the settings haven't changed, do nothing
-    if (newValues == m_prevSettings)
+    if (newValues == *m_prevSettings)
     {
         return false;
     }
 
     // we only really care about certain values
     // key ID
-    if (m_prevSettings[kKeyIdTextFieldId] != newValues[kKeyIdTextFieldId])
+    if (m_prevSettings->value(kKeyIdTextFieldId) != newValues.value(kKeyIdTextFieldId))
     {
         return true;
     }
     // secret key
-    if (m_prevSettings[kSecretKeyPasswordFieldId] != newValues[kSecretKeyPasswordFieldId])
+    if (m_prevSettings->value(kSecretKeyPasswordFieldId) != newValues.value(kSecretKeyPasswordFieldId))
     {
         return true;
     }
     if (!credentialsOnly)
     {
         // endpoint
-        if (m_prevSettings[kEndpointUrlTextFieldId] != newValues[kEndpointUrlTextFieldId])
+        if (m_prevSettings->value(kEndpointUrlTextFieldId) != newValues.value(kEndpointUrlTextFieldId))
         {
             // if they're different, but both amount to the same thing, then there is no effective change
-            bool prevIsDefault = m_prevSettings[kEndpointUrlTextFieldId] == kDefaultEndpoint ||
-                                 m_prevSettings[kEndpointUrlTextFieldId] == "";
+            bool prevIsDefault = m_prevSettings->value(kEndpointUrlTextFieldId) == kDefaultEndpoint ||
+                                 m_prevSettings->value(kEndpointUrlTextFieldId) == "";
             bool newIsDefault =
-                newValues[kEndpointUrlTextFieldId] == kDefaultEndpoint || newValues[kEndpointUrlTextFieldId] == "";
+                newValues.value(kEndpointUrlTextFieldId) == kDefaultEndpoint || newValues.value(kEndpointUrlTextFieldId) == "";
             if (!prevIsDefault || !newIsDefault)
             {
                 return true;
             }
         }
         // bucket name
-        if (m_prevSettings[kBucketNameTextFieldId] != newValues[kBucketNameTextFieldId])
+        if (m_prevSettings->value(kBucketNameTextFieldId) != newValues.value(kBucketNameTextFieldId))
         {
             return true;
         }
         // bucket capacity
-        if (m_prevSettings[kBucketSizeTextFieldId] != newValues[kBucketSizeTextFieldId])
+        if (m_prevSettings->value(kBucketSizeTextFieldId) != newValues.value(kBucketSizeTextFieldId))
         {
             return true;
         }
@@ -302,31 +429,41 @@ bool Engine::settingsChanged()
     return false;
 }
 
+bool Engine::bucketChanged(const SettingsSnapshot &newValues) const
+{
+    return m_prevSettings->value(kEndpointUrlTextFieldId) != newValues.value(kEndpointUrlTextFieldId) ||
+           m_prevSettings->value(kBucketNameTextFieldId) != newValues.value(kBucketNameTextFieldId) ||
+           m_prevSettings->value(kBucketSizeTextFieldId) != newValues.value(kBucketSizeTextFieldId);
+}
+
 nx::sdk::Error Engine::validateMount()
 {
+    NX_TIME_HISTOGRAM("validateMount");
     NX_PRINT << "Validating mount options...";
-    std::map<std::string, std::string> values = currentSettings();
-    std::string keyId = values[kKeyIdTextFieldId];
-    std::string secretKey = values[kSecretKeyPasswordFieldId];
+    const std::shared_ptr<const SettingsSnapshot> settings = settingsSnapshot();
+    const std::string &keyId = settings->value(kKeyIdTextFieldId);
+    const std::string &secretKey = settings->value(kSecretKeyPasswordFieldId);
     std::string endpointUrl = kDefaultEndpoint;
     std::string bucketName = "";
     uint64_t bucketCapacityGB = kDefaultBucketSizeGb;
     if (!credentialsOnly)
     {
-        endpointUrl = values[kEndpointUrlTextFieldId];
-        bucketName = values[kBucketNameTextFieldId]; // The default empty string will cause cloudfuse
+        endpointUrl = settings->value(kEndpointUrlTextFieldId);
+        bucketName = settings->value(kBucketNameTextFieldId); // The default empty string will cause cloudfuse
                                                      // to select first available bucket
         try
         {
-            bucketCapacityGB = std::stoi(values[kBucketSizeTextFieldId]);
+            bucketCapacityGB = std::stoi(settings->value(kBucketSizeTextFieldId));
         }
         catch (std::invalid_argument &e)
         {
-            NX_PRINT << "Bad input for bucket capacity: " << values[kBucketSizeTextFieldId];
-            // revert to default - write back to settings so user can see value reset
-            values[kBucketSizeTextFieldId] = std::to_string(kDefaultBucketSizeGb);
+            NX_PRINT << "Bad input for bucket capacity: " << settings->value(kBucketSizeTextFieldId);
+            // revert to default
+            bucketCapacityGB = kDefaultBucketSizeGb;
         }
     }
+    // the capacity cloudfuse displays, in GiB
+    m_bucketCapacityBytes = bucketCapacityGB << 30;
     std::string mountDir = m_cfManager.getMountDir();
     std::string fileCacheDir = m_cfManager.getFileCacheDir();
     // Unmount before mounting
@@ -335,6 +472,7 @@ nx::sdk::Error Engine::validateMount()
     {
         NX_PRINT << "Bucket is mounted. Unmounting...";
         const processReturn unmountReturn = m_cfManager.unmount();
+        m_capacityTracker.invalidate();
         if (unmountReturn.errCode != 0)
         {
             return error(ErrorCode::internalError, "Failed to unmount. Here's why: " + unmountReturn.output);
@@ -449,9 +587,9 @@ nx::sdk::Error Engine::validateMount()
 
 nx::sdk::Error Engine::spawnMount()
 {
-    std::map<std::string, std::string> values = currentSettings();
-    std::string keyId = values[kKeyIdTextFieldId];
-    std::string secretKey = values[kSecretKeyPasswordFieldId];
+    const std::shared_ptr<const SettingsSnapshot> settings = settingsSnapshot();
+    const std::string &keyId = settings->value(kKeyIdTextFieldId);
+    const std::string &secretKey = settings->value(kSecretKeyPasswordFieldId);
     // mount the bucket
     NX_PRINT << "Starting cloud storage mount";
 #if defined(__linux__)
@@ -478,11 +616,120 @@ nx::sdk::Error Engine::spawnMount()
     {
         return error(ErrorCode::internalError, "Cloudfuse was not able to successfully mount");
     }
+    m_capacityTracker.invalidate();
 
     return Error(ErrorCode::noError, nullptr);
 }
 
-bool Engine::setStatusBanner(Json::object *model, std::string bannerId, std::string updatedJson) const
+void Engine::sampleCapacity()
+{
+    // settingsReceived() may unmount or remount the bucket while it is being listed; it bumps the
+    // generation after that, so the listing is dropped instead of skewing the trend
+    const uint64_t generation = m_capacityTracker.generation();
+    if (!m_cfManager.isMounted())
+    {
+        return;
+    }
+    uint64_t usedBytes = 0;
+    if (!measureUsedBytes(generation, &usedBytes))
+    {
+        NX_PRINT << "Failed to read bucket usage";
+        return;
+    }
+    if (!m_capacityTracker.addSample(generation, CapacityTracker::Clock::now(), usedBytes, m_bucketCapacityBytes))
+    {
+        NX_PRINT << "Dropped a bucket usage sample: the bucket was remounted while it was being listed";
+    }
+}
+
+bool Engine::measureUsedBytes(uint64_t generation, uint64_t *outBytes)
+{
+    // The mount is this server's subdirectory of the bucket (see `subdirectory` in the cloudfuse
+    // config template), so its listing counts what this server has backed up, and nothing else.
+    // cloudfuse's attribute cache has long expired between two samples, so every listing goes to
+    // the bucket: only the directories that changed since the previous sample are listed again,
+    // and everything is listed once a day to catch files that grew in place.
+    const auto now = std::chrono::steady_clock::now();
+    if (generation != m_usageCacheGeneration || now - m_usageCacheFullScanTime >= kFullUsageScanInterval)
+    {
+        m_directoryUsage.clear();
+        m_usageCacheGeneration = generation;
+        m_usageCacheFullScanTime = now;
+    }
+    return m_directoryUsage.scan(m_cfManager.getMountDir(), m_stopCapacitySampling, outBytes);
+}
+
+void Engine::startCapacitySampling()
+{
+    std::lock_guard<std::mutex> lock(m_capacitySamplingMutex);
+    // sample right away, so the first forecast does not wait for the whole interval; while there is
+    // a sample of this bucket, saving the settings again does not list it again
+    if (m_capacityTracker.sampleCount() == 0)
+    {
+        m_capacitySampleRequested = true;
+    }
+    if (!m_capacitySamplingThread.joinable())
+    {
+        m_capacitySamplingThread = std::thread([this]() { runCapacitySampling(); });
+    }
+    m_capacitySamplingCondition.notify_all();
+}
+
+void Engine::runCapacitySampling()
+{
+    std::unique_lock<std::mutex> lock(m_capacitySamplingMutex);
+    while (true)
+    {
+        m_capacitySamplingCondition.wait_for(lock, kCapacitySampleInterval,
+                                             [this]() { return m_stopCapacitySampling || m_capacitySampleRequested; });
+        if (m_stopCapacitySampling)
+        {
+            return;
+        }
+        m_capacitySampleRequested = false;
+        lock.unlock();
+        sampleCapacity();
+        lock.lock();
+    }
+}
+
+std::string Engine::capacityStatusJson() const
+{
+    if (m_capacityTracker.sampleCount() == 0)
+    {
+        return makeBannerJson(kCapacityStatusBannerId, "info", "Backup storage: measuring the space used...");
+    }
+    const double usedGb = static_cast<double>(m_capacityTracker.usedBytes()) / kBytesPerGigabyte;
+    const double capacityGb = static_cast<double>(m_capacityTracker.capacityBytes()) / kBytesPerGigabyte;
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << "Backup storage: " << usedGb << " of " << capacityGb
+         << " GB used";
+
+    std::string icon = "info";
+    const double growthGb = m_capacityTracker.growthBytesPerDay() / kBytesPerGigabyte;
+    const double daysUntilFull = m_capacityTracker.daysUntilFull();
+    if (daysUntilFull == 0)
+    {
+        text << " - storage limit reached!";
+        icon = "warning";
+    }
+    else if (growthGb > 0 && daysUntilFull > 0)
+    {
+        text << ", growing " << growthGb << " GB/day - about " << static_cast<int64_t>(daysUntilFull)
+             << " day(s) until full";
+        if (daysUntilFull < kCapacityWarningDays)
+        {
+            icon = "warning";
+        }
+    }
+    else if (!m_capacityTracker.hasTrend())
+    {
+        text << " - collecting usage history to forecast when it will be full";
+    }
+    return makeBannerJson(kCapacityStatusBannerId, icon, text.str());
+}
+
+bool Engine::setStatusBanner(Json *model, std::string bannerId, std::string updatedJson) const
 {
     NX_PRINT << "cloudfuse Engine::setStatusBanner " << bannerId;
 
@@ -496,27 +743,34 @@ bool Engine::setStatusBanner(Json::object *model, std::string bannerId, std::str
     }
 
     // find where to put it
-    auto items = (*model)[kItems];
-    auto itemsArray = items.array_items();
+    // the model may be shared with the cached one, so edit it via the copy-on-write handles
+    Json::object *modelObject = model->mutable_object_items();
+    if (modelObject == nullptr)
+    {
+        NX_PRINT << "Settings model is not a JSON object";
+        return false;
+    }
+    Json &items = (*modelObject)[kItems];
+    if (!items.is_array())
+    {
+        items = Json::array{};
+    }
+    Json::array *itemsArray = items.mutable_array_items();
     // find the status banner, if it's already present
-    auto statusBannerIt = std::find_if(itemsArray.begin(), itemsArray.end(),
-                                       [bannerId](Json &item) { return item[kName].string_value() == bannerId; });
+    auto statusBannerIt = std::find_if(itemsArray->begin(), itemsArray->end(), [&bannerId](const Json &item)
+                                       { return item[kName].string_value() == bannerId; });
     // if the banner is not there, add it
-    if (statusBannerIt == itemsArray.end())
+    if (statusBannerIt == itemsArray->end())
     {
         // add the status banner to the beginning of the list of items
-        itemsArray.insert(itemsArray.begin(), newStatus);
+        itemsArray->insert(itemsArray->begin(), std::move(newStatus));
     }
     else
     {
         // update the status
-        *statusBannerIt = newStatus;
+        *statusBannerIt = std::move(newStatus);
     }
 
-    // write the updated array back into the model Json
-    // TODO: why do we have to do this?
-    (*model)[kItems] = itemsArray;
-
     return true;
 }
 
@@ -542,6 +796,28 @@ void enableLogging(std::string iniDir)
     NX_PRINT << "cloudfuse Engine::enableLogging - plugin stderr logging file: " + stderrFilename;
 }
 
+const Json &parsedEngineSettingsModel(std::string *outParseError)
+{
+    // the model is a compile-time constant, so parse it once and share it between responses
+    static std::string parseError;
+    static const Json model = Json::parse(kEngineSettingsModel.c_str(), parseError);
+    *outParseError = parseError;
+    return model;
+}
+
+std::string formatMbps(int64_t bitsPerSecond)
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(1)
+           << static_cast<double>(bitsPerSecond) / static_cast<double>(kBitsPerMegabit);
+    return stream.str();
+}
+
+std::string makeBannerJson(const std::string &bannerId, const std::string &icon, const std::string &text)
+{
+    return Json(Json::object{{"type", "Banner"}, {kName, bannerId}, {"icon", icon}, {"text", text}}).dump();
+}
+
 std::string generatePassphrase()
 {
     // Generate passphrase for config file
@@ -584,169 +860,4 @@ std::string parseCloudfuseError(std::string error)
     return error.substr(start, end);
 }
 
-processReturn getServerPort()
-{
-#if defined(_WIN32)
-    wchar_t systemRoot[MAX_PATH];
-    GetEnvironmentVariableW(L"SystemRoot", systemRoot, MAX_PATH);
-    const std::wstring regPath = std::wstring(systemRoot) + LR"(\system32\reg.exe)";
-    const std::string registryKey = R"(HKEY_LOCAL_MACHINE\SOFTWARE\Network Optix\Network Optix MetaVMS Media Server)";
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    std::wstring wRegistryKey = converter.from_bytes(registryKey);
-    const std::wstring wargv = regPath + L" query \"" + wRegistryKey + L"\" /v port";
-    const std::wstring wenvp = L"";
-    auto processReturn = ChildProcess::spawnProcess(const_cast<wchar_t *>(wargv.c_str()), wenvp);
-    // return on error (handled by the caller)
-    if (processReturn.errCode != 0)
-    {
-        return processReturn;
-    }
-    // parse the port number from the registry query output
-    std::stringstream textStream(processReturn.output);
-    std::string line;
-    while (std::getline(textStream, line))
-    {
-        // drop \r
-        if (!line.empty() && line.back() == '\r')
-        {
-            line.pop_back();
-        }
-        // skip empty lines, and skip the line repeating the registry key
-        if (line.empty() || line == registryKey)
-        {
-            continue;
-        }
-        // split the line we're interested (example below) by spaces:
-        // "    port    REG_SZ    7001"
-        std::stringstream lineStream(line);
-        std::string token;
-        while (lineStream >> token)
-        {
-            // skip until we get to the port number
-            if (token.empty() || !std::all_of(token.begin(), token.end(), ::isdigit))
-            {
-                continue;
-            }
-            // found the port number
-            // overwrite the output to the port, and return
-            processReturn.output = token;
-            return processReturn;
-        }
-    }
-    // port not found
-    processReturn.errCode = 1;
-#elif defined(__linux__)
-    // grep port /opt/networkoptix-metavms/mediaserver/etc/mediaserver.conf
-    const std::string vmsConfigPath = "/opt/networkoptix-metavms/mediaserver/etc/mediaserver.conf";
-    char *const argv[] = {const_cast<char *>("/usr/bin/sed"), const_cast<char *>("-rn"),
-                          const_cast<char *>("s/port=([0-9]*)/\\1/p"), const_cast<char *>(vmsConfigPath.c_str()), NULL};
-    char *const envp[] = {NULL};
-    auto processReturn = ChildProcess::spawnProcess(argv, envp);
-#endif
-    return processReturn;
-}
-
-SaasSubscriptionResult checkSystemInfo(const std::string port, const std::string apiVersion)
-{
-    // use curl to make a request for system info
-    const std::string vmsSystemInfoUrl = "https://localhost:" + port + "/rest/v" + apiVersion + "/system/info";
-
-#if defined(_WIN32)
-    // convert URL to wstring
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    std::wstring wVmsSystemInfoUrl = converter.from_bytes(vmsSystemInfoUrl);
-    // get curl path so we don't need environment variables
-    wchar_t systemRoot[MAX_PATH];
-    GetEnvironmentVariableW(L"SystemRoot", systemRoot, MAX_PATH);
-    const std::wstring curlPath = std::wstring(systemRoot) + LR"(\system32\curl.exe)";
-    const std::wstring wargv = curlPath + L" -sk -m 2 " + wVmsSystemInfoUrl;
-    const std::wstring wenvp = L"";
-    auto processReturn = ChildProcess::spawnProcess(const_cast<wchar_t *>(wargv.c_str()), wenvp);
-#elif defined(__linux__)
-    char *const argv[] = {const_cast<char *>("/usr/bin/curl"),
-                          const_cast<char *>("-sk"),
-                          const_cast<char *>("-m"),
-                          const_cast<char *>("2"),
-                          const_cast<char *>(vmsSystemInfoUrl.c_str()),
-                          NULL};
-    char *const envp[] = {NULL};
-    auto processReturn = ChildProcess::spawnProcess(argv, envp);
-#endif
-
-    // did curl fail?
-    if (processReturn.errCode != 0)
-    {
-        NX_PRINT << "cloudfuse Engine::Engine Failed to get media server system information. Here's why: "
-                 << processReturn.output << "(error code " << std::to_string(processReturn.errCode) << ")";
-        return SaasSubscriptionResult::Error;
-    }
-
-    // try to parse JSON data
-    std::string parseError;
-    auto systemInfo = Json::parse(processReturn.output, parseError);
-    if (!parseError.empty())
-    {
-        NX_PRINT << "Failed to parse media server system info JSON. Here's why: " + parseError;
-        NX_PRINT << "Entire JSON input: " << processReturn.output;
-        return SaasSubscriptionResult::Error;
-    }
-
-    // check for an API error
-    if (systemInfo["error"].is_string())
-    {
-        NX_PRINT << "Media server API error: " + systemInfo.dump();
-        // I've seen this as an API version mismatch error - retry with version 2
-        if (apiVersion == "3")
-        {
-            return checkSystemInfo(port, "2");
-        }
-        else if (apiVersion == "2")
-        {
-            return checkSystemInfo(port, "1");
-        }
-        else
-        {
-            return SaasSubscriptionResult::Error;
-        }
-    }
-
-    // got a result - look for the organizationId
-    auto orgId = systemInfo["organizationId"];
-    if (orgId.is_string() && !orgId.string_value().empty())
-    {
-        NX_PRINT << "found organizationId";
-        return SaasSubscriptionResult::SubscriptionValid;
-    }
-    else
-    {
-        NX_PRINT << "organizationId field not found in mediaserver system information";
-        return SaasSubscriptionResult::NoSubscription;
-    }
-}
-
-SaasSubscriptionResult checkSaasSubscription()
-{
-    // first, get the server port number
-    auto portProcessReturn = getServerPort();
-    if (portProcessReturn.errCode != 0)
-    {
-        NX_PRINT << "cloudfuse Engine::Engine Failed to get media server port number. Here's why: "
-                 << portProcessReturn.output;
-        return SaasSubscriptionResult::Error;
-    }
-    std::string port = portProcessReturn.output;
-    // strip endline(s) and check that the port is numeric
-    while (!port.empty() && (port.back() == '\n' || port.back() == '\r'))
-    {
-        port.erase(port.size() - 1);
-    }
-    if (port.empty() || !std::all_of(port.begin(), port.end(), ::isdigit))
-    {
-        NX_PRINT << "unexpected non-numeric media server port number: " << port;
-        return SaasSubscriptionResult::Error;
-    }
-    // check server system info and return result
-    return checkSystemInfo(port, "3");
-}
-
 } // namespace settings
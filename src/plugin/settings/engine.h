@@ -3,12 +3,25 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #include <nx/kit/json.h>
 #include <nx/sdk/analytics/helpers/engine.h>
 #include <nx/sdk/analytics/helpers/plugin.h>
 
 #include <cloudfuse/child_process.h>
 
+#include "bandwidth_monitor.h"
+#include "capacity_tracker.h"
+#include "directory_usage.h"
+
 namespace settings
 {
 
@@ -23,6 +36,10 @@ class Engine : public nx::sdk::analytics::Engine
         return m_plugin;
     }
 
+    // called by DeviceAgents to report the bitrate of the stream that will be backed up
+    void updateDeviceBitrate(const std::string &deviceId, int64_t bitsPerSecond);
+    void removeDevice(const std::string &deviceId);
+
   protected:
     virtual std::string manifestString() const override;
 
@@ -42,18 +59,42 @@ class Engine : public nx::sdk::analytics::Engine
         const nx::sdk::IActiveSettingChangedAction *activeSettingChangedAction) override;
 
   private:
-    bool settingsChanged();
+    bool settingsChanged(const nx::sdk::SettingsSnapshot &newValues);
+    bool bucketChanged(const nx::sdk::SettingsSnapshot &newValues) const;
     nx::sdk::Error validateMount();
     nx::sdk::Error spawnMount();
-    bool setStatusBanner(nx::kit::detail::json11::Json::object *model, std::string bannerId,
+    bool setStatusBanner(nx::kit::Json *model, std::string bannerId,
                          std::string updatedContent) const;
+    void reportBandwidthChange(const BandwidthMonitor::Status &status);
+    std::string bandwidthStatusJson();
+    void sampleCapacity();
+    bool measureUsedBytes(uint64_t generation, uint64_t *outBytes);
+    void startCapacitySampling();
+    void runCapacitySampling();
+    std::string capacityStatusJson() const;
 
   private:
     nx::sdk::analytics::Plugin *const m_plugin;
     CloudfuseMngr m_cfManager;
-    std::map<std::string, std::string> m_prevSettings;
+    std::shared_ptr<const nx::sdk::SettingsSnapshot> m_prevSettings = nx::sdk::SettingsSnapshot::empty();
     std::string m_passphrase;
     bool m_saasSubscriptionValid;
+
+    // backup bandwidth estimation (see ini().enableBandwidthEstimation)
+    BandwidthMonitor m_bandwidthMonitor;
+
+    // bucket fill-time forecast, sampled periodically on a background thread, started on mount
+    CapacityTracker m_capacityTracker;
+    std::atomic<uint64_t> m_bucketCapacityBytes{0};
+    std::mutex m_capacitySamplingMutex;
+    std::condition_variable m_capacitySamplingCondition;
+    std::atomic<bool> m_stopCapacitySampling{false};
+    bool m_capacitySampleRequested = false;
+    std::thread m_capacitySamplingThread;
+    // used only by the sampling thread
+    DirectoryUsage m_directoryUsage;
+    uint64_t m_usageCacheGeneration = 0;
+    std::chrono::steady_clock::time_point m_usageCacheFullScanTime;
 };
 
 } // namespace settings
@@ -3,11 +3,19 @@
 
 #include "plugin.h"
 
+#include <nx/kit/async_log_sink.h>
 #include <nx/kit/debug.h>
+#include <nx/kit/output_rotation.h>
 #include <nx/kit/utils.h>
+#include <nx/sdk/helpers/object_pool.h>
+#include <nx/sdk/helpers/plugin_diagnostic_event.h>
+#include <nx/sdk/helpers/settings_response.h>
+#include <nx/sdk/helpers/string.h>
+#include <nx/sdk/helpers/string_map.h>
 
 #include "engine.h"
 #include "settings_model.h"
+#include "stub_analytics_plugin_settings_ini.h"
 
 namespace settings
 {
@@ -15,25 +23,64 @@ namespace settings
 using namespace nx::sdk;
 using namespace nx::sdk::analytics;
 
-Result<IEngine *> Plugin::doObtainEngine()
+Plugin::Plugin()
 {
-    return new Engine(this);
+    nx::kit::debug::setLogLevel(ini().logLevel);
+    nx::kit::debug::LatencyHistogram::setDumpPeriodMs(int64_t(ini().latencySummaryPeriodS) * 1000);
+
+    // Every settings round-trip creates these objects anew; optionally recycle their memory.
+    if (ini().enableObjectPools)
+    {
+        ObjectPool<SettingsResponse>::instance().setEnabled(true);
+        ObjectPool<StringMap>::instance().setEnabled(true);
+        ObjectPool<String>::instance().setEnabled(true);
+        ObjectPool<PluginDiagnosticEvent>::instance().setEnabled(true);
+    }
+
+    if (ini().enableAsyncLogging)
+        nx::kit::AsyncLogSink::start();
+
+    // the redirected logs live on the system drive, next to the recordings: keep them bounded
+    if (ini().maxLogFileSizeMb > 0)
+    {
+        nx::kit::OutputRotation::Options options;
+        options.maxFileSize = int64_t(ini().maxLogFileSizeMb) * 1024 * 1024;
+        options.keptFileCount = ini().rotatedLogFileCount;
+        if (ini().compressRotatedLogs)
+            options.compression = nx::kit::OutputRotation::Compression::gzip;
+        nx::kit::OutputRotation::start(options);
+    }
+
+    // let the log settings be changed on a running server
+    if (ini().watchIniFile)
+        ini().startWatching([]() { nx::kit::debug::setLogLevel(ini().logLevel); });
 }
 
-std::string Plugin::manifestString() const
+Plugin::~Plugin()
 {
-    return /*suppress newline*/ 1 + (const char *)R"json(
+    ini().stopWatching();
+    nx::kit::OutputRotation::stop();
+    nx::kit::AsyncLogSink::stop();
+}
+
+Result<IEngine *> Plugin::doObtainEngine()
 {
-    "id": ")json" +
-           instanceId() + R"json(",
+    return new Engine(this);
+}
+
+static constexpr auto kPluginManifest = StaticString(R"json({
+    "id": ")json") + Plugin::kInstanceId + R"json(",
     "name": "Lyve Cloud Backup Storage",
     "description": "Connect a cloud storage container as a backup location.",
     "version": "0.6.1",
     "vendor": "Seagate Technology",
-    "engineSettingsModel": )json" +
-           kEngineSettingsModel + R"json(
+    "engineSettingsModel": )json" + kEngineSettingsModel + R"json(
 }
 )json";
+
+std::string Plugin::manifestString() const
+{
+    return kPluginManifest.str();
 }
 
 } // namespace settings
@@ -12,13 +12,16 @@ namespace settings
 class Plugin : public nx::sdk::analytics::Plugin
 {
   public:
-    Plugin() = default;
+    static constexpr char kInstanceId[] = "seagate.cloudfuse";
+
+    Plugin();
+    virtual ~Plugin() override;
 
   protected:
     virtual nx::sdk::Result<nx::sdk::analytics::IEngine *> doObtainEngine() override;
     virtual std::string instanceId() const override
     {
-        return "seagate.cloudfuse";
+        return kInstanceId;
     }
     virtual std::string manifestString() const override;
 };
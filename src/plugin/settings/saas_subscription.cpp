@@ -0,0 +1,190 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#include "saas_subscription.h"
+
+#include <algorithm>
+#include <codecvt>
+#include <sstream>
+#include <string>
+
+#include <cloudfuse/child_process.h>
+
+#define NX_PRINT_PREFIX "[cloudfuse] "
+#include <nx/kit/debug.h>
+#include <nx/kit/json.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace settings
+{
+
+using nx::kit::Json;
+
+static processReturn getServerPort()
+{
+#if defined(_WIN32)
+    wchar_t systemRoot[MAX_PATH];
+    GetEnvironmentVariableW(L"SystemRoot", systemRoot, MAX_PATH);
+    const std::wstring regPath = std::wstring(systemRoot) + LR"(\system32\reg.exe)";
+    const std::string registryKey = R"(HKEY_LOCAL_MACHINE\SOFTWARE\Network Optix\Network Optix MetaVMS Media Server)";
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    std::wstring wRegistryKey = converter.from_bytes(registryKey);
+    const std::wstring wargv = regPath + L" query \"" + wRegistryKey + L"\" /v port";
+    const std::wstring wenvp = L"";
+    auto processReturn = ChildProcess::spawnProcess(const_cast<wchar_t *>(wargv.c_str()), wenvp);
+    // return on error (handled by the caller)
+    if (processReturn.errCode != 0)
+    {
+        return processReturn;
+    }
+    // parse the port number from the registry query output
+    std::stringstream textStream(processReturn.output);
+    std::string line;
+    while (std::getline(textStream, line))
+    {
+        // drop \r
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        // skip empty lines, and skip the line repeating the registry key
+        if (line.empty() || line == registryKey)
+        {
+            continue;
+        }
+        // split the line we're interested (example below) by spaces:
+        // "    port    REG_SZ    7001"
+        std::stringstream lineStream(line);
+        std::string token;
+        while (lineStream >> token)
+        {
+            // skip until we get to the port number
+            if (token.empty() || !std::all_of(token.begin(), token.end(), ::isdigit))
+            {
+                continue;
+            }
+            // found the port number
+            // overwrite the output to the port, and return
+            processReturn.output = token;
+            return processReturn;
+        }
+    }
+    // port not found
+    processReturn.errCode = 1;
+#elif defined(__linux__)
+    // grep port /opt/networkoptix-metavms/mediaserver/etc/mediaserver.conf
+    const std::string vmsConfigPath = "/opt/networkoptix-metavms/mediaserver/etc/mediaserver.conf";
+    char *const argv[] = {const_cast<char *>("/usr/bin/sed"), const_cast<char *>("-rn"),
+                          const_cast<char *>("s/port=([0-9]*)/\\1/p"), const_cast<char *>(vmsConfigPath.c_str()), NULL};
+    char *const envp[] = {NULL};
+    auto processReturn = ChildProcess::spawnProcess(argv, envp);
+#endif
+    return processReturn;
+}
+
+static SaasSubscriptionResult checkSystemInfo(const std::string port, const std::string apiVersion)
+{
+    // use curl to make a request for system info
+    const std::string vmsSystemInfoUrl = "https://localhost:" + port + "/rest/v" + apiVersion + "/system/info";
+
+#if defined(_WIN32)
+    // convert URL to wstring
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    std::wstring wVmsSystemInfoUrl = converter.from_bytes(vmsSystemInfoUrl);
+    // get curl path so we don't need environment variables
+    wchar_t systemRoot[MAX_PATH];
+    GetEnvironmentVariableW(L"SystemRoot", systemRoot, MAX_PATH);
+    const std::wstring curlPath = std::wstring(systemRoot) + LR"(\system32\curl.exe)";
+    const std::wstring wargv = curlPath + L" -sk -m 2 " + wVmsSystemInfoUrl;
+    const std::wstring wenvp = L"";
+    auto processReturn = ChildProcess::spawnProcess(const_cast<wchar_t *>(wargv.c_str()), wenvp);
+#elif defined(__linux__)
+    char *const argv[] = {const_cast<char *>("/usr/bin/curl"),
+                          const_cast<char *>("-sk"),
+                          const_cast<char *>("-m"),
+                          const_cast<char *>("2"),
+                          const_cast<char *>(vmsSystemInfoUrl.c_str()),
+                          NULL};
+    char *const envp[] = {NULL};
+    auto processReturn = ChildProcess::spawnProcess(argv, envp);
+#endif
+
+    // did curl fail?
+    if (processReturn.errCode != 0)
+    {
+        NX_PRINT << "cloudfuse Engine::Engine Failed to get media server system information. Here's why: "
+                 << processReturn.output << "(error code " << std::to_string(processReturn.errCode) << ")";
+        return SaasSubscriptionResult::Error;
+    }
+
+    // try to parse JSON data
+    std::string parseError;
+    auto systemInfo = Json::parse(processReturn.output, parseError);
+    if (!parseError.empty())
+    {
+        NX_PRINT << "Failed to parse media server system info JSON. Here's why: " + parseError;
+        NX_PRINT << "Entire JSON input: " << processReturn.output;
+        return SaasSubscriptionResult::Error;
+    }
+
+    // check for an API error
+    if (systemInfo["error"].is_string())
+    {
+        NX_PRINT << "Media server API error: " + systemInfo.dump();
+        // I've seen this as an API version mismatch error - retry with version 2
+        if (apiVersion == "3")
+        {
+            return checkSystemInfo(port, "2");
+        }
+        else if (apiVersion == "2")
+        {
+            return checkSystemInfo(port, "1");
+        }
+        else
+        {
+            return SaasSubscriptionResult::Error;
+        }
+    }
+
+    // got a result - look for the organizationId
+    auto orgId = systemInfo["organizationId"];
+    if (orgId.is_string() && !orgId.string_value().empty())
+    {
+        NX_PRINT << "found organizationId";
+        return SaasSubscriptionResult::SubscriptionValid;
+    }
+    else
+    {
+        NX_PRINT << "organizationId field not found in mediaserver system information";
+        return SaasSubscriptionResult::NoSubscription;
+    }
+}
+
+SaasSubscriptionResult checkSaasSubscription()
+{
+    // first, get the server port number
+    auto portProcessReturn = getServerPort();
+    if (portProcessReturn.errCode != 0)
+    {
+        NX_PRINT << "cloudfuse Engine::Engine Failed to get media server port number. Here's why: "
+                 << portProcessReturn.output;
+        return SaasSubscriptionResult::Error;
+    }
+    std::string port = portProcessReturn.output;
+    // strip endline(s) and check that the port is numeric
+    while (!port.empty() && (port.back() == '\n' || port.back() == '\r'))
+    {
+        port.erase(port.size() - 1);
+    }
+    if (port.empty() || !std::all_of(port.begin(), port.end(), ::isdigit))
+    {
+        NX_PRINT << "unexpected non-numeric media server port number: " << port;
+        return SaasSubscriptionResult::Error;
+    }
+    // check server system info and return result
+    return checkSystemInfo(port, "3");
+}
+
+} // namespace settings
@@ -0,0 +1,19 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#pragma once
+
+namespace settings
+{
+
+enum class SaasSubscriptionResult
+{
+    SubscriptionValid,
+    NoSubscription,
+    Error
+};
+
+// Asks the local media server, over its REST API, whether the system belongs to an organization
+// with a SaaS subscription. Spawns processes to find the server port and to make the request.
+SaasSubscriptionResult checkSaasSubscription();
+
+} // namespace settings
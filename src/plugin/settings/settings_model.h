@@ -4,24 +4,25 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
+
+#include "static_string.h"
 
 namespace settings
 {
 
-static const std::string kName = "name";
-static const std::string kItems = "items";
+inline constexpr char kName[] = "name";
+inline constexpr char kItems[] = "items";
 
 // Enable this flag hide all but the credentials section
 // NOTE: enabling this will prevent the user from changing the default endpoint (kDefaultEndpoint)
 // Only set this flag true if you want to tie your users to a specific cloud storage endpoint
-static const bool credentialsOnly = false;
+inline constexpr bool credentialsOnly = false;
 
 // credentials
-static const std::string kKeyIdTextFieldId = "keyId";
-static const std::string kSecretKeyPasswordFieldId = "secretKey";
-static const std::string kCheckCredentialsButtonId = "checkCredentialsButton";
-static const std::string kCredentialGroupBox = R"json(
+inline constexpr char kKeyIdTextFieldId[] = "keyId";
+inline constexpr char kSecretKeyPasswordFieldId[] = "secretKey";
+inline constexpr char kCheckCredentialsButtonId[] = "checkCredentialsButton";
+inline constexpr auto kCredentialGroupBox = StaticString(R"json(
         {
             "type": "GroupBox",
             "caption": "Credentials",
@@ -29,7 +30,7 @@ static const std::string kCredentialGroupBox = R"json(
             [
                 {
                     "type": "TextField",
-                    "name": ")json" + kKeyIdTextFieldId +
+                    "name": ")json") + kKeyIdTextFieldId +
                                                R"json(",
                     "caption": "Access Key ID",
                     "description": "Cloud bucket access key ID",
@@ -47,12 +48,13 @@ static const std::string kCredentialGroupBox = R"json(
         })json";
 
 // advanced
-static const std::string kEndpointUrlTextFieldId = "endpointUrl";
-static const std::string kDefaultEndpoint = "https://s3.us-east-1.lyvecloud.seagate.com";
-static const std::string kBucketNameTextFieldId = "bucketName";
-static const std::string kBucketSizeTextFieldId = "bucketCapacity";
-static const uint64_t kDefaultBucketSizeGb = 1024;
-static const std::string kAdvancedGroupBox = R"json(
+inline constexpr char kEndpointUrlTextFieldId[] = "endpointUrl";
+inline constexpr char kDefaultEndpoint[] = "https://s3.us-east-1.lyvecloud.seagate.com";
+inline constexpr char kBucketNameTextFieldId[] = "bucketName";
+inline constexpr char kBucketSizeTextFieldId[] = "bucketCapacity";
+inline constexpr uint64_t kDefaultBucketSizeGb = 1024;
+inline constexpr char kUploadCapacityTextFieldId[] = "uploadCapacityMbps";
+inline constexpr auto kAdvancedGroupBox = StaticString(R"json(
         {
             "type": "GroupBox",
             "caption": "Advanced Settings",
@@ -60,7 +62,7 @@ static const std::string kAdvancedGroupBox = R"json(
             [
                 {
                     "type": "TextField",
-                    "name": ")json" + kEndpointUrlTextFieldId +
+                    "name": ")json") + kEndpointUrlTextFieldId +
                                              R"json(",
                     "caption": "Endpoint URL",
                     "description": "Set a different endpoint (different region or service)",
@@ -81,80 +83,96 @@ static const std::string kAdvancedGroupBox = R"json(
                                              R"json(",
                     "caption": "Backup Storage Limit (in GB)",
                     "description": "Maximum data this server should back up - default is )json" +
-                                             std::to_string(kDefaultBucketSizeGb) +
+                                             toStaticString<kDefaultBucketSizeGb>() +
                                              R"json(GB",
-                    "defaultValue": )json" + std::to_string(kDefaultBucketSizeGb) +
+                    "defaultValue": )json" + toStaticString<kDefaultBucketSizeGb>() +
                                              R"json(,
                     "minValue": 1,
                     "maxValue": 1000000000
+                },
+                {
+                    "type": "SpinBox",
+                    "name": ")json" + kUploadCapacityTextFieldId +
+                                             R"json(",
+                    "caption": "Upload Bandwidth (in Mbps)",
+                    "description": "Measured upload bandwidth to the cloud, used to warn when backups cannot keep up (0 disables the check)",
+                    "defaultValue": 0,
+                    "minValue": 0,
+                    "maxValue": 1000000
                 }
             ]
         })json";
 
-static const std::string kPluginWebsiteLink = R"json(
+inline constexpr auto kPluginWebsiteLink = StaticString(R"json(
         {
             "type": "Link",
             "caption": "Plugin Website",
             "url": "https://github.com/Seagate/nx-lyve-cloud-plugin"
-        })json";
+        })json");
 
 // gather settings items together
-static const std::string kSettingsItems =
-    kCredentialGroupBox + (credentialsOnly ? "" : ("," + kAdvancedGroupBox + "," + kPluginWebsiteLink));
+inline constexpr auto kSettingsItems = []
+{
+    if constexpr (credentialsOnly)
+        return kCredentialGroupBox;
+    else
+        return kCredentialGroupBox + "," + kAdvancedGroupBox + "," + kPluginWebsiteLink;
+}();
 
 // top-level settings model
-static const std::string kEngineSettingsModel = /*suppress newline*/ 1 + R"json(
-{
+inline constexpr auto kEngineSettingsModel = StaticString(R"json({
     "type": "Settings",
     "items":
-    [)json" + kSettingsItems + R"json(
+    [)json") + kSettingsItems + R"json(
     ]
 }
 )json";
 
 // status
-static const std::string kBucketStatusBannerId = "connectionStatus";
-static const std::string kSubscriptionStatusBannerId = "subscriptionStatus";
-static const std::string kStatusSuccess = R"json(
+inline constexpr char kBucketStatusBannerId[] = "connectionStatus";
+inline constexpr char kSubscriptionStatusBannerId[] = "subscriptionStatus";
+inline constexpr char kBandwidthStatusBannerId[] = "bandwidthStatus";
+inline constexpr char kCapacityStatusBannerId[] = "capacityStatus";
+inline constexpr auto kStatusSuccess = StaticString(R"json(
         {
             "type": "Banner",
-            "name": ")json" + kBucketStatusBannerId +
+            "name": ")json") + kBucketStatusBannerId +
                                           R"json(",
             "icon": "info",
             "text": "Cloud storage connected successfully!"
         }
 )json";
-static const std::string kStatusFailure = R"json(
+inline constexpr auto kStatusFailure = StaticString(R"json(
         {
             "type": "Banner",
-            "name": ")json" + kBucketStatusBannerId +
+            "name": ")json") + kBucketStatusBannerId +
                                           R"json(",
             "icon": "warning",
             "text": "Cloud storage connection failed!"
         }
 )json";
-static const std::string kStatusSaaSSubscriptionVerified = R"json(
+inline constexpr auto kStatusSaaSSubscriptionVerified = StaticString(R"json(
         {
             "type": "Banner",
-            "name": ")json" + kSubscriptionStatusBannerId +
+            "name": ")json") + kSubscriptionStatusBannerId +
                                                            R"json(",
             "icon": "info",
             "text": "Plugin authorized - SaaS subscription verified"
         }
 )json";
-static const std::string kStatusNoSaaSSubscription = R"json(
+inline constexpr auto kStatusNoSaaSSubscription = StaticString(R"json(
         {
             "type": "Banner",
-            "name": ")json" + kSubscriptionStatusBannerId +
+            "name": ")json") + kSubscriptionStatusBannerId +
                                                      R"json(",
             "icon": "warning",
             "text": "Plugin unauthorized - SaaS subscription required"
         }
 )json";
-static const std::string kStatusUnkownSaaSSubscription = R"json(
+inline constexpr auto kStatusUnkownSaaSSubscription = StaticString(R"json(
         {
             "type": "Banner",
-            "name": ")json" + kSubscriptionStatusBannerId +
+            "name": ")json") + kSubscriptionStatusBannerId +
                                                          R"json(",
             "icon": "info",
             "text": "SaaS subscription status: Pending verification"
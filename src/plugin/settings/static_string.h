@@ -0,0 +1,112 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace settings
+{
+
+/**
+ * Fixed-size string which can be concatenated at compile time, so that JSON documents assembled
+ * from pieces (like the settings model) end up in the binary as single read-only literals instead
+ * of being built by static initializers in every translation unit.
+ *
+ * Usage: `constexpr auto kJson = StaticString(R"json({"name": ")json") + kNameId + "\"}";` - at
+ * least one operand of each `+` must be a StaticString; the other may be a string literal or a
+ * `constexpr char[]`.
+ */
+template <std::size_t N> struct StaticString
+{
+    char chars[N + 1] = {};
+
+    constexpr StaticString() = default;
+
+    constexpr StaticString(const char (&literal)[N + 1])
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            chars[i] = literal[i];
+    }
+
+    constexpr std::size_t size() const
+    {
+        return N;
+    }
+
+    constexpr const char *c_str() const
+    {
+        return chars;
+    }
+
+    constexpr operator std::string_view() const
+    {
+        return std::string_view(chars, N);
+    }
+
+    std::string str() const
+    {
+        return std::string(chars, N);
+    }
+};
+
+template <std::size_t N> StaticString(const char (&)[N]) -> StaticString<N - 1>;
+
+namespace detail
+{
+
+template <std::size_t N, std::size_t M>
+constexpr StaticString<N + M> concat(const char *first, const char *second)
+{
+    StaticString<N + M> result;
+    for (std::size_t i = 0; i < N; ++i)
+        result.chars[i] = first[i];
+    for (std::size_t i = 0; i < M; ++i)
+        result.chars[N + i] = second[i];
+    return result;
+}
+
+} // namespace detail
+
+template <std::size_t N, std::size_t M>
+constexpr StaticString<N + M> operator+(const StaticString<N> &first, const StaticString<M> &second)
+{
+    return detail::concat<N, M>(first.chars, second.chars);
+}
+
+template <std::size_t N, std::size_t M>
+constexpr StaticString<N + M - 1> operator+(const StaticString<N> &first, const char (&second)[M])
+{
+    return detail::concat<N, M - 1>(first.chars, second);
+}
+
+template <std::size_t N, std::size_t M>
+constexpr StaticString<N + M - 1> operator+(const char (&first)[N], const StaticString<M> &second)
+{
+    return detail::concat<N - 1, M>(first, second.chars);
+}
+
+/** @return Decimal representation of the number, like std::to_string() at compile time. */
+template <std::uint64_t kValue> constexpr auto toStaticString()
+{
+    constexpr std::size_t digitCount = [] {
+        std::size_t count = 1;
+        for (std::uint64_t value = kValue; value >= 10; value /= 10)
+            ++count;
+        return count;
+    }();
+
+    StaticString<digitCount> result;
+    std::uint64_t value = kValue;
+    for (std::size_t i = digitCount; i > 0; --i)
+    {
+        result.chars[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return result;
+}
+
+} // namespace settings
@@ -18,7 +18,36 @@ struct Ini : public nx::kit::IniConfig
 
     NX_INI_FLAG(0, enableOutput, "");
 
+    NX_INI_FLAG(0, watchIniFile,
+                "Reload this file when it changes. logLevel applies at once; enableOutput applies to the engines "
+                "and device agents created afterwards.");
+
+    NX_INI_INT(0, logLevel,
+               "Minimum level of the log output: 0 trace, 1 debug, 2 info, 3 warn, 4 error, 5 none. Trace and debug also "
+               "require enableOutput.");
+
     NX_INI_FLAG(0, deviceDependent, "Respective capability in the manifest.");
+
+    NX_INI_FLAG(0, enableBandwidthEstimation,
+                "Receive compressed video from each camera to estimate the bandwidth needed to back it up.");
+
+    NX_INI_FLAG(0, enableObjectPools,
+                "Reuse the memory of settings responses, strings and diagnostic events instead of the heap.");
+
+    NX_INI_INT(600, latencySummaryPeriodS,
+               "How often to log the latency percentiles of mounting, validation and settings; 0 disables.");
+
+    NX_INI_FLAG(0, enableAsyncLogging,
+                "Write the log from a background thread, so that logging never blocks the caller.");
+
+    NX_INI_INT(0, maxLogFileSizeMb,
+               "Rotate the redirected stdout/stderr log files when they exceed this size; 0 disables rotation. "
+               "Rotation reopens stdout/stderr of the whole Server process.");
+
+    NX_INI_INT(3, rotatedLogFileCount, "How many rotated log files to keep.");
+
+    NX_INI_FLAG(1, compressRotatedLogs,
+                "Compress the rotated log files with gzip, if the plugin is built with nxKitWithZlib.");
 };
 
 Ini &ini();
@@ -0,0 +1,88 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#include <cstdint>
+#include <limits>
+
+#include <nx/kit/test.h>
+
+#include "settings/bandwidth_monitor.h"
+
+namespace settings::test
+{
+
+static const int64_t kMbps = 1000 * 1000;
+
+TEST(BandwidthMonitor, aggregation)
+{
+    BandwidthMonitor monitor;
+    ASSERT_EQ(0, monitor.status().demandBitsPerSecond);
+    ASSERT_EQ(0U, monitor.status().deviceCount);
+
+    monitor.updateDeviceBitrate("camera1", 4 * kMbps);
+    monitor.updateDeviceBitrate("camera2", 6 * kMbps);
+    ASSERT_EQ(10 * kMbps, monitor.status().demandBitsPerSecond);
+    ASSERT_EQ(2U, monitor.status().deviceCount);
+
+    // a new report from the same device replaces its previous bitrate
+    monitor.updateDeviceBitrate("camera1", 2 * kMbps);
+    ASSERT_EQ(8 * kMbps, monitor.status().demandBitsPerSecond);
+    ASSERT_EQ(2U, monitor.status().deviceCount);
+
+    monitor.removeDevice("camera2");
+    ASSERT_EQ(2 * kMbps, monitor.status().demandBitsPerSecond);
+    ASSERT_EQ(1U, monitor.status().deviceCount);
+
+    monitor.removeDevice("unknown");
+    ASSERT_EQ(1U, monitor.status().deviceCount);
+}
+
+TEST(BandwidthMonitor, transitions)
+{
+    BandwidthMonitor monitor;
+    BandwidthMonitor::Status status;
+
+    // without a capacity, the demand is never reported
+    ASSERT_FALSE(monitor.updateDeviceBitrate("camera1", 50 * kMbps, &status));
+    ASSERT_FALSE(status.exceeded);
+
+    ASSERT_TRUE(monitor.setUploadCapacityMbps(40, &status));
+    ASSERT_TRUE(status.exceeded);
+    ASSERT_EQ(50 * kMbps, status.demandBitsPerSecond);
+    ASSERT_EQ(40 * kMbps, status.capacityBitsPerSecond);
+
+    // staying above the capacity is not a transition
+    ASSERT_FALSE(monitor.updateDeviceBitrate("camera1", 60 * kMbps, &status));
+    ASSERT_TRUE(status.exceeded);
+    ASSERT_FALSE(monitor.updateDeviceBitrate("camera2", 1 * kMbps));
+
+    // a demand equal to the capacity still fits
+    ASSERT_TRUE(monitor.updateDeviceBitrate("camera1", 39 * kMbps, &status));
+    ASSERT_FALSE(status.exceeded);
+    ASSERT_EQ(40 * kMbps, status.demandBitsPerSecond);
+
+    ASSERT_TRUE(monitor.updateDeviceBitrate("camera3", 5 * kMbps));
+    ASSERT_TRUE(monitor.removeDevice("camera3", &status));
+    ASSERT_FALSE(status.exceeded);
+
+    // disabling the check recovers from an exceeded demand
+    ASSERT_TRUE(monitor.updateDeviceBitrate("camera3", 5 * kMbps));
+    ASSERT_TRUE(monitor.setUploadCapacityMbps(0, &status));
+    ASSERT_FALSE(status.exceeded);
+    ASSERT_FALSE(monitor.status().exceeded);
+}
+
+TEST(BandwidthMonitor, capacityClamping)
+{
+    BandwidthMonitor monitor;
+
+    monitor.setUploadCapacityMbps(std::numeric_limits<int64_t>::max());
+    ASSERT_EQ(BandwidthMonitor::kMaxUploadCapacityMbps * kMbps, monitor.status().capacityBitsPerSecond);
+
+    monitor.setUploadCapacityMbps(-1);
+    ASSERT_EQ(0, monitor.status().capacityBitsPerSecond);
+
+    monitor.updateDeviceBitrate("camera1", -1);
+    ASSERT_EQ(0, monitor.status().demandBitsPerSecond);
+}
+
+} // namespace settings::test
@@ -0,0 +1,161 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include <nx/kit/test.h>
+
+#include "settings/capacity_tracker.h"
+
+namespace settings::test
+{
+
+using namespace std::chrono_literals;
+
+static const uint64_t kGigabyte = 1024 * 1024 * 1024;
+static const uint64_t kCapacity = 100 * kGigabyte;
+
+static bool near(double expected, double actual)
+{
+    return std::abs(expected - actual) <= std::abs(expected) * 1e-9 + 1e-6;
+}
+
+TEST(CapacityTracker, emptyHistory)
+{
+    CapacityTracker tracker;
+    ASSERT_EQ(0U, tracker.sampleCount());
+    ASSERT_EQ(0U, tracker.usedBytes());
+    ASSERT_EQ(0U, tracker.capacityBytes());
+    ASSERT_FALSE(tracker.hasTrend());
+    ASSERT_EQ(0.0, tracker.growthBytesPerDay());
+    ASSERT_TRUE(tracker.daysUntilFull() < 0);
+}
+
+TEST(CapacityTracker, notEnoughHistory)
+{
+    CapacityTracker tracker;
+    const auto start = CapacityTracker::Clock::now();
+
+    // enough samples, but over too short a span to tell a trend from a single large upload
+    tracker.addSample(tracker.generation(), start, 10 * kGigabyte, kCapacity);
+    tracker.addSample(tracker.generation(), start + 10min, 11 * kGigabyte, kCapacity);
+    tracker.addSample(tracker.generation(), start + 20min, 12 * kGigabyte, kCapacity);
+    ASSERT_EQ(3U, tracker.sampleCount());
+    ASSERT_EQ(12 * kGigabyte, tracker.usedBytes());
+    ASSERT_EQ(kCapacity, tracker.capacityBytes());
+    ASSERT_FALSE(tracker.hasTrend());
+    ASSERT_EQ(0.0, tracker.growthBytesPerDay());
+    ASSERT_TRUE(tracker.daysUntilFull() < 0);
+
+    tracker.addSample(tracker.generation(), start + 30min, 13 * kGigabyte, kCapacity);
+    ASSERT_TRUE(tracker.hasTrend());
+}
+
+TEST(CapacityTracker, linearGrowth)
+{
+    CapacityTracker tracker;
+    const auto start = CapacityTracker::Clock::now();
+
+    // 1 GB every 6 hours: 4 GB/day, with 60 GB of the 100 GB left after the last sample
+    for (int i = 0; i <= 40; ++i)
+        tracker.addSample(tracker.generation(), start + i * 6h, static_cast<uint64_t>(i) * kGigabyte, kCapacity);
+
+    ASSERT_TRUE(tracker.hasTrend());
+    ASSERT_TRUE(near(4.0 * kGigabyte, tracker.growthBytesPerDay()));
+    ASSERT_TRUE(near(15.0, tracker.daysUntilFull()));
+}
+
+TEST(CapacityTracker, noisyGrowth)
+{
+    CapacityTracker tracker;
+    const auto start = CapacityTracker::Clock::now();
+
+    // uploads in bursts around the same 2 GB/day trend; the fit averages the bursts out
+    for (int i = 0; i < 24; ++i)
+    {
+        const uint64_t burst = (i % 2 == 0) ? kGigabyte / 4 : 0;
+        tracker.addSample(tracker.generation(), start + i * 1h, static_cast<uint64_t>(i) * kGigabyte / 12 + burst,
+                          kCapacity);
+    }
+
+    const double growth = tracker.growthBytesPerDay();
+    ASSERT_TRUE(growth > 1.9 * kGigabyte && growth < 2.1 * kGigabyte);
+    ASSERT_TRUE(tracker.daysUntilFull() > 0);
+}
+
+TEST(CapacityTracker, flatAndShrinkingUsage)
+{
+    CapacityTracker tracker;
+    const auto start = CapacityTracker::Clock::now();
+
+    for (int i = 0; i < 10; ++i)
+        tracker.addSample(tracker.generation(), start + i * 1h, 50 * kGigabyte, kCapacity);
+    ASSERT_TRUE(tracker.hasTrend());
+    ASSERT_EQ(0.0, tracker.growthBytesPerDay());
+    ASSERT_TRUE(tracker.daysUntilFull() < 0);
+
+    // old recordings are being deleted
+    tracker.reset();
+    for (int i = 0; i < 10; ++i)
+        tracker.addSample(tracker.generation(), start + i * 1h, static_cast<uint64_t>(50 - i) * kGigabyte, kCapacity);
+    ASSERT_TRUE(near(-24.0 * kGigabyte, tracker.growthBytesPerDay()));
+    ASSERT_TRUE(tracker.daysUntilFull() < 0);
+}
+
+TEST(CapacityTracker, full)
+{
+    CapacityTracker tracker;
+    const auto start = CapacityTracker::Clock::now();
+
+    tracker.addSample(tracker.generation(), start, kCapacity, kCapacity);
+    ASSERT_EQ(0.0, tracker.daysUntilFull());
+}
+
+TEST(CapacityTracker, window)
+{
+    CapacityTracker tracker(/*window*/ 24h, /*maxSamples*/ 5);
+    const auto start = CapacityTracker::Clock::now();
+
+    for (int i = 0; i < 8; ++i)
+        tracker.addSample(tracker.generation(), start + i * 1h, static_cast<uint64_t>(i) * kGigabyte, kCapacity);
+    ASSERT_EQ(5U, tracker.sampleCount());
+
+    // the samples older than the window are dropped, along with their growth
+    tracker.addSample(tracker.generation(), start + 48h, 7 * kGigabyte, kCapacity);
+    ASSERT_EQ(1U, tracker.sampleCount());
+    ASSERT_FALSE(tracker.hasTrend());
+
+    tracker.reset();
+    ASSERT_EQ(0U, tracker.sampleCount());
+    ASSERT_EQ(0U, tracker.capacityBytes());
+}
+
+TEST(CapacityTracker, staleGeneration)
+{
+    CapacityTracker tracker;
+    const auto start = CapacityTracker::Clock::now();
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(tracker.addSample(tracker.generation(), start + i * 1h, static_cast<uint64_t>(i) * kGigabyte,
+                                      kCapacity));
+
+    // the bucket was unmounted while it was being listed: the partial listing is not recorded
+    uint64_t generation = tracker.generation();
+    tracker.invalidate();
+    ASSERT_FALSE(tracker.addSample(generation, start + 4h, 0, kCapacity));
+    ASSERT_EQ(4U, tracker.sampleCount());
+    ASSERT_EQ(3 * kGigabyte, tracker.usedBytes());
+
+    // a listing of the old bucket finished after the switch to a new one
+    generation = tracker.generation();
+    tracker.reset();
+    ASSERT_FALSE(tracker.addSample(generation, start + 5h, 5 * kGigabyte, 2 * kCapacity));
+    ASSERT_EQ(0U, tracker.sampleCount());
+    ASSERT_EQ(0U, tracker.capacityBytes());
+
+    ASSERT_TRUE(tracker.addSample(tracker.generation(), start + 6h, kGigabyte, 2 * kCapacity));
+    ASSERT_EQ(1U, tracker.sampleCount());
+}
+
+} // namespace settings::test
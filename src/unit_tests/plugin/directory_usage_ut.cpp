@@ -0,0 +1,97 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <nx/kit/test.h>
+
+#include "settings/directory_usage.h"
+
+namespace fs = std::filesystem;
+
+namespace settings::test
+{
+
+static void writeFile(const fs::path &path, size_t size)
+{
+    std::ofstream(path, std::ios::binary) << std::string(size, 'x');
+}
+
+// the file system may not tick the mtime between two quick changes
+static void touch(const fs::path &dir)
+{
+    fs::last_write_time(dir, fs::last_write_time(dir) + std::chrono::seconds(1));
+}
+
+TEST(DirectoryUsage, incrementalScan)
+{
+    const fs::path root = fs::path(nx::kit::test::tempDir()) / "mount";
+    fs::create_directories(root / "camera1" / "2024");
+    fs::create_directories(root / "camera2");
+    writeFile(root / "camera1" / "2024" / "chunk1.mkv", 1000);
+    writeFile(root / "camera1" / "2024" / "chunk2.mkv", 200);
+    writeFile(root / "camera2" / "chunk1.mkv", 30);
+    writeFile(root / "info.txt", 4);
+
+    DirectoryUsage usage;
+    const std::atomic<bool> stop{false};
+    uint64_t usedBytes = 0;
+    ASSERT_TRUE(usage.scan(root.string(), stop, &usedBytes));
+    ASSERT_EQ(1234U, usedBytes);
+    ASSERT_EQ(4U, usage.listedDirectoryCount());
+
+    // nothing changed: no directory is listed again
+    ASSERT_TRUE(usage.scan(root.string(), stop, &usedBytes));
+    ASSERT_EQ(1234U, usedBytes);
+    ASSERT_EQ(0U, usage.listedDirectoryCount());
+
+    // a new chunk: only its directory is listed again
+    writeFile(root / "camera1" / "2024" / "chunk3.mkv", 5000);
+    touch(root / "camera1" / "2024");
+    ASSERT_TRUE(usage.scan(root.string(), stop, &usedBytes));
+    ASSERT_EQ(6234U, usedBytes);
+    ASSERT_EQ(1U, usage.listedDirectoryCount());
+
+    // a removed directory no longer counts
+    fs::remove_all(root / "camera2");
+    touch(root);
+    ASSERT_TRUE(usage.scan(root.string(), stop, &usedBytes));
+    ASSERT_EQ(6204U, usedBytes);
+    ASSERT_EQ(1U, usage.listedDirectoryCount());
+
+    // a file that grew in place is only seen after clear()
+    writeFile(root / "info.txt", 40);
+    ASSERT_TRUE(usage.scan(root.string(), stop, &usedBytes));
+    ASSERT_EQ(6204U, usedBytes);
+    usage.clear();
+    ASSERT_TRUE(usage.scan(root.string(), stop, &usedBytes));
+    ASSERT_EQ(6240U, usedBytes);
+    ASSERT_EQ(3U, usage.listedDirectoryCount());
+}
+
+TEST(DirectoryUsage, failures)
+{
+    const fs::path root = fs::path(nx::kit::test::tempDir()) / "mount";
+    fs::create_directories(root);
+    writeFile(root / "chunk.mkv", 10);
+
+    DirectoryUsage usage;
+    std::atomic<bool> stop{false};
+    uint64_t usedBytes = 42;
+    ASSERT_FALSE(usage.scan((root / "missing").string(), stop, &usedBytes));
+    ASSERT_EQ(42U, usedBytes);
+
+    stop = true;
+    ASSERT_FALSE(usage.scan(root.string(), stop, &usedBytes));
+    ASSERT_EQ(42U, usedBytes);
+
+    stop = false;
+    ASSERT_TRUE(usage.scan(root.string(), stop, &usedBytes));
+    ASSERT_EQ(10U, usedBytes);
+}
+
+} // namespace settings::test
@@ -0,0 +1,20 @@
+// Copyright © 2024 Seagate Technology LLC and/or its Affiliates
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <iostream>
+
+#include <nx/kit/test.h>
+
+int main()
+{
+    const int failedTestsCount = nx::kit::test::runAllTests("cloudfuse_plugin");
+
+    std::cerr << std::endl;
+
+    if (failedTestsCount == 0)
+        std::cerr << "SUCCESS: All test suites PASSED." << std::endl;
+    else
+        std::cerr << failedTestsCount << " test(s) FAILED. See the messages above." << std::endl;
+
+    return failedTestsCount;
+}
@@ -0,0 +1,432 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nx/kit/test.h>
+
+#include <nx/sdk/analytics/helpers/consuming_device_agent.h>
+#include <nx/sdk/analytics/helpers/data_packet_queue.h>
+#include <nx/sdk/analytics/helpers/event_metadata_packet.h>
+#include <nx/sdk/helpers/device_info.h>
+
+namespace nx::sdk::analytics::test
+{
+
+using namespace std::chrono;
+
+class CompressedVideoPacket : public RefCountable<ICompressedVideoPacket>
+{
+  public:
+    CompressedVideoPacket(int64_t timestampUs, bool isKeyFrame) : m_timestampUs(timestampUs), m_isKeyFrame(isKeyFrame)
+    {
+    }
+
+    virtual int64_t timestampUs() const override
+    {
+        return m_timestampUs;
+    }
+    virtual const char *codec() const override
+    {
+        return "test_stub_codec";
+    }
+    virtual const char *data() const override
+    {
+        return nullptr;
+    }
+    virtual int dataSize() const override
+    {
+        return 0;
+    }
+    virtual MediaFlags flags() const override
+    {
+        return m_isKeyFrame ? MediaFlags::keyFrame : MediaFlags::none;
+    }
+    virtual int width() const override
+    {
+        return 256;
+    }
+    virtual int height() const override
+    {
+        return 128;
+    }
+
+  protected:
+    virtual const IMediaContext *getContext() const override
+    {
+        return nullptr;
+    }
+    virtual IList<IMetadataPacket> *getMetadataList() const override
+    {
+        return nullptr;
+    }
+
+  private:
+    const int64_t m_timestampUs;
+    const bool m_isKeyFrame;
+};
+
+static Ptr<CompressedVideoPacket> makePacket(int64_t timestampUs, bool isKeyFrame = false)
+{
+    return makePtr<CompressedVideoPacket>(timestampUs, isKeyFrame);
+}
+
+static std::vector<int64_t> popAllTimestamps(DataPacketQueue *queue)
+{
+    std::vector<int64_t> timestamps;
+    for (DataPacketQueue::Item item; queue->pop(&item);)
+        timestamps.push_back(item.packet->timestampUs());
+    return timestamps;
+}
+
+TEST(DataPacketQueue, dropOldest)
+{
+    DataPacketQueue queue(/*capacity*/ 3, DataPacketQueue::DropPolicy::dropOldest);
+    ASSERT_EQ(4, queue.capacity());
+
+    const auto packet = makePacket(0);
+    ASSERT_TRUE(queue.push(packet.get()));
+    ASSERT_EQ(2, packet->refCount()); //< The queue holds a reference.
+    for (int64_t i = 1; i < 4; ++i)
+        ASSERT_TRUE(queue.push(makePacket(i).get()));
+    ASSERT_EQ(4, queue.size());
+
+    ASSERT_FALSE(queue.push(makePacket(4).get()));
+    ASSERT_EQ(1, queue.droppedCount());
+    ASSERT_EQ(1, packet->refCount());
+
+    ASSERT_TRUE((std::vector<int64_t>{1, 2, 3, 4}) == popAllTimestamps(&queue));
+    ASSERT_EQ(0, queue.size());
+}
+
+TEST(DataPacketQueue, dropNonKey)
+{
+    DataPacketQueue queue(/*capacity*/ 2, DataPacketQueue::DropPolicy::dropNonKey);
+    ASSERT_TRUE(queue.push(makePacket(0, /*isKeyFrame*/ true).get()));
+    ASSERT_TRUE(queue.push(makePacket(1).get()));
+
+    ASSERT_FALSE(queue.push(makePacket(2).get())); //< The new non-key packet is dropped.
+    ASSERT_FALSE(queue.push(makePacket(3, /*isKeyFrame*/ true).get())); //< The oldest is dropped.
+    ASSERT_EQ(2, queue.droppedCount());
+
+    ASSERT_TRUE((std::vector<int64_t>{1, 3}) == popAllTimestamps(&queue));
+}
+
+TEST(DataPacketQueue, concurrentProducers)
+{
+    static constexpr int kProducerCount = 4;
+    static constexpr int kPacketsPerProducer = 2000;
+
+    DataPacketQueue queue(/*capacity*/ 64, DataPacketQueue::DropPolicy::dropOldest);
+    std::atomic<bool> producersDone{false};
+    int64_t poppedCount = 0;
+    std::thread consumer(
+        [&]()
+        {
+            DataPacketQueue::Item item;
+            while (!producersDone || queue.size() > 0)
+            {
+                if (queue.pop(&item))
+                    ++poppedCount;
+            }
+        });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducerCount; ++p)
+    {
+        producers.emplace_back(
+            [&queue]()
+            {
+                for (int i = 0; i < kPacketsPerProducer; ++i)
+                    queue.push(makePacket(i).get());
+            });
+    }
+    for (auto &producer : producers)
+        producer.join();
+    producersDone = true;
+    consumer.join();
+
+    ASSERT_EQ(kProducerCount * kPacketsPerProducer, poppedCount + queue.droppedCount());
+}
+
+//-------------------------------------------------------------------------------------------------
+
+class Handler : public RefCountable<IDeviceAgent::IHandler>
+{
+  public:
+    virtual void handleMetadata(IMetadataPacket * /*metadata*/) override
+    {
+    }
+    virtual void handlePluginDiagnosticEvent(IPluginDiagnosticEvent * /*event*/) override
+    {
+    }
+    virtual void pushManifest(const IString * /*manifest*/) override
+    {
+    }
+};
+
+/** Spends the given time on each frame, like a plugin doing heavy analysis. */
+class SlowDeviceAgent : public ConsumingDeviceAgent
+{
+  public:
+    SlowDeviceAgent(const IDeviceInfo *deviceInfo, microseconds frameProcessingTime)
+        : ConsumingDeviceAgent(deviceInfo, /*enableOutput*/ false), m_frameProcessingTime(frameProcessingTime)
+    {
+        startAsyncDataProcessing(/*queueCapacity*/ 8);
+    }
+
+    using ConsumingDeviceAgent::asyncDataProcessingStatistics;
+    using ConsumingDeviceAgent::doPushDataPacket;
+    using ConsumingDeviceAgent::finalize;
+
+    std::atomic<int> processedFrameCount{0};
+
+  protected:
+    virtual std::string manifestString() const override
+    {
+        return "{}";
+    }
+
+    virtual void doSetNeededMetadataTypes(Result<void> * /*outResult*/,
+                                          const IMetadataTypes * /*neededMetadataTypes*/) override
+    {
+    }
+
+    virtual bool pushCompressedVideoFrame(const ICompressedVideoPacket * /*videoFrame*/) override
+    {
+        std::this_thread::sleep_for(m_frameProcessingTime);
+        ++processedFrameCount;
+        return true;
+    }
+
+  private:
+    const microseconds m_frameProcessingTime;
+};
+
+TEST(ConsumingDeviceAgent, asyncDataProcessing)
+{
+    static constexpr int kFrameCount = 32;
+
+    const auto deviceInfo = makePtr<DeviceInfo>();
+    deviceInfo->setId("test_device");
+    const auto deviceAgent = makePtr<SlowDeviceAgent>(deviceInfo.get(), milliseconds(2));
+    deviceAgent->setHandler(makePtr<Handler>().get());
+
+    // Pushing must not wait for the processing: 32 frames would take 64 ms if processed inline.
+    const auto start = steady_clock::now();
+    for (int i = 0; i < kFrameCount; ++i)
+    {
+        Result<void> result;
+        deviceAgent->doPushDataPacket(&result, makePacket(i).get());
+        ASSERT_TRUE(result.isOk());
+    }
+    const auto pushDuration = steady_clock::now() - start;
+    ASSERT_TRUE(pushDuration < milliseconds(2 * kFrameCount) / 2);
+
+    // Wait until the queue is drained.
+    auto statistics = deviceAgent->asyncDataProcessingStatistics();
+    for (int i = 0; i < 1000 && statistics.processedCount + statistics.droppedCount < kFrameCount; ++i)
+    {
+        std::this_thread::sleep_for(milliseconds(1));
+        statistics = deviceAgent->asyncDataProcessingStatistics();
+    }
+
+    ASSERT_EQ(kFrameCount, statistics.processedCount + statistics.droppedCount);
+    ASSERT_TRUE(statistics.droppedCount > 0); //< The queue of 8 could not hold all the frames.
+    ASSERT_TRUE(statistics.maxQueueDepth <= 8);
+    ASSERT_TRUE(statistics.maxLatencyUs >= statistics.averageLatencyUs);
+    ASSERT_EQ(statistics.processedCount, (int64_t)deviceAgent->processedFrameCount);
+
+    if (nx::kit::test::verbose)
+    {
+        std::cerr << "Pushed " << kFrameCount << " frames in "
+                  << duration_cast<microseconds>(pushDuration).count() << " us; processed "
+                  << statistics.processedCount << ", dropped " << statistics.droppedCount << ", max queue depth "
+                  << statistics.maxQueueDepth << ", latency avg " << statistics.averageLatencyUs << " us, max "
+                  << statistics.maxLatencyUs << " us" << std::endl;
+    }
+
+    deviceAgent->finalize();
+}
+
+TEST(ConsumingDeviceAgent, pushingWhileStopping)
+{
+    static constexpr int kProducerCount = 4;
+    static constexpr int kPacketsPerProducer = 2000;
+
+    const auto deviceInfo = makePtr<DeviceInfo>();
+    deviceInfo->setId("test_device");
+    const auto deviceAgent = makePtr<SlowDeviceAgent>(deviceInfo.get(), microseconds(0));
+    deviceAgent->setHandler(makePtr<Handler>().get());
+
+    std::vector<std::vector<Ptr<CompressedVideoPacket>>> packets(kProducerCount);
+    std::atomic<int> pushedCount{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducerCount; ++p)
+    {
+        producers.emplace_back(
+            [&, p]()
+            {
+                for (int i = 0; i < kPacketsPerProducer; ++i)
+                {
+                    packets[p].push_back(makePacket(i));
+                    Result<void> result;
+                    deviceAgent->doPushDataPacket(&result, packets[p].back().get());
+                    ++pushedCount;
+                }
+            });
+    }
+
+    // Stop while the producers are still pushing.
+    while (pushedCount < kProducerCount * kPacketsPerProducer / 4)
+        std::this_thread::yield();
+    deviceAgent->finalize();
+    for (auto &producer : producers)
+        producer.join();
+
+    // No packet pushed concurrently with stopping is left referenced by the queue.
+    ASSERT_EQ(0, deviceAgent->asyncDataProcessingStatistics().queueDepth);
+    for (const auto &producerPackets : packets)
+    {
+        for (const auto &packet : producerPackets)
+            ASSERT_EQ(1, packet->refCount());
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/** Takes some time to handle each packet, like a Server busy with other work. */
+class SlowHandler : public Handler
+{
+  public:
+    virtual void handleMetadata(IMetadataPacket *metadata) override
+    {
+        ASSERT_TRUE(metadata != nullptr);
+        const int concurrentCount = ++m_concurrentCount;
+        int max = maxConcurrentCount;
+        while (concurrentCount > max && !maxConcurrentCount.compare_exchange_weak(max, concurrentCount))
+        {
+        }
+        std::this_thread::sleep_for(microseconds(100));
+        --m_concurrentCount;
+        ++handledCount;
+    }
+
+    std::atomic<int> handledCount{0};
+    std::atomic<int> maxConcurrentCount{0};
+
+  private:
+    std::atomic<int> m_concurrentCount{0};
+};
+
+class MetadataProducingDeviceAgent : public SlowDeviceAgent
+{
+  public:
+    using SlowDeviceAgent::SlowDeviceAgent;
+    using SlowDeviceAgent::pushMetadataPacket;
+    using SlowDeviceAgent::pushMetadataPackets;
+};
+
+static IMetadataPacket *newMetadataPacket()
+{
+    const auto packet = new EventMetadataPacket();
+    packet->setTimestampUs(0);
+    return packet;
+}
+
+TEST(ConsumingDeviceAgent, metadataDeliveredOutsideTheLock)
+{
+    static constexpr int kProducerCount = 4;
+    static constexpr int kPacketsPerProducer = 20;
+    static constexpr int kBatchSize = 5;
+
+    const auto deviceInfo = makePtr<DeviceInfo>();
+    deviceInfo->setId("test_device");
+    const auto deviceAgent = makePtr<MetadataProducingDeviceAgent>(deviceInfo.get(), microseconds(0));
+    const auto handler = makePtr<SlowHandler>();
+    deviceAgent->setHandler(handler.get());
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducerCount; ++p)
+    {
+        producers.emplace_back(
+            [&, p]()
+            {
+                for (int i = 0; i < kPacketsPerProducer; i += kBatchSize)
+                {
+                    if (p % 2 == 0)
+                    {
+                        for (int j = 0; j < kBatchSize; ++j)
+                            deviceAgent->pushMetadataPacket(newMetadataPacket());
+                        continue;
+                    }
+                    std::vector<IMetadataPacket *> batch;
+                    for (int j = 0; j < kBatchSize; ++j)
+                        batch.push_back(newMetadataPacket());
+                    deviceAgent->pushMetadataPackets(batch);
+                }
+            });
+    }
+    for (auto &producer : producers)
+        producer.join();
+
+    ASSERT_EQ(kProducerCount * kPacketsPerProducer, (int)handler->handledCount);
+    // The handler is not called under the DeviceAgent lock, so the producers do not wait for each
+    // other.
+    ASSERT_TRUE(handler->maxConcurrentCount > 1);
+    deviceAgent->finalize();
+}
+
+/**
+ * Producer threads pushing metadata one by one, serialized by an outer mutex like the previous
+ * implementation which called the handler under the internal lock, or concurrently, or as batches.
+ */
+BENCHMARK(ConsumingDeviceAgent, metadataProducers)
+{
+    static constexpr int kBatchSize = 10;
+
+    const auto deviceInfo = makePtr<DeviceInfo>();
+    deviceInfo->setId("test_device");
+    const auto deviceAgent = makePtr<MetadataProducingDeviceAgent>(deviceInfo.get(), microseconds(0));
+    const auto handler = makePtr<SlowHandler>();
+    deviceAgent->setHandler(handler.get());
+
+    std::mutex serializingMutex;
+    std::atomic<int> pushedCount{0};
+    for (const int producerCount : {1, 4})
+    {
+        const std::string prefix = std::to_string(producerCount) + "/";
+        benchmark.runConcurrently(prefix + "serialized", producerCount,
+                                  [&](int /*threadIndex*/)
+                                  {
+                                      const std::lock_guard<std::mutex> lock(serializingMutex);
+                                      deviceAgent->pushMetadataPacket(newMetadataPacket());
+                                      ++pushedCount;
+                                  });
+        benchmark.runConcurrently(prefix + "concurrent", producerCount,
+                                  [&](int /*threadIndex*/)
+                                  {
+                                      deviceAgent->pushMetadataPacket(newMetadataPacket());
+                                      ++pushedCount;
+                                  });
+        benchmark.runConcurrently(prefix + "batchOf" + std::to_string(kBatchSize), producerCount,
+                                  [&](int /*threadIndex*/)
+                                  {
+                                      std::vector<IMetadataPacket *> batch;
+                                      for (int j = 0; j < kBatchSize; ++j)
+                                          batch.push_back(newMetadataPacket());
+                                      deviceAgent->pushMetadataPackets(batch);
+                                      pushedCount += kBatchSize;
+                                  });
+    }
+
+    ASSERT_EQ((int)pushedCount, (int)handler->handledCount);
+    deviceAgent->finalize();
+}
+
+} // namespace nx::sdk::analytics::test
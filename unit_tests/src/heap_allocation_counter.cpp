@@ -0,0 +1,26 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "heap_allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+std::atomic<int64_t> g_heapAllocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    g_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *const p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t /*size*/) noexcept
+{
+    std::free(p);
+}
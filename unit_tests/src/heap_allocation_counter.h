@@ -0,0 +1,12 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Number of heap allocations made by this executable so far: heap_allocation_counter.cpp replaces
+ * the global operator new to count them.
+ */
+extern std::atomic<int64_t> g_heapAllocationCount;
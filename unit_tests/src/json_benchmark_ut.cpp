@@ -0,0 +1,112 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <nx/kit/arena_json.h>
+#include <nx/kit/json.h>
+#include <nx/kit/json_writer.h>
+#include <nx/kit/test.h>
+
+#include <nx/sdk/helpers/string_map.h>
+#include <nx/sdk/ptr.h>
+
+#include "../../src/plugin/settings/settings_model.h"
+#include "heap_allocation_counter.h"
+
+namespace nx::sdk::test
+{
+
+using nx::kit::ArenaJson;
+using nx::kit::Json;
+using nx::kit::JsonWriter;
+
+static std::string readFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/** @return Heap allocations per call. */
+template <class Action> static double allocationsPerCall(Action action)
+{
+    static constexpr int kCallCount = 10;
+    const int64_t allocationsBefore = g_heapAllocationCount.load();
+    for (int i = 0; i < kCallCount; ++i)
+        action();
+    return (double)(g_heapAllocationCount.load() - allocationsBefore) / kCallCount;
+}
+
+/** Parsing the repo's JSON documents with both parsers. */
+BENCHMARK(ArenaJson, parse)
+{
+    const std::string taxonomy = readFile(NX_SDK_UT_TAXONOMY_JSON_PATH);
+    ASSERT_FALSE(taxonomy.empty());
+
+    for (const auto &[name, text] :
+         {std::make_pair("settingsModel", settings::kEngineSettingsModel.str()), std::make_pair("taxonomy", taxonomy)})
+    {
+        std::string err;
+        const Json json = Json::parse(text, err);
+        ASSERT_STREQ("", err);
+        ASSERT_STREQ(json.dump(), ArenaJson::parse(text, err).root().toJson().dump());
+        ASSERT_STREQ("", err);
+
+        const auto parseJson = [&]() { nx::kit::test::doNotOptimize(Json::parse(text, err)); };
+        const auto parseArenaJson = [&]() { nx::kit::test::doNotOptimize(ArenaJson::parse(text, err)); };
+        benchmark.run(std::string(name) + "/Json", parseJson);
+        benchmark.run(std::string(name) + "/ArenaJson", parseArenaJson);
+
+        // The arena takes a few blocks instead of a node, a string and a container per value.
+        const double jsonAllocations = allocationsPerCall(parseJson);
+        const double arenaJsonAllocations = allocationsPerCall(parseArenaJson);
+        ASSERT_TRUE(arenaJsonAllocations * 4 < jsonAllocations);
+    }
+}
+
+/** Serializing the repo's JSON documents. */
+BENCHMARK(JsonWriter, dump)
+{
+    const std::string taxonomy = readFile(NX_SDK_UT_TAXONOMY_JSON_PATH);
+    ASSERT_FALSE(taxonomy.empty());
+
+    for (const auto &[name, text] :
+         {std::make_pair("settingsModel", settings::kEngineSettingsModel.str()), std::make_pair("taxonomy", taxonomy)})
+    {
+        std::string err;
+        const Json json = Json::parse(text, err);
+        ASSERT_STREQ("", err);
+
+        JsonWriter writer;
+        writer.value(json);
+        ASSERT_STREQ(json.dump(), writer.buffer());
+
+        const auto dump = [&]() { nx::kit::test::doNotOptimize(json.dump()); };
+        const auto writeReused = [&]()
+        {
+            writer.clear();
+            writer.value(json);
+        };
+        benchmark.run(std::string(name) + "/Json::dump", dump);
+        benchmark.run(std::string(name) + "/JsonWriter", writeReused);
+
+        // A reused writer keeps its buffer.
+        ASSERT_EQ(0.0, allocationsPerCall(writeReused));
+        ASSERT_TRUE(allocationsPerCall(dump) > 0);
+    }
+}
+
+TEST(JsonWriter, stringMap)
+{
+    const auto stringMap = makePtr<StringMap>(StringMap::Map{{"bucketName", "b"}, {"keyId", "k\\"}});
+
+    JsonWriter writer;
+    writer.stringMapObject(*stringMap);
+    ASSERT_STREQ(R"({"bucketName": "b", "keyId": "k\\"})", writer.buffer());
+}
+
+} // namespace nx::sdk::test
@@ -0,0 +1,62 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <map>
+#include <string>
+
+#include <nx/kit/test.h>
+#include <nx/kit/utils.h>
+
+#include <nx/sdk/helpers/log_utils.h>
+#include <nx/sdk/helpers/string_map.h>
+#include <nx/sdk/ptr.h>
+
+#undef NX_DEBUG_ENABLE_OUTPUT
+#define NX_DEBUG_ENABLE_OUTPUT (logUtils.enableOutput)
+#include <nx/kit/debug.h>
+
+namespace nx::sdk::test
+{
+
+/** Stands for the formatting done by the log statements, e.g. nx::kit::utils::toString(). */
+static std::string describe(int i)
+{
+    return "item #" + nx::kit::utils::toString(i);
+}
+
+/** The cost of the log statements which produce no output. */
+BENCHMARK(Log, disabledOutput)
+{
+    const LogUtils logUtils(/*enableOutput*/ false, "[log_benchmark_ut] ");
+    const int oldLogLevel = nx::kit::debug::logLevel();
+    int i = 0;
+
+    benchmark.run("NX_OUTPUT", [&]() { NX_OUTPUT << describe(++i); });
+
+    nx::kit::debug::setLogLevel(NX_LOG_LEVEL_ERROR);
+    benchmark.run("belowRuntimeLevel", [&]() { NX_LOG_INFO << describe(++i); });
+
+#undef NX_DEBUG_MIN_LOG_LEVEL
+#define NX_DEBUG_MIN_LOG_LEVEL NX_LOG_LEVEL_WARN
+    benchmark.run("compiledOut", [&]() { NX_LOG_INFO << describe(++i); });
+#undef NX_DEBUG_MIN_LOG_LEVEL
+#define NX_DEBUG_MIN_LOG_LEVEL NX_LOG_LEVEL_TRACE
+
+    nx::kit::debug::setLogLevel(oldLogLevel);
+
+    // None of the statements above has evaluated its arguments.
+    ASSERT_EQ(0, i);
+
+    const auto stringMap = makePtr<StringMap>();
+    for (int j = 0; j < 20; ++j)
+        stringMap->setItem(describe(j), describe(j));
+    std::map<std::string, std::string> map;
+    benchmark.run("convertAndOutputStringMap",
+                  [&]()
+                  {
+                      map.clear();
+                      logUtils.convertAndOutputStringMap(&map, stringMap.get(), "Settings");
+                  });
+    ASSERT_EQ(20, (int)map.size());
+}
+
+} // namespace nx::sdk::test
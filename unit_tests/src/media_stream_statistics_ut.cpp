@@ -0,0 +1,145 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <nx/kit/test.h>
+
+#include <nx/sdk/helpers/media_stream_statistics.h>
+#include <nx/sdk/helpers/ring_buffer_media_stream_statistics.h>
+
+namespace nx::sdk::test
+{
+
+using namespace std::chrono;
+
+struct Frame
+{
+    microseconds timestamp;
+    size_t size;
+    bool isKeyFrame;
+};
+
+/** 30 fps stream with a key frame every 30 frames, starting at the given timestamp. */
+static std::vector<Frame> makeStream(int frameCount, microseconds start = microseconds(0))
+{
+    std::vector<Frame> frames;
+    for (int i = 0; i < frameCount; ++i)
+    {
+        const bool isKeyFrame = i % 30 == 0;
+        const size_t size = isKeyFrame ? 50'000u : 5'000u + (size_t)(i % 7) * 100;
+        frames.push_back({start + microseconds((int64_t)i * 33'333), size, isKeyFrame});
+    }
+    return frames;
+}
+
+static void assertSameStatistics(int line, const MediaStreamStatistics &expected,
+                                 const RingBufferMediaStreamStatistics &actual)
+{
+    ASSERT_EQ_AT_LINE(line, expected.bitrateBitsPerSecond(), actual.bitrateBitsPerSecond());
+    ASSERT_EQ_AT_LINE(line, expected.getFrameRate(), actual.getFrameRate());
+    ASSERT_EQ_AT_LINE(line, expected.getAverageGopSize(), actual.getAverageGopSize());
+    ASSERT_EQ_AT_LINE(line, expected.hasMediaData(), actual.hasMediaData());
+}
+
+static void feed(const std::vector<Frame> &frames, MediaStreamStatistics *expected,
+                 RingBufferMediaStreamStatistics *actual)
+{
+    for (const auto &frame : frames)
+    {
+        expected->onData(frame.timestamp, frame.size, frame.isKeyFrame);
+        actual->onData(frame.timestamp, frame.size, frame.isKeyFrame);
+    }
+}
+
+TEST(RingBufferMediaStreamStatistics, inOrderStream)
+{
+    MediaStreamStatistics expected;
+    RingBufferMediaStreamStatistics actual;
+    assertSameStatistics(__LINE__, expected, actual);
+    ASSERT_FALSE(actual.hasMediaData());
+
+    feed(makeStream(300), &expected, &actual);
+    assertSameStatistics(__LINE__, expected, actual);
+    ASSERT_TRUE(actual.bitrateBitsPerSecond() > 0);
+    ASSERT_TRUE(actual.getFrameRate() > 29 && actual.getFrameRate() < 31);
+    ASSERT_TRUE(actual.getAverageGopSize() > 29 && actual.getAverageGopSize() < 31);
+
+    expected.reset();
+    actual.reset();
+    assertSameStatistics(__LINE__, expected, actual);
+}
+
+TEST(RingBufferMediaStreamStatistics, outOfOrderTimestamps)
+{
+    MediaStreamStatistics expected;
+    RingBufferMediaStreamStatistics actual;
+
+    // Swap neighbouring frames, like B-frames in decoding order.
+    auto frames = makeStream(200);
+    for (size_t i = 1; i + 1 < frames.size(); i += 5)
+        std::swap(frames[i], frames[i + 1]);
+    feed(frames, &expected, &actual);
+    assertSameStatistics(__LINE__, expected, actual);
+
+    // Media stream time jumps back: the "future" data must be dropped.
+    feed(makeStream(20, microseconds(1'000'000)), &expected, &actual);
+    assertSameStatistics(__LINE__, expected, actual);
+}
+
+TEST(RingBufferMediaStreamStatistics, frameLimits)
+{
+    MediaStreamStatistics expected(seconds(10), /*maxDurationInFrames*/ 50);
+    RingBufferMediaStreamStatistics actual(seconds(10), /*maxDurationInFrames*/ 50);
+    feed(makeStream(300), &expected, &actual);
+    assertSameStatistics(__LINE__, expected, actual);
+
+    // When the capacity is smaller than the window, it acts as maxDurationInFrames.
+    MediaStreamStatistics limited(seconds(10), /*maxDurationInFrames*/ 64);
+    RingBufferMediaStreamStatistics small(seconds(10), /*maxDurationInFrames*/ 0, /*capacity*/ 60);
+    ASSERT_EQ(64, small.capacity());
+    feed(makeStream(300), &limited, &small);
+    assertSameStatistics(__LINE__, limited, small);
+}
+
+TEST(RingBufferMediaStreamStatistics, highFrameRate)
+{
+    // 1000 fps over a 10 s window: the ring grows instead of shortening the window.
+    MediaStreamStatistics expected(seconds(10));
+    RingBufferMediaStreamStatistics actual(seconds(10));
+    for (int i = 0; i < 15'000; ++i)
+    {
+        const bool isKeyFrame = i % 100 == 0;
+        const size_t size = isKeyFrame ? 20'000u : 1'000u + (size_t)(i % 7) * 10;
+        expected.onData(microseconds((int64_t)i * 1'000), size, isKeyFrame);
+        actual.onData(microseconds((int64_t)i * 1'000), size, isKeyFrame);
+    }
+    assertSameStatistics(__LINE__, expected, actual);
+    ASSERT_TRUE(actual.getFrameRate() > 999 && actual.getFrameRate() < 1001);
+    ASSERT_TRUE(actual.getAverageGopSize() > 99 && actual.getAverageGopSize() < 101);
+    ASSERT_EQ(RingBufferMediaStreamStatistics::kDefaultCapacity, actual.capacity());
+}
+
+/** onData() + getAverageGopSize() per frame, for a continuous stream. */
+template <class Statistics> static void benchmarkFrames(nx::kit::test::Benchmark &benchmark, const char *variant)
+{
+    const auto gop = makeStream(30);
+    Statistics statistics(seconds(2));
+    int64_t frameIndex = 0;
+    benchmark.run(variant,
+                  [&]()
+                  {
+                      const Frame &frame = gop[frameIndex % 30];
+                      statistics.onData(microseconds(frameIndex++ * 33'333), frame.size, frame.isKeyFrame);
+                      nx::kit::test::doNotOptimize(statistics.getAverageGopSize());
+                  });
+}
+
+BENCHMARK(RingBufferMediaStreamStatistics, onData)
+{
+    benchmarkFrames<MediaStreamStatistics>(benchmark, "MediaStreamStatistics");
+    benchmarkFrames<RingBufferMediaStreamStatistics>(benchmark, "RingBufferMediaStreamStatistics");
+}
+
+} // namespace nx::sdk::test
@@ -0,0 +1,186 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <nx/kit/test.h>
+
+#include <nx/sdk/helpers/object_pool.h>
+#include <nx/sdk/helpers/plugin_diagnostic_event.h>
+#include <nx/sdk/helpers/settings_response.h>
+#include <nx/sdk/helpers/string.h>
+#include <nx/sdk/helpers/string_map.h>
+#include <nx/sdk/ptr.h>
+
+#include "heap_allocation_counter.h"
+
+namespace nx::sdk::test
+{
+
+static void setPoolsEnabled(bool enabled)
+{
+    ObjectPool<SettingsResponse>::instance().setEnabled(enabled);
+    ObjectPool<StringMap>::instance().setEnabled(enabled);
+    ObjectPool<String>::instance().setEnabled(enabled);
+    ObjectPool<PluginDiagnosticEvent>::instance().setEnabled(enabled);
+    ObjectPool<String>::instance().resetCounters();
+}
+
+/** A derived class has a different size, so it must bypass the pool of its base class. */
+class DerivedString : public String
+{
+  public:
+    using String::String;
+    std::string extra;
+};
+
+TEST(ObjectPool, recycling)
+{
+    auto &pool = ObjectPool<String>::instance();
+    ASSERT_FALSE(pool.isEnabled());
+    pool.resetCounters();
+
+    makePtr<String>("disabled");
+    ASSERT_EQ(0, pool.freeCount());
+    ASSERT_EQ(0, pool.missCount());
+
+    pool.setEnabled(true, /*maxFreeObjects*/ 2);
+
+    const IString *first = makePtr<String>("first").get(); //< Deleted on the final releaseRef().
+    ASSERT_EQ(1, pool.missCount());
+    ASSERT_EQ(1, pool.freeCount());
+
+    const auto second = makePtr<String>("second");
+    ASSERT_EQ(1, pool.hitCount());
+    ASSERT_EQ(first, second.get());
+    ASSERT_STREQ("second", second->str());
+    ASSERT_EQ(0, pool.freeCount());
+
+    {
+        const auto a = makePtr<String>();
+        const auto b = makePtr<String>();
+        const auto c = makePtr<String>();
+    }
+    ASSERT_EQ(2, pool.freeCount()); //< Limited by maxFreeObjects.
+
+    const auto derived = makePtr<DerivedString>("derived");
+    ASSERT_EQ(2, pool.freeCount());
+    ASSERT_STREQ("derived", derived->str());
+
+    pool.setEnabled(false);
+    ASSERT_EQ(0, pool.freeCount());
+}
+
+TEST(ObjectPool, disablingFromAnotherThread)
+{
+    auto &pool = ObjectPool<String>::instance();
+    pool.setEnabled(true);
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    int step = 0;
+    const auto waitForStep = [&](int expectedStep)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return step == expectedStep; });
+    };
+    const auto setStep = [&](int newStep)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        step = newStep;
+        condition.notify_all();
+    };
+
+    int freeCountWhileEnabled = -1;
+    int freeCountAfterDisabling = -1;
+    std::thread worker(
+        [&]()
+        {
+            makePtr<String>("recycled");
+            freeCountWhileEnabled = pool.freeCount();
+            setStep(1);
+            waitForStep(2);
+            makePtr<String>("not recycled");
+            freeCountAfterDisabling = pool.freeCount();
+        });
+
+    waitForStep(1);
+    pool.setEnabled(false);
+    setStep(2);
+    worker.join();
+
+    ASSERT_EQ(1, freeCountWhileEnabled);
+    ASSERT_EQ(0, freeCountAfterDisabling); //< The worker freed its list, and did not refill it.
+}
+
+/** Deletes the object when the thread exits, after the pool's free list has been destroyed. */
+struct ThreadExitRelease
+{
+    Ptr<String> string;
+};
+
+TEST(ObjectPool, deletionOnThreadExit)
+{
+    auto &pool = ObjectPool<String>::instance();
+    pool.setEnabled(true);
+
+    std::thread worker(
+        []()
+        {
+            // Constructed before the free list, so destroyed after it.
+            thread_local ThreadExitRelease release;
+            release.string = makePtr<String>("deleted on exit");
+        });
+    worker.join();
+
+    pool.setEnabled(false);
+}
+
+/**
+ * Mimics what a plugin Engine does on each settings update: builds the response with values,
+ * errors and the model, and reports a diagnostic event.
+ */
+static void simulateSettingsRoundTrip(int i)
+{
+    const auto values = makePtr<StringMap>();
+    values->setItem("keyId", "k");
+    values->setItem("bucketName", "b");
+    const auto response = makePtr<SettingsResponse>(values);
+    response->setError("endpointUrl", "e");
+    response->setModel("{}");
+    const auto event = makePtr<PluginDiagnosticEvent>(IPluginDiagnosticEvent::Level::info,
+                                                      "Settings", "Updated " + std::to_string(i % 10));
+    const auto caption = makePtr<String>(event->caption());
+    ASSERT_TRUE(!caption->empty());
+}
+
+/** A settings storm: prints the heap allocations per round-trip along with the results. */
+BENCHMARK(ObjectPool, settingsRoundTrip)
+{
+    for (const bool enabled : {false, true})
+    {
+        setPoolsEnabled(enabled);
+        simulateSettingsRoundTrip(0); //< Warm up the pools.
+
+        const int64_t allocationCount = g_heapAllocationCount.load();
+        int i = 0;
+        benchmark.run(enabled ? "poolsEnabled" : "poolsDisabled", [&]() { simulateSettingsRoundTrip(i++); });
+        const double allocationsPerRoundTrip = (double)(g_heapAllocationCount.load() - allocationCount) / i;
+
+        if (nx::kit::test::verbose)
+        {
+            std::cerr << "Pools " << (enabled ? "enabled" : "disabled") << ": " << allocationsPerRoundTrip
+                      << " heap allocations per settings round-trip; String pool hits "
+                      << ObjectPool<String>::instance().hitCount() << ", misses "
+                      << ObjectPool<String>::instance().missCount() << std::endl;
+        }
+    }
+    setPoolsEnabled(false);
+}
+
+} // namespace nx::sdk::test
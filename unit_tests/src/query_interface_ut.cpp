@@ -0,0 +1,209 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <cstring>
+#include <vector>
+
+#include <nx/kit/test.h>
+
+#include <nx/sdk/helpers/ref_countable.h>
+#include <nx/sdk/interface.h>
+
+namespace nx::sdk::query_interface_ut
+{
+
+#define ID_PREFIX "nx::sdk::query_interface_ut::"
+
+class ILevel0 : public Interface<ILevel0>
+{
+  public:
+    static auto interfaceId()
+    {
+        return makeId(ID_PREFIX "ILevel0");
+    }
+};
+
+class ILevel1 : public Interface<ILevel1, ILevel0>
+{
+  public:
+    static auto interfaceId()
+    {
+        return makeIdWithAlternative(ID_PREFIX "ILevel1", ID_PREFIX "ILevel1_deprecated");
+    }
+};
+
+class ILevel2 : public Interface<ILevel2, ILevel1>
+{
+  public:
+    static auto interfaceId()
+    {
+        return makeId(ID_PREFIX "ILevel2");
+    }
+};
+
+class IUnrelated : public Interface<IUnrelated>
+{
+  public:
+    static auto interfaceId()
+    {
+        return makeId(ID_PREFIX "IUnrelated");
+    }
+};
+
+class Object : public RefCountable<ILevel2>
+{
+  public:
+    using ILevel2::queryInterface; //< Make the virtual queryInterface() available to the tests.
+};
+
+/** Interface id in a buffer of its own, like an id coming from another binary. */
+static const IRefCountable::InterfaceId *copiedId(std::vector<char> *buffer, const char *id)
+{
+    buffer->assign(id, id + strlen(id) + 1);
+    return reinterpret_cast<const IRefCountable::InterfaceId *>(buffer->data());
+}
+
+TEST(QueryInterface, hashOf)
+{
+    static_assert(IRefCountable::InterfaceId::hashOf("") == 2166136261U);
+    ASSERT_EQ(IRefCountable::InterfaceId::hashOf(ID_PREFIX "ILevel0"),
+              IRefCountable::InterfaceId::hashOf(ILevel0::interfaceId()->value));
+    ASSERT_TRUE(IRefCountable::InterfaceId::hashOf(ID_PREFIX "ILevel0") !=
+                IRefCountable::InterfaceId::hashOf(ID_PREFIX "ILevel1"));
+}
+
+TEST(QueryInterface, baseChain)
+{
+    const auto object = makePtr<Object>();
+
+    ASSERT_TRUE(object->queryInterface<ILevel2>());
+    ASSERT_TRUE(object->queryInterface<ILevel1>());
+    ASSERT_TRUE(object->queryInterface<ILevel0>());
+    ASSERT_TRUE(object->queryInterface<IRefCountable>());
+    ASSERT_FALSE(object->queryInterface<IUnrelated>());
+    ASSERT_EQ(1, object->refCount());
+
+    // Ids which are equal as strings but have different addresses must be found as well.
+    std::vector<char> buffer;
+    for (const char *id : {ID_PREFIX "ILevel2", ID_PREFIX "ILevel1", ID_PREFIX "ILevel1_deprecated",
+                           ID_PREFIX "ILevel0", "nx::sdk::IRefCountable"})
+    {
+        IRefCountable *const found = object->queryInterface(copiedId(&buffer, id));
+        ASSERT_TRUE(found != nullptr);
+        ASSERT_EQ(2, object->refCount());
+        found->releaseRef();
+    }
+
+    // Ids which differ from the own ones only after the hashed prefix, or by a suffix.
+    for (const char *id : {ID_PREFIX "ILevel3", ID_PREFIX "ILevel0_", ID_PREFIX "ILevel", ""})
+        ASSERT_EQ(nullptr, object->queryInterface(copiedId(&buffer, id)));
+    ASSERT_EQ(1, object->refCount());
+}
+
+//-------------------------------------------------------------------------------------------------
+// Benchmark against the previous implementation of Interface.
+
+static std::vector<const IRefCountable::InterfaceId *> legacyIds(const IRefCountable::InterfaceId *id)
+{
+    return std::vector<const IRefCountable::InterfaceId *>(1, id);
+}
+
+static std::vector<const IRefCountable::InterfaceId *> legacyIds(IRefCountable::InterfaceIdList ids)
+{
+    return std::vector<const IRefCountable::InterfaceId *>(ids.begin(), ids.end());
+}
+
+/** The previous Interface: allocates the id vector and calls strcmp() at each level. */
+template <class DerivedInterface, class BaseInterface = IRefCountable>
+class LegacyInterface : public BaseInterface
+{
+  protected:
+    virtual IRefCountable *queryInterface(const IRefCountable::InterfaceId *id) override
+    {
+        for (const auto &ownId : legacyIds(DerivedInterface::interfaceId()))
+        {
+            if (*ownId == *id)
+            {
+                this->addRef();
+                return static_cast<DerivedInterface *>(this);
+            }
+        }
+        return BaseInterface::queryInterface(id);
+    }
+};
+
+class ILegacyLevel0 : public LegacyInterface<ILegacyLevel0>
+{
+  public:
+    static auto interfaceId()
+    {
+        return makeId(ID_PREFIX "ILevel0");
+    }
+};
+
+class ILegacyLevel1 : public LegacyInterface<ILegacyLevel1, ILegacyLevel0>
+{
+  public:
+    static auto interfaceId()
+    {
+        return makeIdWithAlternative(ID_PREFIX "ILevel1", ID_PREFIX "ILevel1_deprecated");
+    }
+};
+
+class ILegacyLevel2 : public LegacyInterface<ILegacyLevel2, ILegacyLevel1>
+{
+  public:
+    static auto interfaceId()
+    {
+        return makeId(ID_PREFIX "ILevel2");
+    }
+};
+
+class LegacyObject : public RefCountable<ILegacyLevel2>
+{
+  public:
+    using ILegacyLevel2::queryInterface;
+};
+
+/** The previous IRefCountable::queryInterface<Interface>(). */
+template <class Interface> static Ptr<Interface> legacyQueryInterface(LegacyObject *object)
+{
+    for (const auto &id : legacyIds(Interface::interfaceId()))
+    {
+        if (IRefCountable *refCountable = object->queryInterface(id))
+            return Ptr(static_cast<Interface *>(refCountable));
+    }
+    return nullptr;
+}
+
+/** Queries the interface on the top of the chain, at the bottom of the chain, and a missing one. */
+BENCHMARK(QueryInterface, queryInterface)
+{
+    const auto object = makePtr<Object>();
+    const auto legacyObject = makePtr<LegacyObject>();
+
+    int i = 0;
+    int foundCount = 0;
+    benchmark.run("hashedIds",
+                  [&]()
+                  {
+                      switch (i++ % 3)
+                      {
+                          case 0: foundCount += (bool)object->queryInterface<ILevel2>(); break;
+                          case 1: foundCount += (bool)object->queryInterface<ILevel0>(); break;
+                          default: foundCount += (bool)object->queryInterface<IUnrelated>(); break;
+                      }
+                  });
+    benchmark.run("vectorAndStrcmp",
+                  [&]()
+                  {
+                      switch (i++ % 3)
+                      {
+                          case 0: foundCount += (bool)legacyQueryInterface<ILegacyLevel2>(legacyObject.get()); break;
+                          case 1: foundCount += (bool)legacyQueryInterface<ILegacyLevel0>(legacyObject.get()); break;
+                          default: foundCount += (bool)legacyQueryInterface<IUnrelated>(legacyObject.get()); break;
+                      }
+                  });
+    ASSERT_TRUE(foundCount > 0);
+}
+
+} // namespace nx::sdk::query_interface_ut
@@ -1,7 +1,11 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <nx/kit/test.h>
 
@@ -104,9 +108,9 @@ template <class Interface, typename ObjectPtr> std::string objectAndInterfaceIdR
         interfaceIdRef = nx::kit::utils::toString(Interface::interfaceId()->value);
     }
     else if constexpr (std::is_same_v<decltype(Interface::interfaceId()),
-                                      std::vector<const IRefCountable::InterfaceId *>>)
+                                      IRefCountable::InterfaceIdList>)
     {
-        // New interface with alternative id; interfaceId() is a vector of struct pointers.
+        // New interface with alternative id; interfaceId() is a list of struct pointers.
         for (const auto &id : Interface::interfaceId())
         {
             interfaceIdRef += (interfaceIdRef.empty() ? "" : "|") + nx::kit::utils::toString(id->value);
@@ -582,4 +586,144 @@ TEST(RefCountable, binaryCompatibilityWithOldSdk)
     ASSERT_TRUE(NewObject::s_destructorCalled);
 }
 
+//-------------------------------------------------------------------------------------------------
+// Reference counting policies.
+
+class PacketData : public RefCountable<IData, CacheLineAlignedRefCountPolicy>
+{
+};
+
+TEST(RefCountable, cacheLineAlignedPolicy)
+{
+    static constexpr size_t kLine = CacheLineAlignedRefCountPolicy::kCounterAlignment;
+    static_assert(alignof(PacketData) >= kLine);
+    // The counter line is padded, so the holder's pointers, and the members of the derived class
+    // after them, are on other lines.
+    static_assert(sizeof(BasicRefCountableHolder<CacheLineAlignedRefCountPolicy>) >= 2 * kLine);
+    // The default policy adds no padding.
+    static_assert(sizeof(RefCountableHolder) == sizeof(std::atomic<int>) + 2 * sizeof(void *) ||
+                  sizeof(RefCountableHolder) == 3 * sizeof(void *));
+
+    auto data = new PacketData;
+    ASSERT_EQ(0, (int)(reinterpret_cast<uintptr_t>(data) % kLine));
+    ASSERT_EQ(1, data->refCount());
+    ASSERT_EQ(2, data->addRef());
+    ASSERT_TRUE(data->queryInterface<ISuper>());
+    ASSERT_EQ(1, data->releaseRef());
+    ASSERT_EQ(0, data->releaseRef());
+}
+
+/** The previous ordering: sequentially consistent increments and decrements. */
+struct SeqCstRefCountPolicy : RefCountPolicy
+{
+    static constexpr std::memory_order kAddRefOrder = std::memory_order_seq_cst;
+    static constexpr std::memory_order kReleaseRefOrder = std::memory_order_seq_cst;
+};
+
+template <class Policy> class BenchmarkData : public RefCountable<IData, Policy>
+{
+};
+
+/**
+ * Objects for the threads doing addRef()/releaseRef() pairs: either one shared object, or an own
+ * object per thread; own objects are allocated together, as it happens to packets allocated one
+ * after another.
+ */
+template <class Policy>
+static std::vector<Ptr<BenchmarkData<Policy>>> makeObjects(int threadCount, bool shared)
+{
+    std::vector<Ptr<BenchmarkData<Policy>>> objects;
+    for (int i = 0; i < (shared ? 1 : threadCount); ++i)
+        objects.push_back(makePtr<BenchmarkData<Policy>>());
+    return objects;
+}
+
+template <class Policy> static void assertBalancedUnderContention(int line)
+{
+    static constexpr int kThreadCount = 4;
+    static constexpr int kPairCount = 100'000;
+
+    const auto objects = makeObjects<Policy>(kThreadCount, /*shared*/ true);
+    const IRefCountable *const object = objects[0].get();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [object]()
+            {
+                for (int i = 0; i < kPairCount; ++i)
+                {
+                    object->addRef();
+                    object->releaseRef();
+                }
+            });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ_AT_LINE(line, 1, objects[0]->refCount());
+}
+
+TEST(RefCountable, concurrentAddRefReleaseRef)
+{
+    assertBalancedUnderContention<SeqCstRefCountPolicy>(__LINE__);
+    assertBalancedUnderContention<RefCountPolicy>(__LINE__);
+    assertBalancedUnderContention<CacheLineAlignedRefCountPolicy>(__LINE__);
+}
+
+/** An uncontended addRef()/releaseRef() pair for each policy. */
+BENCHMARK(RefCountable, addRefReleaseRef)
+{
+    const auto seqCstObject = makePtr<BenchmarkData<SeqCstRefCountPolicy>>();
+    const auto defaultObject = makePtr<BenchmarkData<RefCountPolicy>>();
+    const auto alignedObject = makePtr<BenchmarkData<CacheLineAlignedRefCountPolicy>>();
+
+    for (const auto &[variant, object] :
+         {std::pair<const char *, const IRefCountable *>{"seq_cst", seqCstObject.get()},
+          {"relaxed/acq_rel", defaultObject.get()},
+          {"cacheLineAligned", alignedObject.get()}})
+    {
+        benchmark.run(variant,
+                      [object = object]()
+                      {
+                          object->addRef();
+                          object->releaseRef();
+                      });
+    }
+    ASSERT_EQ(1, seqCstObject->refCount());
+    ASSERT_EQ(1, defaultObject->refCount());
+    ASSERT_EQ(1, alignedObject->refCount());
+}
+
+template <class Policy>
+static void benchmarkContention(
+    nx::kit::test::Benchmark &benchmark, const std::string &policyName, int threadCount, bool shared)
+{
+    const auto objects = makeObjects<Policy>(threadCount, shared);
+    benchmark.runConcurrently(policyName + "/" + std::to_string(threadCount) + (shared ? "/shared" : "/own"),
+                              threadCount,
+                              [&objects, shared](int threadIndex)
+                              {
+                                  const IRefCountable *const object = objects[shared ? 0 : threadIndex].get();
+                                  object->addRef();
+                                  object->releaseRef();
+                              });
+    for (const auto &object : objects)
+        ASSERT_EQ(1, object->refCount());
+}
+
+/** addRef()/releaseRef() pairs under contention for each policy. */
+BENCHMARK(RefCountable, contention)
+{
+    const int maxThreadCount = std::max(2, std::min(8, (int)std::thread::hardware_concurrency()));
+    for (int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+    {
+        for (const bool shared : {true, false})
+        {
+            benchmarkContention<SeqCstRefCountPolicy>(benchmark, "seq_cst", threadCount, shared);
+            benchmarkContention<RefCountPolicy>(benchmark, "relaxed/acq_rel", threadCount, shared);
+            benchmarkContention<CacheLineAlignedRefCountPolicy>(benchmark, "cacheLineAligned", threadCount, shared);
+        }
+    }
+}
+
 } // namespace nx::sdk::ref_countable_ut
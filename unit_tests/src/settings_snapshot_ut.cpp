@@ -0,0 +1,95 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <map>
+#include <string>
+
+#include <nx/kit/test.h>
+
+#include <nx/sdk/analytics/helpers/engine.h>
+#include <nx/sdk/helpers/settings_snapshot.h>
+#include <nx/sdk/helpers/string_map.h>
+
+namespace nx::sdk::test
+{
+
+TEST(SettingsSnapshot, lookup)
+{
+    const auto empty = SettingsSnapshot::empty();
+    ASSERT_EQ(0, empty->count());
+    ASSERT_FALSE(empty->contains("keyId"));
+    ASSERT_EQ("", empty->value("keyId"));
+
+    const auto snapshot = SettingsSnapshot::make({{"keyId", "k"}, {"bucketName", "b"}, {"empty", ""}});
+    ASSERT_EQ(3, snapshot->count());
+    ASSERT_EQ("bucketName", snapshot->key(0)); //< Sorted by key.
+    ASSERT_EQ("b", snapshot->value(0));
+    ASSERT_EQ("k", snapshot->value("keyId"));
+    ASSERT_TRUE(snapshot->contains("empty"));
+    ASSERT_FALSE(snapshot->contains("secretKey"));
+    ASSERT_EQ("", snapshot->value("secretKey"));
+
+    const std::map<std::string, std::string> expectedMap{{"keyId", "k"}, {"bucketName", "b"}, {"empty", ""}};
+    ASSERT_TRUE(expectedMap == snapshot->toMap());
+}
+
+TEST(SettingsSnapshot, comparison)
+{
+    const SettingsSnapshot::Map map{{"keyId", "k"}, {"secretKey", "s"}};
+    const auto a = SettingsSnapshot::make(map);
+    const auto b = SettingsSnapshot::make(map);
+    ASSERT_TRUE(*a == *a);
+    ASSERT_TRUE(*a == *b);
+    ASSERT_FALSE(*a != *b);
+
+    ASSERT_TRUE(*a != *SettingsSnapshot::make({{"keyId", "k"}, {"secretKey", "x"}}));
+    ASSERT_TRUE(*a != *SettingsSnapshot::make({{"keyId", "k"}, {"secretKeyX", "s"}}));
+    ASSERT_TRUE(*a != *SettingsSnapshot::make({{"keyId", "k"}}));
+    ASSERT_TRUE(*a != *SettingsSnapshot::empty());
+    ASSERT_TRUE(*SettingsSnapshot::make({}) == *SettingsSnapshot::empty());
+}
+
+class SettingsEngine : public analytics::Engine
+{
+  public:
+    SettingsEngine() : analytics::Engine(/*enableOutput*/ false)
+    {
+    }
+
+    using analytics::Engine::settingsSnapshot;
+
+  protected:
+    virtual std::string manifestString() const override
+    {
+        return "{}";
+    }
+
+    virtual void doObtainDeviceAgent(Result<analytics::IDeviceAgent *> *outResult,
+                                     const IDeviceInfo *deviceInfo) override
+    {
+    }
+};
+
+TEST(SettingsSnapshot, engineMergesReceivedSettings)
+{
+    const auto engine = makePtr<SettingsEngine>();
+    const auto all = makePtr<StringMap>();
+    all->setItem("keyId", "k");
+    all->setItem("bucketName", "b");
+    ASSERT_TRUE(engine->setSettings(all.get()).isOk());
+    const auto first = engine->settingsSnapshot();
+    ASSERT_EQ(2, first->count());
+
+    // the keys the Server omits keep their values
+    const auto some = makePtr<StringMap>();
+    some->setItem("keyId", "k2");
+    ASSERT_TRUE(engine->setSettings(some.get()).isOk());
+    const auto second = engine->settingsSnapshot();
+    ASSERT_EQ(2, second->count());
+    ASSERT_EQ("k2", second->value("keyId"));
+    ASSERT_EQ("b", second->value("bucketName"));
+
+    // the previous snapshot is not changed
+    ASSERT_EQ("k", first->value("keyId"));
+}
+
+} // namespace nx::sdk::test
@@ -0,0 +1,98 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <iterator>
+#include <map>
+#include <string>
+
+#include <nx/kit/test.h>
+
+#include <nx/sdk/helpers/string_map.h>
+#include <nx/sdk/ptr.h>
+
+namespace nx::sdk::test
+{
+
+TEST(StringMap, basics)
+{
+    const auto stringMap = makePtr<StringMap>();
+    ASSERT_EQ(0, stringMap->count());
+    ASSERT_EQ(nullptr, stringMap->key(0));
+    ASSERT_EQ(nullptr, stringMap->value(0));
+    ASSERT_EQ(nullptr, stringMap->value("missing"));
+    ASSERT_EQ(nullptr, stringMap->value(nullptr));
+
+    // Items are kept sorted by key regardless of the insertion order.
+    stringMap->setItem("b", "2");
+    stringMap->setItem("c", "3");
+    stringMap->setItem("a", "1");
+    ASSERT_EQ(3, stringMap->count());
+    ASSERT_STREQ("a", stringMap->key(0));
+    ASSERT_STREQ("1", stringMap->value(0));
+    ASSERT_STREQ("b", stringMap->key(1));
+    ASSERT_STREQ("c", stringMap->key(2));
+    ASSERT_STREQ("3", stringMap->value(2));
+    ASSERT_EQ(nullptr, stringMap->key(3));
+    ASSERT_EQ(nullptr, stringMap->key(-1));
+
+    // Setting an existing key replaces the value.
+    stringMap->setItem("b", "22");
+    ASSERT_EQ(3, stringMap->count());
+    ASSERT_STREQ("22", stringMap->value("b"));
+    ASSERT_EQ(nullptr, stringMap->value("bb"));
+
+    stringMap->clear();
+    ASSERT_EQ(0, stringMap->count());
+}
+
+TEST(StringMap, fromStdMap)
+{
+    const StringMap::Map map{{"secretKey", "s"}, {"bucketName", "b"}, {"endpointUrl", "e"}, {"keyId", "k"}};
+    const auto stringMap = makePtr<StringMap>(map);
+    ASSERT_EQ((int)map.size(), stringMap->count());
+
+    int i = 0;
+    for (const auto &item : map)
+    {
+        ASSERT_STREQ(item.first, stringMap->key(i));
+        ASSERT_STREQ(item.second, stringMap->value(i));
+        ASSERT_STREQ(item.second, stringMap->value(item.first.c_str()));
+        ++i;
+    }
+}
+
+/** The previous StringMap implementation: std::map with std::advance() for index access. */
+static const char *treeMapValue(const StringMap::Map &map, int i)
+{
+    auto position = map.cbegin();
+    std::advance(position, i);
+    return position->second.c_str();
+}
+
+/** Walking a map by index, as LogUtils does. */
+BENCHMARK(StringMap, indexAccess)
+{
+    for (const int itemCount : {10, 100, 1000})
+    {
+        StringMap::Map map;
+        for (int i = 0; i < itemCount; ++i)
+            map["setting" + std::to_string(i)] = "value" + std::to_string(i);
+        const auto stringMap = makePtr<StringMap>(map);
+
+        size_t checksum = 0;
+        benchmark.run("std::map/" + std::to_string(itemCount),
+                      [&]()
+                      {
+                          for (int i = 0; i < itemCount; ++i)
+                              checksum += treeMapValue(map, i)[0];
+                      });
+        benchmark.run("StringMap/" + std::to_string(itemCount),
+                      [&]()
+                      {
+                          for (int i = 0; i < itemCount; ++i)
+                              checksum += stringMap->value(i)[0];
+                      });
+        ASSERT_TRUE(checksum > 0);
+    }
+}
+
+} // namespace nx::sdk::test
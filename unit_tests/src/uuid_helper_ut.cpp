@@ -3,6 +3,7 @@
 #include <nx/kit/test.h>
 
 #include <cctype>
+#include <cstdint>
 #include <map>
 #include <sstream>
 #include <string>
@@ -10,6 +11,8 @@
 
 #include <nx/sdk/helpers/uuid_helper.h>
 
+#include "heap_allocation_counter.h"
+
 namespace nx
 {
 namespace sdk
@@ -105,6 +108,41 @@ TEST(UuidHelper, toStdString)
     ASSERT_STREQ(fixedUuidWithoutFormatOptions, UuidHelper::toStdString(kFixedUuid, UuidHelper::FormatOptions::none));
 }
 
+TEST(UuidHelper, toChars)
+{
+    using FormatOptions = UuidHelper::FormatOptions;
+
+    char buffer[UuidHelper::kMaxStringLength + 1];
+    ASSERT_EQ(UuidHelper::kMaxStringLength, UuidHelper::toChars(kFixedUuid, buffer));
+    ASSERT_STREQ(kFixedUuidString, std::string(buffer));
+
+    const std::map<int, std::string> expectedStrings{
+        {FormatOptions::none, "d4bb55a4a87a4199bbd18000a480a5ad"},
+        {FormatOptions::uppercase, "D4BB55A4A87A4199BBD18000A480A5AD"},
+        {FormatOptions::hyphens, "d4bb55a4-a87a-4199-bbd1-8000a480a5ad"},
+        {FormatOptions::braces, "{d4bb55a4a87a4199bbd18000a480a5ad}"},
+        {FormatOptions::hyphens | FormatOptions::braces, "{d4bb55a4-a87a-4199-bbd1-8000a480a5ad}"},
+    };
+    for (const auto &entry : expectedStrings)
+    {
+        const auto formatOptions = (FormatOptions)entry.first;
+        ASSERT_EQ((int)entry.second.size(), UuidHelper::toChars(kFixedUuid, buffer, formatOptions));
+        ASSERT_STREQ(entry.second, std::string(buffer));
+        ASSERT_STREQ(entry.second, UuidHelper::toStdString(kFixedUuid, formatOptions));
+        ASSERT_EQ(kFixedUuid, UuidHelper::fromStdString(entry.second));
+    }
+
+    // Every nibble value in both positions of a byte.
+    for (int i = 0; i < 256; i += 17)
+    {
+        Uuid uuid;
+        for (int j = 0; j < Uuid::size(); ++j)
+            uuid[j] = (uint8_t)(i + j);
+        ASSERT_EQ(uuid, UuidHelper::fromStdString(UuidHelper::toStdString(uuid)));
+        ASSERT_EQ(uuid, UuidHelper::fromStdString(UuidHelper::toStdString(uuid, FormatOptions::none)));
+    }
+}
+
 TEST(UuidHelper, fromRawData)
 {
     const Uuid uuidFromRawData = UuidHelper::fromRawData(kFixedUuidBytes);
@@ -133,9 +171,16 @@ TEST(UuidHelper, fromStdString)
          {0xd3, 0xbb, 0x55, 0xa4, 0xa8, 0x7a, 0x41, 0x99, 0xbb, 0xd1, 0x80, 0x00, 0xa4, 0x80, 0xa5, 0xad}},
     };
 
-    const std::vector<std::string> badUuidStrings{"{asdadsjhgjhg", "C9560F62-EC0D-45E9-B2A5-190A9F76B778adadae",
+    const std::vector<std::string> badUuidStrings{"{asdadsjhgjhg",
+                                                  "C9560F62-EC0D-45E9-B2A5-190A9F76B778adadae",
                                                   "D7BFE5822B844E26AAAA40DA5CA5R097",
-                                                  "<1be1f39b-96a6-481a-aa63-b4886314ad65>"};
+                                                  "<1be1f39b-96a6-481a-aa63-b4886314ad65>",
+                                                  "1be1f39b-96a6-481a-aa63-b4886314ad6g",
+                                                  "{1be1f39b-96a6-481a-aa63-b4886314ad6/}",
+                                                  "1be1f39b+96a6-481a-aa63-b4886314ad65",
+                                                  "1be1f39b-96a6-481a-aa63-b4886314ad6",
+                                                  "4b47b06f76fd4f76b58df88a303de63:",
+                                                  "4b47b06f76fd4f76b58df88a303de63\xC1"};
 
     for (const auto &entry : goodUuids)
         ASSERT_EQ(UuidHelper::fromStdString(entry.first), entry.second);
@@ -144,6 +189,49 @@ TEST(UuidHelper, fromStdString)
         ASSERT_EQ(UuidHelper::fromStdString(uuidString), kNullUuid);
 }
 
+TEST(UuidHelper, conversionsDoNotAllocate)
+{
+    const std::string fixedUuidString = kFixedUuidString;
+    const int64_t allocationsBefore = g_heapAllocationCount.load();
+
+    ASSERT_EQ(kFixedUuid, UuidHelper::fromStdString(fixedUuidString));
+    char buffer[UuidHelper::kMaxStringLength + 1];
+    UuidHelper::toChars(kFixedUuid, buffer);
+
+    ASSERT_EQ(0, g_heapAllocationCount.load() - allocationsBefore);
+}
+
+BENCHMARK(UuidHelper, parse)
+{
+    const std::string canonical = kFixedUuidString;
+    const std::string withoutBraces = UuidHelper::toStdString(kFixedUuid, UuidHelper::FormatOptions::hyphens);
+    const std::string tolerant = "   {D4BB55A4-A87A-4199-BBD1-8000A4  80A5AD}   ";
+
+    benchmark.run("canonical", [&]() { nx::kit::test::doNotOptimize(UuidHelper::fromStdString(canonical)); });
+    benchmark.run("withoutBraces",
+                  [&]() { nx::kit::test::doNotOptimize(UuidHelper::fromStdString(withoutBraces)); });
+    benchmark.run("tolerant", [&]() { nx::kit::test::doNotOptimize(UuidHelper::fromStdString(tolerant)); });
+}
+
+BENCHMARK(UuidHelper, format)
+{
+    Uuid uuid = kFixedUuid;
+    char buffer[UuidHelper::kMaxStringLength + 1];
+    benchmark.run("toChars",
+                  [&]()
+                  {
+                      ++uuid[0];
+                      UuidHelper::toChars(uuid, buffer);
+                      nx::kit::test::doNotOptimize(buffer);
+                  });
+    benchmark.run("toStdString",
+                  [&]()
+                  {
+                      ++uuid[0];
+                      nx::kit::test::doNotOptimize(UuidHelper::toStdString(uuid));
+                  });
+}
+
 } // namespace test
 } // namespace sdk
 } // namespace nx